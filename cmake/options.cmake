@@ -7,6 +7,8 @@ option(BUILD_LOGIN_SERVER   "Build login server"                    ON)
 option(BUILD_EXTRACTORS     "Build map/dbc/vmap/mmap extractors"    OFF)
 option(BUILD_SCRIPTDEV      "Build ScriptDev. (OFF Speedup build)"  ON)
 option(BUILD_PLAYERBOT      "Build Playerbot mod"                   OFF)
+option(BUILD_BENCHMARKS     "Build benchmark tools"                 OFF)
+option(BUILD_PROFILER       "Build tick profiler zones"             OFF)
 
 # TODO: options that should be checked/created:
 #option(CLI                  "With CLI"                              ON)
@@ -29,6 +31,9 @@ message(STATUS
     BUILD_EXTRACTORS        Build map/dbc/vmap/mmap extractor
     BUILD_SCRIPTDEV         Build scriptdev. (Disable it to speedup build in dev mode by not including scripts)
     BUILD_PLAYERBOT         Build Playerbot mod
+    BUILD_BENCHMARKS        Build benchmark tools (core data structures against previous implementations,
+                            world_bench load generator with BUILD_PLAYERBOT)
+    BUILD_PROFILER          Build tick profiler zones (enabled by Profiler.Enable in mangosd.conf)
 
   To set an option simply type -D<OPTION>=<VALUE> after 'cmake <srcs>'.
   Also, you can specify the generator with -G. see 'cmake --help' for more details
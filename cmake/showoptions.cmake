@@ -61,6 +61,18 @@ else()
   message(STATUS "Build extractors      : No  (default)")
 endif()
 
+if(BUILD_BENCHMARKS)
+  message(STATUS "Build benchmarks      : Yes")
+else()
+  message(STATUS "Build benchmarks      : No  (default)")
+endif()
+
+if(BUILD_PROFILER)
+  message(STATUS "Build profiler        : Yes")
+else()
+  message(STATUS "Build profiler        : No  (default)")
+endif()
+
 # if(SQL)
 #   message(STATUS "Install SQL-files     : Yes")
 # else()
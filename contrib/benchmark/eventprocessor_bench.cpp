@@ -0,0 +1,119 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compares EventProcessor against the previous multimap based implementation
+// with an event mix similar to units: short spell delays, relocation notifies and long timers.
+
+#include "Utilities/EventProcessor.h"
+#include "eventprocessor_legacy.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct BenchState
+{
+    explicit BenchState(uint32 seed) : rng(seed), executed(0), checksum(0) {}
+
+    uint32 NextDelay()
+    {
+        uint32 kind = rng() % 100;
+        if (kind < 60)
+            return 1 + rng() % 100;                         // spell hits and short delays
+        if (kind < 95)
+            return 100 + rng() % 900;                       // relocation notifies, ai delays
+        return 20000 + rng() % 60000;                       // battleground invites, despawns
+    }
+
+    std::mt19937 rng;
+    uint64 executed;
+    uint64 checksum;
+};
+
+// every executed event schedules one new event, so event count stays constant
+template<class Base, class Processor>
+class BenchEvent : public Base
+{
+    public:
+        BenchEvent(Processor& processor, BenchState& state, uint32 id) : m_processor(processor), m_state(state), m_id(id) {}
+
+        bool Execute(uint64 e_time, uint32 /*p_time*/) override
+        {
+            ++m_state.executed;
+            m_state.checksum = m_state.checksum * 31 + m_id + e_time;
+            m_processor.AddEvent(new BenchEvent(m_processor, m_state, m_id), m_processor.CalculateTime(m_state.NextDelay()));
+            return true;
+        }
+
+    private:
+        Processor& m_processor;
+        BenchState& m_state;
+        uint32 m_id;
+};
+
+template<class Base, class Processor>
+double RunBench(uint32 processors, uint32 eventsPerProcessor, uint32 ticks, uint32 diff, BenchState& state)
+{
+    std::vector<Processor*> list(processors);
+    for (uint32 i = 0; i < processors; ++i)
+    {
+        list[i] = new Processor;
+        for (uint32 j = 0; j < eventsPerProcessor; ++j)
+            list[i]->AddEvent(new BenchEvent<Base, Processor>(*list[i], state, i * eventsPerProcessor + j), list[i]->CalculateTime(state.NextDelay()));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32 tick = 0; tick < ticks; ++tick)
+        for (uint32 i = 0; i < processors; ++i)
+            list[i]->Update(diff);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (uint32 i = 0; i < processors; ++i)
+        delete list[i];
+
+    return elapsed;
+}
+
+int main(int argc, char** argv)
+{
+    uint32 processors = argc > 1 ? atoi(argv[1]) : 20000;
+    uint32 eventsPerProcessor = argc > 2 ? atoi(argv[2]) : 4;
+    uint32 ticks = argc > 3 ? atoi(argv[3]) : 2000;
+    uint32 diff = argc > 4 ? atoi(argv[4]) : 50;
+
+    printf("EventProcessor benchmark: %u processors, %u events each, %u ticks of %u ms\n", processors, eventsPerProcessor, ticks, diff);
+
+    BenchState legacyState(12345);
+    double legacyTime = RunBench<Legacy::BasicEvent, Legacy::EventProcessor>(processors, eventsPerProcessor, ticks, diff, legacyState);
+    printf("multimap:    %8.3f s, %llu events executed, %.1f M events/s\n", legacyTime, (unsigned long long)legacyState.executed, legacyState.executed / legacyTime / 1e6);
+
+    BenchState wheelState(12345);
+    double wheelTime = RunBench<BasicEvent, EventProcessor>(processors, eventsPerProcessor, ticks, diff, wheelState);
+    printf("timer wheel: %8.3f s, %llu events executed, %.1f M events/s\n", wheelTime, (unsigned long long)wheelState.executed, wheelState.executed / wheelTime / 1e6);
+
+    if (legacyState.executed != wheelState.executed || legacyState.checksum != wheelState.checksum)
+    {
+        printf("ERROR: execution order differs from multimap implementation\n");
+        return 1;
+    }
+
+    printf("speedup: %.2fx\n", legacyTime / wheelTime);
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "eventprocessor_legacy.h"
+
+namespace Legacy
+{
+    EventProcessor::EventProcessor() : m_time(0)
+    {
+    }
+
+    EventProcessor::~EventProcessor()
+    {
+        KillAllEvents(true);
+    }
+
+    void EventProcessor::Update(uint32 p_time)
+    {
+        m_time += p_time;
+
+        EventList::iterator i;
+        while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+        {
+            BasicEvent* Event = i->second;
+            m_events.erase(i);
+
+            if (!Event->to_Abort)
+            {
+                if (Event->Execute(m_time, p_time))
+                    delete Event;
+            }
+            else
+            {
+                Event->Abort(m_time);
+                delete Event;
+            }
+        }
+    }
+
+    void EventProcessor::KillAllEvents(bool force)
+    {
+        for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+        {
+            EventList::iterator i_old = i;
+            ++i;
+
+            i_old->second->to_Abort = true;
+            i_old->second->Abort(m_time);
+            if (force || i_old->second->IsDeletable())
+            {
+                delete i_old->second;
+                if (!force)
+                    m_events.erase(i_old);
+            }
+        }
+
+        if (force)
+            m_events.clear();
+    }
+
+    void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
+    {
+        if (set_addtime)
+            Event->m_addTime = m_time;
+        Event->m_execTime = e_time;
+        m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    }
+
+    uint64 EventProcessor::CalculateTime(uint64 t_offset) const
+    {
+        return m_time + t_offset;
+    }
+}
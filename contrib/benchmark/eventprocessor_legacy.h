@@ -0,0 +1,63 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LEGACY_EVENTPROCESSOR_H
+#define MANGOS_LEGACY_EVENTPROCESSOR_H
+
+#include "Platform/Define.h"
+
+#include <map>
+
+// EventProcessor before timer wheel, kept for comparison
+namespace Legacy
+{
+    class BasicEvent
+    {
+        public:
+            BasicEvent() : to_Abort(false), m_addTime(0), m_execTime(0) {}
+            virtual ~BasicEvent() {}
+
+            virtual bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) { return true; }
+            virtual bool IsDeletable() const { return true; }
+            virtual void Abort(uint64 /*e_time*/) {}
+
+            bool to_Abort;
+            uint64 m_addTime;
+            uint64 m_execTime;
+    };
+
+    typedef std::multimap<uint64, BasicEvent*> EventList;
+
+    class EventProcessor
+    {
+        public:
+            EventProcessor();
+            ~EventProcessor();
+
+            void Update(uint32 p_time);
+            void KillAllEvents(bool force);
+            void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
+            uint64 CalculateTime(uint64 t_offset) const;
+
+        private:
+            uint64 m_time;
+            EventList m_events;
+    };
+}
+
+#endif
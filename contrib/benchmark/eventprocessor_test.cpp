@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Checks EventProcessor execution ticks against the previous multimap based implementation
+// in both list mode (few events) and timer wheel mode.
+
+#include "Utilities/EventProcessor.h"
+#include "eventprocessor_legacy.h"
+
+#include <cstdio>
+#include <vector>
+
+// records tick of execution, first executions re-add themselves with given delay from inside Execute
+template<class Base, class Processor>
+class TestEvent : public Base
+{
+    public:
+        TestEvent(Processor& processor, std::vector<uint32>& ticks, uint32 const& tick, uint32 readds, uint32 delay) :
+            m_processor(processor), m_ticks(ticks), m_tick(tick), m_readds(readds), m_delay(delay) {}
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            m_ticks.push_back(m_tick);
+            if (m_readds)
+                m_processor.AddEvent(new TestEvent(m_processor, m_ticks, m_tick, m_readds - 1, m_delay), m_processor.CalculateTime(m_delay));
+            return true;
+        }
+
+    private:
+        Processor& m_processor;
+        std::vector<uint32>& m_ticks;
+        uint32 const& m_tick;
+        uint32 m_readds;
+        uint32 m_delay;
+};
+
+template<class Base, class Processor>
+std::vector<uint32> RunCase(uint32 idleEvents, uint32 delay, uint32 readds)
+{
+    std::vector<uint32> ticks;
+    uint32 tick = 0;
+
+    Processor processor;
+    // long timers only select list or wheel mode
+    for (uint32 i = 0; i < idleEvents; ++i)
+        processor.AddEvent(new Base, processor.CalculateTime(1000000 + i));
+
+    processor.AddEvent(new TestEvent<Base, Processor>(processor, ticks, tick, readds, delay), processor.CalculateTime(10));
+
+    for (tick = 1; tick <= 10; ++tick)
+        processor.Update(50);
+
+    return ticks;
+}
+
+static bool CheckCase(char const* name, uint32 idleEvents, uint32 delay, uint32 readds)
+{
+    std::vector<uint32> legacy = RunCase<Legacy::BasicEvent, Legacy::EventProcessor>(idleEvents, delay, readds);
+    std::vector<uint32> current = RunCase<BasicEvent, EventProcessor>(idleEvents, delay, readds);
+
+    bool ok = legacy == current;
+    printf("%-40s %s (%u executions)\n", name, ok ? "ok" : "FAILED", uint32(current.size()));
+    if (!ok)
+    {
+        for (uint32 i = 0; i < legacy.size() || i < current.size(); ++i)
+            printf("  execution %u: multimap tick %d, current tick %d\n", i, i < legacy.size() ? int(legacy[i]) : -1, i < current.size() ? int(current[i]) : -1);
+    }
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+    ok &= CheckCase("list mode, zero delay from Execute", 3, 0, 3);
+    ok &= CheckCase("list mode, short delay from Execute", 3, 20, 5);
+    ok &= CheckCase("wheel mode, zero delay from Execute", 40, 0, 3);
+    ok &= CheckCase("wheel mode, short delay from Execute", 40, 20, 5);
+    return ok ? 0 : 1;
+}
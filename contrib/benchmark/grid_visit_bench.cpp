@@ -0,0 +1,165 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compares range search over cell objects through intrusive list and through dense hot data
+// on synthetic densely populated map, objects are big and allocated in random order like real ones.
+
+#include <cassert>
+#include <iterator>
+
+#include "GameSystem/GridRefManager.h"
+#include "GameSystem/GridReference.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+class BenchObject
+{
+    public:
+        BenchObject(uint64 guid, float x, float y, float z) : m_guid(guid), m_x(x), m_y(y), m_z(z) {}
+
+        float GetPositionX() const { return m_x; }
+        float GetPositionY() const { return m_y; }
+
+        void Relocate(float x, float y, float z)
+        {
+            m_x = x;
+            m_y = y;
+            m_z = z;
+            m_gridRef.UpdateHotPosition(x, y, z);
+        }
+
+        static bool const HasGridHotData = true;
+        void GetGridHotData(GridObjectHotData& data) const
+        {
+            data.x = m_x;
+            data.y = m_y;
+            data.z = m_z;
+            data.typeMask = 0;
+            data.guid = m_guid;
+        }
+
+        GridReference<BenchObject>& GetGridRef() { return m_gridRef; }
+
+    private:
+        uint64 m_guid;
+        char m_otherFields[1500];                           // rest of creature fields
+        float m_x, m_y, m_z;
+        GridReference<BenchObject> m_gridRef;
+};
+
+#define BENCH_CELL_SIZE 33.3f
+
+int main(int argc, char** argv)
+{
+    uint32 cells = argc > 1 ? atoi(argv[1]) : 256;
+    uint32 objectsPerCell = argc > 2 ? atoi(argv[2]) : 64;
+    uint32 searches = argc > 3 ? atoi(argv[3]) : 200000;
+    float radius = argc > 4 ? float(atof(argv[4])) : 10.0f;
+
+    printf("Grid visit benchmark: %u cells, %u objects each, %u searches of %.1f yards\n", cells, objectsPerCell, searches, radius);
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> cellPos(0.0f, BENCH_CELL_SIZE);
+
+    // allocate all objects first and link them in random order, so list neighbours are far in memory
+    uint32 total = cells * objectsPerCell;
+    std::vector<BenchObject*> objects(total);
+    for (uint32 i = 0; i < total; ++i)
+        objects[i] = new BenchObject(i + 1, cellPos(rng), cellPos(rng), 0.0f);
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    std::vector<GridRefManager<BenchObject> > grid(cells);
+    for (uint32 i = 0; i < total; ++i)
+        objects[i]->GetGridRef().link(&grid[i % cells], objects[i]);
+
+    std::vector<uint32> searchCells(searches);
+    std::vector<float> searchX(searches), searchY(searches);
+    for (uint32 i = 0; i < searches; ++i)
+    {
+        searchCells[i] = rng() % cells;
+        searchX[i] = cellPos(rng);
+        searchY[i] = cellPos(rng);
+    }
+
+    float radiusSq = radius * radius;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64 listFound = 0;
+    for (uint32 i = 0; i < searches; ++i)
+    {
+        GridRefManager<BenchObject>& cell = grid[searchCells[i]];
+        for (GridRefManager<BenchObject>::iterator itr = cell.begin(); itr != cell.end(); ++itr)
+        {
+            BenchObject* obj = itr->getSource();
+            float dx = obj->GetPositionX() - searchX[i];
+            float dy = obj->GetPositionY() - searchY[i];
+            if (dx * dx + dy * dy <= radiusSq)
+                ++listFound;
+        }
+    }
+    double listTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    uint64 denseFound = 0;
+    for (uint32 i = 0; i < searches; ++i)
+    {
+        GridRefManager<BenchObject>& cell = grid[searchCells[i]];
+        uint32 count = cell.GetDenseSize();
+        GridObjectHotData const* hotData = cell.GetDenseHotData();
+        for (uint32 j = 0; j < count; ++j)
+        {
+            float dx = hotData[j].x - searchX[i];
+            float dy = hotData[j].y - searchY[i];
+            if (dx * dx + dy * dy <= radiusSq)
+                ++denseFound;
+        }
+    }
+    double denseTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // moving objects between cells pays for dense array maintenance
+    start = std::chrono::steady_clock::now();
+    for (uint32 i = 0; i < searches; ++i)
+    {
+        BenchObject* obj = objects[i % total];
+        obj->GetGridRef().link(&grid[searchCells[i]], obj);
+        obj->Relocate(searchX[i], searchY[i], 0.0f);
+    }
+    double moveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double visited = double(searches) * objectsPerCell;
+    printf("list:   %8.3f s, %.1f M objects/s, %llu found\n", listTime, visited / listTime / 1e6, (unsigned long long)listFound);
+    printf("dense:  %8.3f s, %.1f M objects/s, %llu found\n", denseTime, visited / denseTime / 1e6, (unsigned long long)denseFound);
+    printf("cell change and relocate: %.1f ns per object\n", moveTime / searches * 1e9);
+
+    for (uint32 i = 0; i < total; ++i)
+        delete objects[i];
+
+    if (listFound != denseFound)
+    {
+        printf("ERROR: dense search results differ from list search\n");
+        return 1;
+    }
+
+    printf("speedup: %.2fx\n", listTime / denseTime);
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Replays line of sight queries recorded by mangosd with LogLevel 3 and LogFilter_LineOfSight = 0
+// against extracted vmaps, once ray by ray and once batched by origin with packet traversal.
+// Record raid encounters, AoE target selection produces many queries from one origin.
+
+#include "VMapManager2.h"
+#include "VMapDefinitions.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#define BENCH_SIZE_OF_GRIDS 533.33333f
+
+struct LosQuery
+{
+    uint32 mapId;
+    float src[3];
+    float dest[3];
+};
+
+struct LosBatch
+{
+    uint32 first;
+    uint32 count;
+};
+
+static bool LoadQueries(const char* fileName, std::vector<LosQuery>& queries)
+{
+    FILE* file = fopen(fileName, "r");
+    if (!file)
+    {
+        printf("Cannot open %s\n", fileName);
+        return false;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), file))
+    {
+        char const* record = strstr(line, "LOS query: map ");
+        if (!record)
+            continue;
+
+        LosQuery query;
+        if (sscanf(record, "LOS query: map %u %f %f %f %f %f %f", &query.mapId, &query.src[0], &query.src[1], &query.src[2],
+                   &query.dest[0], &query.dest[1], &query.dest[2]) == 7)
+            queries.push_back(query);
+    }
+
+    fclose(file);
+    return true;
+}
+
+// consecutive queries from same point are one batch, like targets of one AoE spell
+static void BuildBatches(std::vector<LosQuery> const& queries, std::vector<LosBatch>& batches)
+{
+    for (uint32 i = 0; i < queries.size(); ++i)
+    {
+        if (!batches.empty())
+        {
+            LosBatch& last = batches.back();
+            LosQuery const& first = queries[last.first];
+            if (last.count < VMAP_MAX_LOS_BATCH && first.mapId == queries[i].mapId && memcmp(first.src, queries[i].src, sizeof(first.src)) == 0)
+            {
+                ++last.count;
+                continue;
+            }
+        }
+
+        LosBatch batch;
+        batch.first = i;
+        batch.count = 1;
+        batches.push_back(batch);
+    }
+}
+
+static void LoadTiles(VMAP::VMapManager2& manager, char const* vmapsDir, std::vector<LosQuery> const& queries)
+{
+    std::set<uint32> loaded;
+    for (LosQuery const& query : queries)
+    {
+        float const* points[2] = { query.src, query.dest };
+        for (float const* point : points)
+        {
+            uint32 gx = uint32(32 - point[0] / BENCH_SIZE_OF_GRIDS);
+            uint32 gy = uint32(32 - point[1] / BENCH_SIZE_OF_GRIDS);
+            if (loaded.insert((query.mapId << 16) | (gx << 8) | gy).second)
+                manager.loadMap(vmapsDir, query.mapId, gx, gy);
+        }
+    }
+    printf("Loaded %u vmap tiles\n", uint32(loaded.size()));
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: %s <vmaps dir> <mangosd log with LOS queries> [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    char const* vmapsDir = argv[1];
+    uint32 iterations = argc > 3 ? atoi(argv[3]) : 20;
+
+    std::vector<LosQuery> queries;
+    if (!LoadQueries(argv[2], queries))
+        return 1;
+    if (queries.empty())
+    {
+        printf("No LOS queries found in %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<LosBatch> batches;
+    BuildBatches(queries, batches);
+    printf("Line of sight benchmark: %u queries in %u batches, %u iterations\n", uint32(queries.size()), uint32(batches.size()), iterations);
+
+    VMAP::VMapManager2 manager;
+    LoadTiles(manager, vmapsDir, queries);
+
+    std::vector<bool> singleResults(queries.size());
+    std::vector<bool> batchResults(queries.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 n = 0; n < iterations; ++n)
+        for (uint32 i = 0; i < queries.size(); ++i)
+        {
+            LosQuery const& query = queries[i];
+            singleResults[i] = manager.isInLineOfSight(query.mapId, query.src[0], query.src[1], query.src[2], query.dest[0], query.dest[1], query.dest[2]);
+        }
+    double singleTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32 n = 0; n < iterations; ++n)
+        for (LosBatch const& batch : batches)
+        {
+            LosQuery const& first = queries[batch.first];
+            float targets[VMAP_MAX_LOS_BATCH * 3];
+            for (uint32 i = 0; i < batch.count; ++i)
+                memcpy(targets + 3 * i, queries[batch.first + i].dest, sizeof(first.dest));
+
+            uint32 mask = manager.getLineOfSightMask(first.mapId, first.src[0], first.src[1], first.src[2], targets, batch.count);
+            for (uint32 i = 0; i < batch.count; ++i)
+                batchResults[batch.first + i] = (mask & (1 << i)) != 0;
+        }
+    double batchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    uint32 mismatches = 0;
+    uint32 blocked = 0;
+    for (uint32 i = 0; i < queries.size(); ++i)
+    {
+        if (singleResults[i] != batchResults[i])
+            ++mismatches;
+        if (!singleResults[i])
+            ++blocked;
+    }
+
+    double total = double(queries.size()) * iterations;
+    printf("  single rays:    %9.2f ms, %7.1f ns per query\n", singleTime, singleTime * 1000000.0 / total);
+    printf("  packet batches: %9.2f ms, %7.1f ns per query (x%.2f)\n", batchTime, batchTime * 1000000.0 / total, batchTime > 0 ? singleTime / batchTime : 0.0);
+    printf("  %u queries blocked, %u results differ\n", blocked, mismatches);
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,576 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Headless load generator: boots the world from databases of mangosd configuration file,
+// logs in playerbots without network layer, plays scripted scenario and measures world ticks.
+//
+// Every account with characters in character database is a bot group: first character of account
+// is logged in as master on headless session, other characters as its bots. Use copy of fixture
+// databases, characters are saved at logout like on live server.
+
+#include "Common.h"
+#include "Config/Config.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "ProgressBar.h"
+#include "SystemConfig.h"
+#include "Timer.h"
+#include "World/World.h"
+#include "Entities/Player.h"
+#include "Globals/ObjectMgr.h"
+#include "Globals/ObjectAccessor.h"
+#include "Maps/GridMap.h"
+#include "MotionGenerators/MotionMaster.h"
+#include "Server/WorldSession.h"
+#include "PlayerBot/Base/PlayerbotMgr.h"
+#include "PlayerBot/Base/PlayerbotScheduler.h"
+#include "revision_sql.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+DatabaseType WorldDatabase;
+DatabaseType CharacterDatabase;
+DatabaseType LoginDatabase;
+
+uint32 realmID;
+
+// ticks to wait for logins and teleports before giving up
+#define BENCH_LOGIN_TICKS       1200
+// ticks between scenario decisions of masters
+#define BENCH_ORDER_TICKS       20
+// bots are placed around master in this radius
+#define BENCH_SPREAD            8.0f
+// default Doom Lord Kazzak, open world raid boss
+#define BENCH_DEFAULT_BOSS      18728
+
+enum BenchScenario
+{
+    BENCH_SCENARIO_CITY,                                    // idle in faction capital
+    BENCH_SCENARIO_BOSS,                                    // all groups fight one world boss
+    BENCH_SCENARIO_PVP,                                     // groups of both factions fight each other
+};
+
+struct BenchGroup
+{
+    uint32 accountId;
+    ObjectGuid masterGuid;
+    std::vector<ObjectGuid> botGuids;
+    WorldSession* session;
+};
+
+struct BenchOptions
+{
+    BenchOptions() : configFile(_MANGOSD_CONFIG), scenario(BENCH_SCENARIO_CITY), bots(40), ticks(2000), warmup(200), diff(50), boss(BENCH_DEFAULT_BOSS) {}
+
+    std::string configFile;
+    BenchScenario scenario;
+    uint32 bots;
+    uint32 ticks;
+    uint32 warmup;
+    uint32 diff;
+    uint32 boss;
+};
+
+static void Usage(char const* prog)
+{
+    printf("Usage: %s [options]\n"
+           "    -c config_file   mangosd configuration with fixture databases\n"
+           "    -s scenario      city, boss or pvp (default city)\n"
+           "    -n bots          number of bots (default 40)\n"
+           "    -t ticks         measured ticks (default 2000)\n"
+           "    -w ticks         warmup ticks after scenario setup (default 200)\n"
+           "    -d ms            tick length (default 50)\n"
+           "    -e entry         boss creature entry for boss scenario (default %u)\n", prog, BENCH_DEFAULT_BOSS);
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc || argv[i][0] != '-')
+            return false;
+
+        char const* value = argv[++i];
+        switch (argv[i - 1][1])
+        {
+            case 'c': options.configFile = value; break;
+            case 'n': options.bots = atoi(value); break;
+            case 't': options.ticks = atoi(value); break;
+            case 'w': options.warmup = atoi(value); break;
+            case 'd': options.diff = std::max(1, atoi(value)); break;
+            case 'e': options.boss = atoi(value); break;
+            case 's':
+                if (!strcmp(value, "city"))
+                    options.scenario = BENCH_SCENARIO_CITY;
+                else if (!strcmp(value, "boss"))
+                    options.scenario = BENCH_SCENARIO_BOSS;
+                else if (!strcmp(value, "pvp"))
+                    options.scenario = BENCH_SCENARIO_PVP;
+                else
+                    return false;
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool StartDatabase(DatabaseType& db, char const* infoName, char const* connectionsName, char const* versionTable, char const* version)
+{
+    std::string dbstring = sConfig.GetStringDefault(infoName);
+    if (dbstring.empty())
+    {
+        sLog.outError("%s not specified in configuration file", infoName);
+        return false;
+    }
+
+    if (!db.Initialize(dbstring.c_str(), sConfig.GetIntDefault(connectionsName, 1)))
+    {
+        sLog.outError("Cannot connect to database %s", dbstring.c_str());
+        return false;
+    }
+
+    return db.CheckRequiredField(versionTable, version);
+}
+
+static void StopDatabases()
+{
+    CharacterDatabase.HaltDelayThread();
+    WorldDatabase.HaltDelayThread();
+    LoginDatabase.HaltDelayThread();
+}
+
+// runs one world tick as WorldRunnable does and returns its duration in microseconds
+static uint32 RunTick(uint32 tickLength)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ++World::m_worldLoopCounter;
+    sWorld.Update(WorldTimer::tick());
+
+    uint32 elapsed = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    if (elapsed < tickLength * 1000)
+        std::this_thread::sleep_for(std::chrono::microseconds(tickLength * 1000 - elapsed));
+
+    return elapsed;
+}
+
+// headless masters have nobody to confirm teleports
+static void AckTeleport(Player* master)
+{
+    if (master->IsBeingTeleportedNear())
+    {
+        WorldPacket data(MSG_MOVE_TELEPORT_ACK, 8 + 4 + 4);
+        data << master->GetObjectGuid();
+        data << uint32(0);
+        data << uint32(time(nullptr));
+        master->GetSession()->HandleMoveTeleportAckOpcode(data);
+    }
+    else if (master->IsBeingTeleportedFar())
+        master->GetSession()->HandleMoveWorldportAckOpcode();
+}
+
+static bool LoadGroups(uint32 bots, std::vector<BenchGroup>& groups)
+{
+    QueryResult* result = CharacterDatabase.Query("SELECT guid, account FROM characters ORDER BY account, guid");
+    if (!result)
+        return false;
+
+    uint32 added = 0;
+    do
+    {
+        Field* fields = result->Fetch();
+        ObjectGuid guid(HIGHGUID_PLAYER, fields[0].GetUInt32());
+        uint32 accountId = fields[1].GetUInt32();
+
+        if (groups.empty() || groups.back().accountId != accountId)
+        {
+            if (added >= bots)
+                break;
+
+            BenchGroup group;
+            group.accountId = accountId;
+            group.masterGuid = guid;
+            group.session = nullptr;
+            groups.push_back(group);
+        }
+        else if (added < bots)
+        {
+            groups.back().botGuids.push_back(guid);
+            ++added;
+        }
+    }
+    while (result->NextRow());
+
+    delete result;
+    return !groups.empty();
+}
+
+static bool WaitFor(bool (*done)(std::vector<BenchGroup> const&), std::vector<BenchGroup> const& groups, uint32 tickLength)
+{
+    for (uint32 i = 0; i < BENCH_LOGIN_TICKS; ++i)
+    {
+        for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+            if (Player* master = sObjectMgr.GetPlayer(itr->masterGuid))
+                AckTeleport(master);
+
+        if (done(groups))
+            return true;
+        RunTick(tickLength);
+    }
+    return false;
+}
+
+static bool MastersInWorld(std::vector<BenchGroup> const& groups)
+{
+    for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        Player* master = sObjectMgr.GetPlayer(itr->masterGuid);
+        if (!master || !master->IsInWorld())
+            return false;
+    }
+    return true;
+}
+
+static bool BotsInWorld(std::vector<BenchGroup> const& groups)
+{
+    for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        for (std::vector<ObjectGuid>::const_iterator bItr = itr->botGuids.begin(); bItr != itr->botGuids.end(); ++bItr)
+        {
+            Player* bot = sObjectMgr.GetPlayer(*bItr);
+            if (!bot || !bot->IsInWorld() || bot->IsBeingTeleported())
+                return false;
+        }
+    }
+    return MastersInWorld(groups);
+}
+
+static bool LoginGroups(std::vector<BenchGroup>& groups, uint32 tickLength)
+{
+    for (std::vector<BenchGroup>::iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        itr->session = new WorldSession(itr->accountId, nullptr, SEC_PLAYER, sWorld.getConfig(CONFIG_UINT32_EXPANSION), 0, LOCALE_enUS);
+        itr->session->SetHeadless();
+        sWorld.AddSession(itr->session);
+    }
+
+    // sessions are added to world at next session update
+    RunTick(tickLength);
+
+    for (std::vector<BenchGroup>::iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        WorldPacket data(CMSG_PLAYER_LOGIN, 8);
+        data << itr->masterGuid;
+        itr->session->HandlePlayerLoginOpcode(data);
+    }
+
+    if (!WaitFor(MastersInWorld, groups, tickLength))
+    {
+        sLog.outError("Masters were not logged in, check player limit of configuration");
+        return false;
+    }
+
+    for (std::vector<BenchGroup>::iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        Player* master = sObjectMgr.GetPlayer(itr->masterGuid);
+        if (!master->GetPlayerbotMgr())
+            master->SetPlayerbotMgr(new PlayerbotMgr(master));
+
+        for (std::vector<ObjectGuid>::const_iterator bItr = itr->botGuids.begin(); bItr != itr->botGuids.end(); ++bItr)
+            master->GetPlayerbotMgr()->LoginPlayerBot(*bItr);
+    }
+
+    if (!WaitFor(BotsInWorld, groups, tickLength))
+    {
+        sLog.outError("Bots were not logged in");
+        return false;
+    }
+    return true;
+}
+
+static void LogoutGroups(std::vector<BenchGroup>& groups, uint32 tickLength)
+{
+    for (std::vector<BenchGroup>::iterator itr = groups.begin(); itr != groups.end(); ++itr)
+        if (itr->session->GetPlayer())
+            itr->session->LogoutPlayer(true);           // logs out bots too
+
+    RunTick(tickLength);
+}
+
+static void PlaceGroup(BenchGroup const& group, uint32 mapId, float x, float y)
+{
+    TerrainInfo* terrain = sTerrainMgr.LoadTerrain(mapId);
+
+    Player* master = sObjectMgr.GetPlayer(group.masterGuid);
+    master->TeleportTo(mapId, x, y, terrain->GetHeightStatic(x, y, MAX_HEIGHT), 0.0f);
+
+    for (uint32 i = 0; i < group.botGuids.size(); ++i)
+    {
+        float angle = 2 * M_PI_F * i / group.botGuids.size();
+        float botX = x + BENCH_SPREAD * cos(angle);
+        float botY = y + BENCH_SPREAD * sin(angle);
+        if (Player* bot = sObjectMgr.GetPlayer(group.botGuids[i]))
+            bot->TeleportTo(mapId, botX, botY, terrain->GetHeightStatic(botX, botY, MAX_HEIGHT), angle);
+    }
+}
+
+struct BenchBossSpawnFinder
+{
+    explicit BenchBossSpawnFinder(uint32 entry) : i_entry(entry), i_guid(0), i_data(nullptr) {}
+
+    bool operator()(CreatureDataPair const& dataPair)
+    {
+        if (dataPair.second.id != i_entry)
+            return false;
+
+        i_guid = dataPair.first;
+        i_data = &dataPair.second;
+        return true;
+    }
+
+    uint32 i_entry;
+    uint32 i_guid;
+    CreatureData const* i_data;
+};
+
+static bool SetupScenario(BenchOptions const& options, std::vector<BenchGroup> const& groups, ObjectGuid& bossGuid)
+{
+    for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        Player* master = sObjectMgr.GetPlayer(itr->masterGuid);
+        uint32 index = uint32(itr - groups.begin());
+
+        switch (options.scenario)
+        {
+            case BENCH_SCENARIO_CITY:
+                // Stormwind trade district and Orgrimmar Valley of Strength
+                if (master->GetTeam() == ALLIANCE)
+                    PlaceGroup(*itr, 0, -8833.38f + (index % 8) * 10.0f, 628.63f + (index / 8) * 10.0f);
+                else
+                    PlaceGroup(*itr, 1, 1629.36f + (index % 8) * 10.0f, -4373.39f + (index / 8) * 10.0f);
+                break;
+            case BENCH_SCENARIO_BOSS:
+            {
+                BenchBossSpawnFinder finder(options.boss);
+                sObjectMgr.DoCreatureData(finder);
+                if (!finder.i_data)
+                {
+                    sLog.outError("No spawn of creature %u for boss scenario", options.boss);
+                    return false;
+                }
+
+                float angle = 2 * M_PI_F * index / groups.size();
+                PlaceGroup(*itr, finder.i_data->mapid, finder.i_data->posX + 30.0f * cos(angle), finder.i_data->posY + 30.0f * sin(angle));
+                bossGuid = ObjectGuid(HIGHGUID_UNIT, options.boss, finder.i_guid);
+                break;
+            }
+            case BENCH_SCENARIO_PVP:
+                // Hillsbrad Foothills between Southshore and Tarren Mill, factions face each other
+                PlaceGroup(*itr, 0, master->GetTeam() == ALLIANCE ? -470.0f : -430.0f, -700.0f + (index / 2) * 10.0f);
+                break;
+        }
+    }
+    return true;
+}
+
+static Unit* SelectTarget(BenchOptions const& options, Player* master, std::vector<BenchGroup> const& groups, ObjectGuid bossGuid)
+{
+    if (options.scenario == BENCH_SCENARIO_BOSS)
+    {
+        Creature* boss = master->GetMap()->GetCreature(bossGuid);
+        return boss && boss->isAlive() ? boss : nullptr;
+    }
+
+    if (options.scenario != BENCH_SCENARIO_PVP)
+        return nullptr;
+
+    Player* target = nullptr;
+    float targetDist = 0.0f;
+    for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        Player* enemy = sObjectMgr.GetPlayer(itr->masterGuid);
+        if (!enemy || enemy->GetTeam() == master->GetTeam())
+            continue;
+
+        for (uint32 i = 0; i <= itr->botGuids.size(); ++i)
+        {
+            Player* player = i ? sObjectMgr.GetPlayer(itr->botGuids[i - 1]) : enemy;
+            if (!player || !player->isAlive() || !player->IsInMap(master))
+                continue;
+
+            float dist = master->GetDistance(player);
+            if (!target || dist < targetDist)
+            {
+                target = player;
+                targetDist = dist;
+            }
+        }
+    }
+    return target;
+}
+
+// masters have no AI, scenario orders them and their bots assist
+static void UpdateScenario(BenchOptions const& options, std::vector<BenchGroup> const& groups, ObjectGuid bossGuid)
+{
+    for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+    {
+        Player* master = sObjectMgr.GetPlayer(itr->masterGuid);
+        if (!master || !master->IsInWorld())
+            continue;
+
+        AckTeleport(master);
+
+        if (!master->isAlive())
+        {
+            master->ResurrectPlayer(1.0f);
+            master->SpawnCorpseBones();
+            continue;
+        }
+
+        if (options.scenario == BENCH_SCENARIO_PVP)
+        {
+            master->SetPvP(true);
+            for (std::vector<ObjectGuid>::const_iterator bItr = itr->botGuids.begin(); bItr != itr->botGuids.end(); ++bItr)
+                if (Player* bot = sObjectMgr.GetPlayer(*bItr))
+                    bot->SetPvP(true);
+        }
+
+        Unit* target = SelectTarget(options, master, groups, bossGuid);
+        if (target && master->getVictim() != target)
+        {
+            master->SetSelectionGuid(target->GetObjectGuid());
+            master->Attack(target, true);
+            master->GetMotionMaster()->MoveChase(target);
+        }
+    }
+}
+
+static uint32 Percentile(std::vector<uint32> const& sorted, uint32 percent)
+{
+    return sorted[std::min(size_t(sorted.size() * percent / 100), sorted.size() - 1)];
+}
+
+static void Report(char const* name, std::vector<uint32> times)
+{
+    std::sort(times.begin(), times.end());
+
+    uint64 total = 0;
+    for (std::vector<uint32>::const_iterator itr = times.begin(); itr != times.end(); ++itr)
+        total += *itr;
+
+    printf("%-10s mean %8.3f ms, p50 %8.3f ms, p90 %8.3f ms, p99 %8.3f ms, max %8.3f ms\n", name, total / 1000.0 / times.size(),
+           Percentile(times, 50) / 1000.0, Percentile(times, 90) / 1000.0, Percentile(times, 99) / 1000.0, times.back() / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options) || !options.ticks)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    if (!sConfig.SetSource(options.configFile))
+    {
+        sLog.outError("Could not find configuration file %s.", options.configFile.c_str());
+        return 1;
+    }
+
+    BarGoLink::SetOutputState(false);
+
+    if (!StartDatabase(WorldDatabase, "WorldDatabaseInfo", "WorldDatabaseConnections", "db_version", REVISION_DB_MANGOS) ||
+            !StartDatabase(CharacterDatabase, "CharacterDatabaseInfo", "CharacterDatabaseConnections", "character_db_version", REVISION_DB_CHARACTERS) ||
+            !StartDatabase(LoginDatabase, "LoginDatabaseInfo", "LoginDatabaseConnections", "realmd_db_version", REVISION_DB_REALMD))
+    {
+        StopDatabases();
+        return 1;
+    }
+
+    realmID = sConfig.GetIntDefault("RealmID", 0);
+
+    std::chrono::steady_clock::time_point bootStart = std::chrono::steady_clock::now();
+    sWorld.SetInitialWorldSettings();
+    double bootTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - bootStart).count();
+
+    CharacterDatabase.AllowAsyncTransactions();
+    WorldDatabase.AllowAsyncTransactions();
+    LoginDatabase.AllowAsyncTransactions();
+
+    WorldDatabase.ThreadStart();
+    sWorld.InitResultQueue();
+
+    std::vector<BenchGroup> groups;
+    if (!LoadGroups(options.bots, groups))
+    {
+        sLog.outError("No characters in character database");
+        StopDatabases();
+        return 1;
+    }
+
+    uint32 bots = 0;
+    for (std::vector<BenchGroup>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr)
+        bots += itr->botGuids.size();
+
+    ObjectGuid bossGuid;
+    int exitCode = 1;
+    if (LoginGroups(groups, options.diff) && SetupScenario(options, groups, bossGuid) && WaitFor(BotsInWorld, groups, options.diff))
+    {
+        for (uint32 i = 0; i < options.warmup; ++i)
+        {
+            if (i % BENCH_ORDER_TICKS == 0)
+                UpdateScenario(options, groups, bossGuid);
+            RunTick(options.diff);
+        }
+
+        std::vector<uint32> tickTimes(options.ticks);
+        std::vector<uint32> botTimes(options.ticks);
+        std::vector<uint32> otherTimes(options.ticks);
+        for (uint32 i = 0; i < options.ticks; ++i)
+        {
+            if (i % BENCH_ORDER_TICKS == 0)
+                UpdateScenario(options, groups, bossGuid);
+
+            tickTimes[i] = RunTick(options.diff);
+            botTimes[i] = std::min(sPlayerbotScheduler.GetTickTime(), tickTimes[i]);
+            otherTimes[i] = tickTimes[i] - botTimes[i];
+        }
+
+        printf("World benchmark: %u masters, %u bots, %u ticks of %u ms, world loaded in %.1f s\n",
+               uint32(groups.size()), bots, options.ticks, options.diff, bootTime);
+        Report("tick", tickTimes);
+        Report("bot AI", botTimes);
+        Report("other", otherTimes);
+        exitCode = 0;
+    }
+
+    LogoutGroups(groups, options.diff);
+
+    sWorld.CleanupsBeforeStop();
+    WorldDatabase.ThreadEnd();
+    StopDatabases();
+    return exitCode;
+}
@@ -26,6 +26,9 @@
 #include "DetourCommon.h"
 
 #include <climits>
+#include <chrono>
+#include <thread>
+#include <sys/stat.h>
 
 using namespace VMAP;
 
@@ -33,24 +36,32 @@ namespace MMAP
 {
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath, uint32 threads) :
         m_terrainBuilder(NULL),
         m_debugOutput(debugOutput),
+        m_offMeshFilePath(offMeshFilePath),
         m_skipContinents(skipContinents),
         m_skipJunkMaps(skipJunkMaps),
         m_skipBattlegrounds(skipBattlegrounds),
         m_maxWalkableAngle(maxWalkableAngle),
         m_bigBaseUnit(bigBaseUnit),
-        m_rcContext(NULL),
-        m_offMeshFilePath(offMeshFilePath)
+        m_skipLiquid(skipLiquid),
+        m_threads(threads ? threads : 1),
+        m_nextJob(0),
+        m_doneJobs(0)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
-        m_rcContext = new rcContext(false);
-
         discoverTiles();
     }
 
+    /**************************************************************************/
+    BuildContext::~BuildContext()
+    {
+        for (std::map<uint32, dtNavMesh*>::iterator itr = navMeshes.begin(); itr != navMeshes.end(); ++itr)
+            dtFreeNavMesh(itr->second);
+    }
+
     /**************************************************************************/
     MapBuilder::~MapBuilder()
     {
@@ -61,7 +72,6 @@ namespace MMAP
         }
 
         delete m_terrainBuilder;
-        delete m_rcContext;
     }
 
     /**************************************************************************/
@@ -144,12 +154,16 @@ namespace MMAP
     /**************************************************************************/
     void MapBuilder::buildAllMaps()
     {
+        // tiles of all maps share one job list, so threads are not idle at end of each map
+        std::vector<TileJob> jobs;
         for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
         {
             uint32 mapID = (*it).first;
             if (!shouldSkipMap(mapID))
-                buildMap(mapID);
+                prepareMap(mapID, jobs);
         }
+
+        buildTiles(jobs);
     }
 
     /**************************************************************************/
@@ -198,22 +212,33 @@ namespace MMAP
     /**************************************************************************/
     void MapBuilder::buildSingleTile(uint32 mapID, uint32 tileX, uint32 tileY)
     {
-        dtNavMesh* navMesh = NULL;
-        buildNavMesh(mapID, navMesh);
+        dtNavMeshParams navMeshParams;
+        if (!buildNavMeshParams(mapID, navMeshParams))
+            return;
+
+        m_navMeshParams[mapID] = navMeshParams;
+
+        BuildContext context(m_skipLiquid);
+        dtNavMesh* navMesh = getNavMesh(context, mapID);
         if (!navMesh)
-        {
-            printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
             return;
-        }
 
-        buildTile(mapID, tileX, tileY, navMesh, 1, 1);
-        dtFreeNavMesh(navMesh);
+        printf("[Map %03i] Building tile [%02u,%02u]\n", mapID, tileX, tileY);
+        buildTile(context, mapID, tileX, tileY, navMesh);
     }
 
     /**************************************************************************/
     void MapBuilder::buildMap(uint32 mapID)
     {
-        printf("Building map %03u:                                    \n", mapID);
+        std::vector<TileJob> jobs;
+        if (prepareMap(mapID, jobs))
+            buildTiles(jobs);
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::prepareMap(uint32 mapID, std::vector<TileJob>& jobs)
+    {
+        printf("Preparing map %03u:                                   \n", mapID);
 
         std::set<uint32>* tiles = getTileList(mapID);
 
@@ -231,52 +256,129 @@ namespace MMAP
         }
 
         if (!tiles->size())
-            return;
+            return false;
 
-        // build navMesh
-        dtNavMesh* navMesh = NULL;
-        buildNavMesh(mapID, navMesh);
-        if (!navMesh)
-        {
-            printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
-            return;
-        }
+        // build navMesh params, every thread creates its own navmesh from them
+        dtNavMeshParams navMeshParams;
+        if (!buildNavMeshParams(mapID, navMeshParams))
+            return false;
 
-        // now start building mmtiles for each tile
-        printf("[Map %03i] We have %u tiles.                          \n", mapID, uint32(tiles->size()));
+        m_navMeshParams[mapID] = navMeshParams;
 
-        uint32 currentTile = 0;
+        uint32 skipped = 0;
         for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
-            currentTile++;
-            uint32 tileX, tileY;
+            TileJob job;
+            job.mapID = mapID;
 
             // unpack tile coords
-            StaticMapTree::unpackTileID((*it), tileX, tileY);
+            StaticMapTree::unpackTileID((*it), job.tileX, job.tileY);
 
-            if (shouldSkipTile(mapID, tileX, tileY))
+            // output of interrupted or previous run
+            if (shouldSkipTile(mapID, job.tileX, job.tileY))
+            {
+                ++skipped;
                 continue;
+            }
 
-            buildTile(mapID, tileX, tileY, navMesh, currentTile, uint32(tiles->size()));
+            jobs.push_back(job);
         }
 
-        dtFreeNavMesh(navMesh);
+        printf("[Map %03i] We have %u tiles, %u are up to date.       \n", mapID, uint32(tiles->size()), skipped);
+        return true;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildTiles(std::vector<TileJob> const& jobs)
+    {
+        if (jobs.empty())
+        {
+            printf("All tiles are up to date.\n");
+            return;
+        }
+
+        uint32 threads = std::min(m_threads, uint32(jobs.size()));
+        printf("Building %u tiles using %u thread(s)\n\n", uint32(jobs.size()), threads);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        m_nextJob = 0;
+        m_doneJobs = 0;
+
+        if (threads == 1)
+            buildThread(jobs);
+        else
+        {
+            std::vector<std::thread> workers;
+            for (uint32 i = 0; i < threads; ++i)
+                workers.push_back(std::thread(&MapBuilder::buildThread, this, std::cref(jobs)));
+
+            for (uint32 i = 0; i < workers.size(); ++i)
+                workers[i].join();
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("Built %u tiles in %.1f s\n\n", uint32(jobs.size()), elapsed);
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildThread(std::vector<TileJob> const& jobs)
+    {
+        BuildContext context(m_skipLiquid);
+
+        for (uint32 i = m_nextJob++; i < jobs.size(); i = m_nextJob++)
+        {
+            TileJob const& job = jobs[i];
 
-        printf("[Map %03i] Complete!                             \n\n", mapID);
+            dtNavMesh* navMesh = getNavMesh(context, job.mapID);
+            if (!navMesh)
+                continue;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            buildTile(context, job.mapID, job.tileX, job.tileY, navMesh);
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            uint32 done = ++m_doneJobs;
+
+            std::lock_guard<std::mutex> guard(m_printLock);
+            printf("[Map %03i] Tile [%02u,%02u] built in %.1f s (%u / %u, %.1f%%)            \n", job.mapID, job.tileX, job.tileY,
+                   elapsed, done, uint32(jobs.size()), done * 100.0f / jobs.size());
+        }
     }
 
     /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount)
+    dtNavMesh* MapBuilder::getNavMesh(BuildContext& context, uint32 mapID)
     {
-        printf("[Map %03i] Building tile [%02u,%02u] (%02u / %02u)    \n", mapID, tileX, tileY, curTile, tileCount);
+        std::map<uint32, dtNavMesh*>::iterator itr = context.navMeshes.find(mapID);
+        if (itr != context.navMeshes.end())
+            return itr->second;
+
+        // params of all maps are set before threads start, so lookup is safe
+        std::map<uint32, dtNavMeshParams>::const_iterator params = m_navMeshParams.find(mapID);
 
+        dtNavMesh* navMesh = dtAllocNavMesh();
+        if (params == m_navMeshParams.end() || dtStatusFailed(navMesh->init(&params->second)))
+        {
+            std::lock_guard<std::mutex> guard(m_printLock);
+            printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
+            dtFreeNavMesh(navMesh);
+            navMesh = NULL;
+        }
+
+        context.navMeshes[mapID] = navMesh;
+        return navMesh;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildTile(BuildContext& context, uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
+    {
         MeshData meshData;
 
         // get heightmap data
-        m_terrainBuilder->loadMap(mapID, tileX, tileY, meshData);
+        context.terrainBuilder.loadMap(mapID, tileX, tileY, meshData);
 
         // get model data
-        m_terrainBuilder->loadVMap(mapID, tileY, tileX, meshData);
+        context.terrainBuilder.loadVMap(mapID, tileY, tileX, meshData);
 
         // if there is no data, give up now
         if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
@@ -298,14 +400,14 @@ namespace MMAP
         float bmin[3], bmax[3];
         getTileBounds(tileX, tileY, allVerts.getCArray(), allVerts.size() / 3, bmin, bmax);
 
-        m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
+        context.terrainBuilder.loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
         // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        buildMoveMapTile(context, mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildNavMesh(uint32 mapID, dtNavMesh*& navMesh)
+    bool MapBuilder::buildNavMeshParams(uint32 mapID, dtNavMeshParams& navMeshParams)
     {
         std::set<uint32>* tiles = getTileList(mapID);
 
@@ -345,7 +447,6 @@ namespace MMAP
         /***       now create the navmesh       ***/
 
         // navmesh creation params
-        dtNavMeshParams navMeshParams;
         memset(&navMeshParams, 0, sizeof(dtNavMeshParams));
         navMeshParams.tileWidth = GRID_SIZE;
         navMeshParams.tileHeight = GRID_SIZE;
@@ -353,12 +454,15 @@ namespace MMAP
         navMeshParams.maxTiles = maxTiles;
         navMeshParams.maxPolys = maxPolysPerTile;
 
-        navMesh = dtAllocNavMesh();
+        // check params before they are written
+        dtNavMesh* navMesh = dtAllocNavMesh();
         printf("[Map %03i] Creating navMesh...                        \r", mapID);
-        if (!navMesh->init(&navMeshParams))
+        bool valid = !dtStatusFailed(navMesh->init(&navMeshParams));
+        dtFreeNavMesh(navMesh);
+        if (!valid)
         {
             printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
-            return;
+            return false;
         }
 
         char fileName[25];
@@ -367,20 +471,20 @@ namespace MMAP
         FILE* file = fopen(fileName, "wb");
         if (!file)
         {
-            dtFreeNavMesh(navMesh);
             char message[1024];
             sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, fileName);
             perror(message);
-            return;
+            return false;
         }
 
         // now that we know navMesh params are valid, we can write them to file
         fwrite(&navMeshParams, sizeof(dtNavMeshParams), 1, file);
         fclose(file);
+        return true;
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
+    void MapBuilder::buildMoveMapTile(BuildContext& context, uint32 mapID, uint32 tileX, uint32 tileY,
                                       MeshData& meshData, float bmin[3], float bmax[3],
                                       dtNavMesh* navMesh)
     {
@@ -468,7 +572,7 @@ namespace MMAP
 
                 // build heightfield
                 tile.solid = rcAllocHeightfield();
-                if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
+                if (!tile.solid || !rcCreateHeightfield(&context.rcCtx, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
                     printf("%s Failed building heightfield!                       \n", tileString);
                     continue;
@@ -477,45 +581,45 @@ namespace MMAP
                 // mark all walkable tiles, both liquids and solids
                 unsigned char* triFlags = new unsigned char[tTriCount];
                 memset(triFlags, NAV_GROUND, tTriCount * sizeof(unsigned char));
-                rcClearUnwalkableTriangles(m_rcContext, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
-                rcRasterizeTriangles(m_rcContext, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
+                rcClearUnwalkableTriangles(&context.rcCtx, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
+                rcRasterizeTriangles(&context.rcCtx, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
                 delete [] triFlags;
 
-                rcFilterLowHangingWalkableObstacles(m_rcContext, config.walkableClimb, *tile.solid);
-                rcFilterLedgeSpans(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
-                rcFilterWalkableLowHeightSpans(m_rcContext, tileCfg.walkableHeight, *tile.solid);
+                rcFilterLowHangingWalkableObstacles(&context.rcCtx, config.walkableClimb, *tile.solid);
+                rcFilterLedgeSpans(&context.rcCtx, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
+                rcFilterWalkableLowHeightSpans(&context.rcCtx, tileCfg.walkableHeight, *tile.solid);
 
-                rcRasterizeTriangles(m_rcContext, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
+                rcRasterizeTriangles(&context.rcCtx, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
 
                 // compact heightfield spans
                 tile.chf = rcAllocCompactHeightfield();
-                if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
+                if (!tile.chf || !rcBuildCompactHeightfield(&context.rcCtx, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
                     printf("%s Failed compacting heightfield!                     \n", tileString);
                     continue;
                 }
 
                 // build polymesh intermediates
-                if (!rcErodeWalkableArea(m_rcContext, config.walkableRadius, *tile.chf))
+                if (!rcErodeWalkableArea(&context.rcCtx, config.walkableRadius, *tile.chf))
                 {
                     printf("%s Failed eroding area!                               \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildDistanceField(m_rcContext, *tile.chf))
+                if (!rcBuildDistanceField(&context.rcCtx, *tile.chf))
                 {
                     printf("%s Failed building distance field!                    \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildRegions(m_rcContext, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
+                if (!rcBuildRegions(&context.rcCtx, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
                 {
                     printf("%s Failed building regions!                           \n", tileString);
                     continue;
                 }
 
                 tile.cset = rcAllocContourSet();
-                if (!tile.cset || !rcBuildContours(m_rcContext, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
+                if (!tile.cset || !rcBuildContours(&context.rcCtx, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
                 {
                     printf("%s Failed building contours!                          \n", tileString);
                     continue;
@@ -523,14 +627,14 @@ namespace MMAP
 
                 // build polymesh
                 tile.pmesh = rcAllocPolyMesh();
-                if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
+                if (!tile.pmesh || !rcBuildPolyMesh(&context.rcCtx, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
                     printf("%s Failed building polymesh!                          \n", tileString);
                     continue;
                 }
 
                 tile.dmesh = rcAllocPolyMeshDetail();
-                if (!tile.dmesh || !rcBuildPolyMeshDetail(m_rcContext, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
+                if (!tile.dmesh || !rcBuildPolyMeshDetail(&context.rcCtx, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
                 {
                     printf("%s Failed building polymesh detail!                   \n", tileString);
                     continue;
@@ -576,7 +680,7 @@ namespace MMAP
             delete[] tiles;
             return;
         }
-        rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
+        rcMergePolyMeshes(&context.rcCtx, pmmerge, nmerge, *iv.polyMesh);
 
         iv.polyMeshDetail = rcAllocPolyMeshDetail();
         if (!iv.polyMeshDetail)
@@ -587,7 +691,7 @@ namespace MMAP
             delete[] tiles;
             return;
         }
-        rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
+        rcMergePolyMeshDetails(&context.rcCtx, dmmerge, nmerge, *iv.polyMeshDetail);
 
         // free things up
         delete [] pmmerge;
@@ -696,14 +800,16 @@ namespace MMAP
                 continue;
             }
 
-            // file output
+            // file output, written under temporary name so interrupted run never leaves partial tile
             char fileName[255];
             sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
-            FILE* file = fopen(fileName, "wb");
+            char tmpFileName[255];
+            sprintf(tmpFileName, "%s.tmp", fileName);
+            FILE* file = fopen(tmpFileName, "wb");
             if (!file)
             {
                 char message[1024];
-                sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, fileName);
+                sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, tmpFileName);
                 perror(message);
                 navMesh->removeTile(tileRef, NULL, NULL);
                 continue;
@@ -714,13 +820,21 @@ namespace MMAP
             // write header
             MmapTileHeader header;
             header.size = uint32(navDataSize);
-            header.usesLiquids = m_terrainBuilder->usesLiquids() ? 1 : 0;
+            header.usesLiquids = context.terrainBuilder.usesLiquids() ? 1 : 0;
             fwrite(&header, sizeof(MmapTileHeader), 1, file);
 
             // write data
             fwrite(navData, sizeof(unsigned char), navDataSize, file);
             fclose(file);
 
+            remove(fileName);
+            if (rename(tmpFileName, fileName) != 0)
+            {
+                char message[1024];
+                sprintf(message, "[Map %03i] Failed to rename %s!             \n", mapID, tmpFileName);
+                perror(message);
+            }
+
             // now that tile is written to disk, we can unload it
             navMesh->removeTile(tileRef, NULL, NULL);
         }
@@ -848,6 +962,39 @@ namespace MMAP
         if (header.mmapVersion != MMAP_VERSION)
             return false;
 
+        // partially written file
+        struct stat tileStat;
+        if (stat(fileName, &tileStat) != 0 || uint32(tileStat.st_size) != sizeof(MmapTileHeader) + header.size)
+            return false;
+
+        // rebuild when terrain of tile or its neighbours, vmaps or offmesh connections changed
+        std::vector<std::string> inputs;
+        char inputName[255];
+        for (int x = int(tileX) - 1; x <= int(tileX) + 1; ++x)
+        {
+            for (int y = int(tileY) - 1; y <= int(tileY) + 1; ++y)
+            {
+                if (x < 0 || y < 0 || x >= 64 || y >= 64)
+                    continue;
+
+                sprintf(inputName, "maps/%03u%02u%02u.map", mapID, y, x);
+                inputs.push_back(inputName);
+            }
+        }
+
+        sprintf(inputName, "vmaps/%03u.vmtree", mapID);
+        inputs.push_back(inputName);
+        inputs.push_back("vmaps/" + StaticMapTree::getTileFileName(mapID, tileY, tileX));
+        if (m_offMeshFilePath)
+            inputs.push_back(m_offMeshFilePath);
+
+        for (std::vector<std::string>::const_iterator itr = inputs.begin(); itr != inputs.end(); ++itr)
+        {
+            struct stat inputStat;
+            if (stat(itr->c_str(), &inputStat) == 0 && inputStat.st_mtime > tileStat.st_mtime)
+                return false;
+        }
+
         return true;
     }
 
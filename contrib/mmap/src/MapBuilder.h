@@ -22,6 +22,8 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <atomic>
+#include <mutex>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
@@ -57,6 +59,25 @@ namespace MMAP
         rcPolyMeshDetail* dmesh;
     };
 
+    // one mmap tile waiting for a build thread
+    struct TileJob
+    {
+        uint32 mapID;
+        uint32 tileX;
+        uint32 tileY;
+    };
+
+    // state owned by one build thread, recast and vmap loading are not shared between threads
+    struct BuildContext
+    {
+        BuildContext(bool skipLiquid) : terrainBuilder(skipLiquid), rcCtx(false) {}
+        ~BuildContext();
+
+        TerrainBuilder terrainBuilder;
+        rcContext rcCtx;
+        std::map<uint32, dtNavMesh*> navMeshes;             // per map, only used to validate built tiles
+    };
+
     class MapBuilder
     {
         public:
@@ -67,7 +88,8 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       uint32 threads           = 1);
 
             ~MapBuilder();
 
@@ -85,12 +107,20 @@ namespace MMAP
             void discoverTiles();
             std::set<uint32>* getTileList(uint32 mapID);
 
-            void buildNavMesh(uint32 mapID, dtNavMesh*& navMesh);
+            // adds tiles of map to job list and writes its navmesh params
+            bool prepareMap(uint32 mapID, std::vector<TileJob>& jobs);
+            bool buildNavMeshParams(uint32 mapID, dtNavMeshParams& navMeshParams);
+            dtNavMesh* getNavMesh(BuildContext& context, uint32 mapID);
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount);
+            // builds jobs by m_threads threads, each takes next job from shared list
+            void buildTiles(std::vector<TileJob> const& jobs);
+            void buildThread(std::vector<TileJob> const& jobs);
+
+            void buildTile(BuildContext& context, uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
 
             // move map building
-            void buildMoveMapTile(uint32 mapID,
+            void buildMoveMapTile(BuildContext& context,
+                                  uint32 mapID,
                                   uint32 tileX,
                                   uint32 tileY,
                                   MeshData& meshData,
@@ -105,10 +135,12 @@ namespace MMAP
 
             bool shouldSkipMap(uint32 mapID);
             bool isTransportMap(uint32 mapID);
+            // tile output exists, is complete and newer than its input files
             bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
             TerrainBuilder* m_terrainBuilder;
             TileList m_tiles;
+            std::map<uint32, dtNavMeshParams> m_navMeshParams;
 
             bool m_debugOutput;
 
@@ -119,9 +151,14 @@ namespace MMAP
 
             float m_maxWalkableAngle;
             bool m_bigBaseUnit;
+            bool m_skipLiquid;
+
+            uint32 m_threads;
 
-            // build performance - not really used for now
-            rcContext* m_rcContext;
+            // progress of buildTiles
+            std::atomic<uint32> m_nextJob;
+            std::atomic<uint32> m_doneJobs;
+            std::mutex m_printLock;
     };
 }
 
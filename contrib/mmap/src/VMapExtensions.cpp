@@ -46,6 +46,8 @@ namespace VMAP
     // declared in src/shared/vmap/WorldModel.h
     void WorldModel::getGroupModels(vector<GroupModel>& outGroupModels)
     {
+        for (uint32 i = 0; i < groupModels.size(); ++i)
+            getGroupModel(i);
         outGroupModels = groupModels;
     }
 
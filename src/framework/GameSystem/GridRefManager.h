@@ -19,17 +19,44 @@
 #ifndef _GRIDREFMANAGER
 #define _GRIDREFMANAGER
 
+#include "Platform/Define.h"
 #include "Utilities/LinkedReference/RefManager.h"
 
+#include <type_traits>
+#include <vector>
+
 template<class OBJECT> class GridReference;
 
+// Object fields most often checked by grid visitors, kept next to each other for all objects of a cell
+struct GridObjectHotData
+{
+    float x, y, z;
+    uint32 typeMask;
+    uint64 guid;
+};
+
+/**
+ * Objects of one type in one cell.
+ *
+ * Besides the intrusive list, which iterators walk and which allows objects to change cells while
+ * visited, objects are also kept in dense array with their hot data. Dense arrays use swap-remove,
+ * so order changes when object is removed and they must be used only by visitors which do not
+ * add or remove objects in visited cells. Objects with HasGridHotData provide hot data by GetGridHotData,
+ * position is kept up to date by UpdateHotPosition of their reference. Other objects (cameras, grids)
+ * have no position of their own to keep and their cells have no hot data array.
+ */
 template<class OBJECT>
 class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
 {
+        friend class GridReference<OBJECT>;
+
     public:
 
         typedef LinkedListHead::Iterator< GridReference<OBJECT> > iterator;
 
+        // references must be invalidated while dense arrays still exist
+        ~GridRefManager() { this->clearReferences(); }
+
         GridReference<OBJECT>* getFirst()
         {
             return (GridReference<OBJECT>*)RefManager<GridRefManager<OBJECT>, OBJECT>::getFirst();
@@ -44,5 +71,46 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
         iterator end() { return iterator(nullptr); }
         iterator rbegin() { return iterator(getLast()); }
         iterator rend() { return iterator(nullptr); }
+
+        uint32 GetDenseSize() const { return uint32(m_denseObjects.size()); }
+        OBJECT* const* GetDenseObjects() const { return m_denseObjects.data(); }
+        // nullptr for objects without hot data
+        GridObjectHotData const* GetDenseHotData() const { return m_denseHotData.empty() ? nullptr : m_denseHotData.data(); }
+
+    private:
+
+        void AddDense(GridReference<OBJECT>* ref)
+        {
+            ref->m_denseIndex = uint32(m_denseObjects.size());
+            m_denseObjects.push_back(ref->getSource());
+            AddHotData(ref->getSource(), std::integral_constant<bool, OBJECT::HasGridHotData>());
+        }
+
+        void AddHotData(OBJECT* object, std::true_type)
+        {
+            m_denseHotData.push_back(GridObjectHotData());
+            object->GetGridHotData(m_denseHotData.back());
+        }
+
+        void AddHotData(OBJECT* /*object*/, std::false_type) {}
+
+        void RemoveDense(GridReference<OBJECT>* ref)
+        {
+            uint32 idx = ref->m_denseIndex;
+            uint32 last = uint32(m_denseObjects.size()) - 1;
+            if (idx != last)
+            {
+                m_denseObjects[idx] = m_denseObjects[last];
+                if (OBJECT::HasGridHotData)
+                    m_denseHotData[idx] = m_denseHotData[last];
+                m_denseObjects[idx]->GetGridRef().m_denseIndex = idx;
+            }
+            m_denseObjects.pop_back();
+            if (OBJECT::HasGridHotData)
+                m_denseHotData.pop_back();
+        }
+
+        std::vector<OBJECT*> m_denseObjects;
+        std::vector<GridObjectHotData> m_denseHotData;
 };
 #endif
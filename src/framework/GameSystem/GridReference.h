@@ -26,6 +26,8 @@ template<class OBJECT> class GridRefManager;
 template<class OBJECT>
 class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
 {
+        friend class GridRefManager<OBJECT>;
+
     protected:
 
         void targetObjectBuildLink() override
@@ -33,25 +35,30 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
             // called from link()
             this->getTarget()->insertFirst(this);
             this->getTarget()->incSize();
+            this->getTarget()->AddDense(this);
         }
 
         void targetObjectDestroyLink() override
         {
             // called from unlink()
             if (this->isValid())
+            {
                 this->getTarget()->decSize();
+                this->getTarget()->RemoveDense(this);
+            }
         }
 
         void sourceObjectDestroyLink() override
         {
             // called from invalidate()
             this->getTarget()->decSize();
+            this->getTarget()->RemoveDense(this);
         }
 
     public:
 
         GridReference()
-            : Reference<GridRefManager<OBJECT>, OBJECT>()
+            : Reference<GridRefManager<OBJECT>, OBJECT>(), m_denseIndex(0)
         {
         }
 
@@ -64,6 +71,22 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
         {
             return (GridReference*)Reference<GridRefManager<OBJECT>, OBJECT>::next();
         }
+
+        // keeps position in cell hot data in sync, must be called on every position change of linked object
+        void UpdateHotPosition(float x, float y, float z)
+        {
+            if (!this->isValid())
+                return;
+
+            GridObjectHotData& data = this->getTarget()->m_denseHotData[m_denseIndex];
+            data.x = x;
+            data.y = y;
+            data.z = z;
+        }
+
+    private:
+
+        uint32 m_denseIndex;                                // index in dense arrays of linked cell
 };
 
 #endif
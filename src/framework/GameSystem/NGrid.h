@@ -118,6 +118,11 @@ class NGrid
             i_Reference.link(pTo, this);
         }
 
+        GridReference<NGrid<N, ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES> >& GetGridRef() { return i_Reference; }
+
+        // grids are kept in map by grid coordinates, no position for cell hot data
+        static bool const HasGridHotData = false;
+
         bool isGridObjectDataLoaded() const { return i_GridObjectDataLoaded; }
         void setGridObjectDataLoaded(bool pLoaded) { i_GridObjectDataLoaded = pLoaded; }
 
@@ -18,15 +18,305 @@
 
 #include "EventProcessor.h"
 
-EventProcessor::EventProcessor()
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// timer wheel has EVENT_WHEEL_LEVELS levels of EVENT_WHEEL_SLOTS slots, slot of level N covers 32^N ms
+#define EVENT_WHEEL_BITS    5
+#define EVENT_WHEEL_SLOTS   (1 << EVENT_WHEEL_BITS)
+#define EVENT_WHEEL_MASK    (EVENT_WHEEL_SLOTS - 1)
+#define EVENT_WHEEL_LEVELS  4
+
+// processor switches from sorted event list to timer wheel when it has more events
+#define EVENT_LIST_MAX_SIZE 16
+
+// event pool block size classes and limit of kept free blocks per size class and thread
+#define EVENT_POOL_GRANULARITY  16
+#define EVENT_POOL_MAX_SIZE     256
+#define EVENT_POOL_MAX_FREE     512
+
+namespace
+{
+    struct EventPoolBlock
+    {
+        EventPoolBlock* next;
+    };
+
+    // zero initialized without destructor, so it is usable while static objects are destroyed at exit
+    struct EventPool
+    {
+        EventPoolBlock* freeList[EVENT_POOL_MAX_SIZE / EVENT_POOL_GRANULARITY];
+        uint32 freeCount[EVENT_POOL_MAX_SIZE / EVENT_POOL_GRANULARITY];
+    };
+
+    thread_local EventPool t_eventPool;
+
+    inline uint32 LowestSetBit(uint32 bits)
+    {
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanForward(&idx, bits);
+        return idx;
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+}
+
+void* BasicEvent::operator new(std::size_t size)
+{
+    if (size > EVENT_POOL_MAX_SIZE)
+        return ::operator new(size);
+
+    std::size_t idx = (size - 1) / EVENT_POOL_GRANULARITY;
+    EventPool& pool = t_eventPool;
+    if (EventPoolBlock* block = pool.freeList[idx])
+    {
+        pool.freeList[idx] = block->next;
+        --pool.freeCount[idx];
+        return block;
+    }
+
+    return ::operator new((idx + 1) * EVENT_POOL_GRANULARITY);
+}
+
+void BasicEvent::operator delete(void* ptr, std::size_t size)
+{
+    if (!ptr)
+        return;
+
+    std::size_t idx = (size - 1) / EVENT_POOL_GRANULARITY;
+    if (size > EVENT_POOL_MAX_SIZE || t_eventPool.freeCount[idx] >= EVENT_POOL_MAX_FREE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    EventPool& pool = t_eventPool;
+    EventPoolBlock* block = static_cast<EventPoolBlock*>(ptr);
+    block->next = pool.freeList[idx];
+    pool.freeList[idx] = block;
+    ++pool.freeCount[idx];
+}
+
+struct EventProcessor::TimerWheel
+{
+    TimerWheel() : overflow(nullptr)
+    {
+        memset(occupied, 0, sizeof(occupied));
+        memset(slots, 0, sizeof(slots));
+    }
+
+    static void Link(BasicEvent*& head, BasicEvent* Event)
+    {
+        Event->m_next = head;
+        if (head)
+            head->m_prevNext = &Event->m_next;
+        head = Event;
+        Event->m_prevNext = &head;
+    }
+
+    static void Unlink(BasicEvent* Event)
+    {
+        *Event->m_prevNext = Event->m_next;
+        if (Event->m_next)
+            Event->m_next->m_prevNext = Event->m_prevNext;
+        Event->m_next = nullptr;
+        Event->m_prevNext = nullptr;
+    }
+
+    // slot bitmaps first, most updates only check them
+    uint32 occupied[EVENT_WHEEL_LEVELS];                    // bit per non empty slot
+    BasicEvent* overflow;                                   // events farther than last level covers
+    BasicEvent* slots[EVENT_WHEEL_LEVELS][EVENT_WHEEL_SLOTS];
+};
+
+EventProcessor::EventProcessor() : m_time(0), m_wheelTime(0), m_nextCheckTime(0), m_nextSeq(0), m_count(0), m_list(nullptr), m_wheel(nullptr), m_aborting(false)
 {
-    m_time = 0;
-    m_aborting = false;
 }
 
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
+    delete m_wheel;
+}
+
+void EventProcessor::ScheduleEvent(BasicEvent* Event)
+{
+    if (!m_wheel)
+    {
+        // time already passed, executed in running update or at next update like in wheel
+        if (Event->m_execTime <= m_time)
+        {
+            m_expired.push_back(Event);
+            return;
+        }
+
+        // after events with same or lower time, to keep add order
+        BasicEvent** pos = &m_list;
+        while (*pos && (*pos)->m_execTime <= Event->m_execTime)
+            pos = &(*pos)->m_next;
+
+        TimerWheel::Link(*pos, Event);
+        m_nextCheckTime = std::min(m_nextCheckTime, Event->m_execTime);
+        ++m_count;
+        return;
+    }
+
+    // time already passed in wheel, executed in running update or at next update
+    if (Event->m_execTime < m_wheelTime)
+    {
+        m_expired.push_back(Event);
+        return;
+    }
+
+    uint64 delta = Event->m_execTime - m_wheelTime;
+    ++m_count;
+
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+    {
+        if (delta < (uint64(1) << (EVENT_WHEEL_BITS * (level + 1))))
+        {
+            uint32 idx = uint32(Event->m_execTime >> (EVENT_WHEEL_BITS * level)) & EVENT_WHEEL_MASK;
+            TimerWheel::Link(m_wheel->slots[level][idx], Event);
+            m_wheel->occupied[level] |= 1u << idx;
+
+            // slot start time for higher levels, when its events are moved down
+            m_nextCheckTime = std::min(m_nextCheckTime, (Event->m_execTime >> (EVENT_WHEEL_BITS * level)) << (EVENT_WHEEL_BITS * level));
+            return;
+        }
+    }
+
+    TimerWheel::Link(m_wheel->overflow, Event);
+    m_nextCheckTime = std::min(m_nextCheckTime, (Event->m_execTime >> (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS)) << (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS));
+}
+
+// moves all events of higher level slot to lower levels, must be called at start of slot time range
+void EventProcessor::CascadeSlot(BasicEvent*& slot)
+{
+    BasicEvent* Event = slot;
+    slot = nullptr;
+    while (Event)
+    {
+        BasicEvent* next = Event->m_next;
+        Event->m_next = nullptr;
+        Event->m_prevNext = nullptr;
+        --m_count;
+        ScheduleEvent(Event);
+        Event = next;
+    }
+}
+
+// moves events of higher level slots starting at current wheel time down, must be called on wheel time change
+void EventProcessor::CascadeSlots()
+{
+    if (m_wheelTime & EVENT_WHEEL_MASK)
+        return;
+
+    if ((m_wheelTime & ((uint64(1) << (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS)) - 1)) == 0)
+        CascadeSlot(m_wheel->overflow);
+
+    for (uint32 level = EVENT_WHEEL_LEVELS - 1; level > 0; --level)
+    {
+        if (m_wheelTime & ((uint64(1) << (EVENT_WHEEL_BITS * level)) - 1))
+            continue;
+
+        uint32 idx = uint32(m_wheelTime >> (EVENT_WHEEL_BITS * level)) & EVENT_WHEEL_MASK;
+        if (m_wheel->occupied[level] & (1u << idx))
+        {
+            m_wheel->occupied[level] &= ~(1u << idx);
+            CascadeSlot(m_wheel->slots[level][idx]);
+        }
+    }
+}
+
+// earliest time of used level 0 slot or start time of used higher level slot
+uint64 EventProcessor::GetNextSlotTime() const
+{
+    uint64 next = ~uint64(0);
+    if (m_wheel->overflow)
+        next = ((m_wheelTime >> (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS)) + 1) << (EVENT_WHEEL_BITS * EVENT_WHEEL_LEVELS);
+
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+    {
+        uint32 bits = m_wheel->occupied[level];
+        if (!bits)
+            continue;
+
+        // slots are searched in time order starting from current one, for higher levels current slot is already cascaded
+        uint32 shift = EVENT_WHEEL_BITS * level;
+        uint32 from = (uint32(m_wheelTime >> shift) + (level ? 1 : 0)) & EVENT_WHEEL_MASK;
+        uint32 rotated = from ? (bits >> from) | (bits << (EVENT_WHEEL_SLOTS - from)) : bits;
+        uint64 slotTime = ((m_wheelTime >> shift) + (level ? 1 : 0) + LowestSetBit(rotated)) << shift;
+        next = std::min(next, slotTime);
+    }
+    return next;
+}
+
+void EventProcessor::CollectExpired()
+{
+    while (m_wheelTime <= m_time)
+    {
+        // nothing in wheel, no need to walk over empty slots
+        if (!m_count)
+        {
+            m_wheelTime = m_time + 1;
+            m_nextCheckTime = ~uint64(0);
+            return;
+        }
+
+        // skip empty slots
+        uint64 next = GetNextSlotTime();
+        if (next > m_wheelTime)
+        {
+            m_wheelTime = std::min(next, m_time + 1);
+            CascadeSlots();
+            continue;
+        }
+
+        // expire level 0 slots up to update time or end of current slot range
+        uint32 first = uint32(m_wheelTime) & EVENT_WHEEL_MASK;
+        uint32 last = uint32(std::min(uint64(EVENT_WHEEL_MASK), first + (m_time - m_wheelTime)));
+        uint32 rangeMask = (last == EVENT_WHEEL_MASK ? ~0u : (1u << (last + 1)) - 1) & ~((1u << first) - 1);
+        for (uint32 bits = m_wheel->occupied[0] & rangeMask; bits; bits &= bits - 1)
+        {
+            uint32 idx = LowestSetBit(bits);
+            m_wheel->occupied[0] &= ~(1u << idx);
+            for (BasicEvent* Event = m_wheel->slots[0][idx]; Event;)
+            {
+                BasicEvent* next = Event->m_next;
+                Event->m_next = nullptr;
+                Event->m_prevNext = nullptr;
+                --m_count;
+                m_expired.push_back(Event);
+                Event = next;
+            }
+            m_wheel->slots[0][idx] = nullptr;
+        }
+
+        m_wheelTime += last - first + 1;
+        CascadeSlots();
+    }
+
+    m_nextCheckTime = m_count ? GetNextSlotTime() : ~uint64(0);
+}
+
+void EventProcessor::CollectExpiredList()
+{
+    while (m_list && m_list->m_execTime <= m_time)
+    {
+        BasicEvent* Event = m_list;
+        TimerWheel::Unlink(Event);
+        --m_count;
+        m_expired.push_back(Event);
+    }
+
+    m_nextCheckTime = m_list ? m_list->m_execTime : ~uint64(0);
 }
 
 void EventProcessor::Update(uint32 p_time)
@@ -34,13 +324,34 @@ void EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
-    // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    // wheel can lag behind until its next possible expiration, events added meanwhile are placed relative to wheel time
+    if (m_time < m_nextCheckTime && m_expired.empty())
+        return;
+
+    if (m_wheel)
+        CollectExpired();
+    else
+        CollectExpiredList();
+
+    if (m_expired.empty())
+        return;
+
+    // events with same time keep add order
+    if (m_expired.size() > 1)
+        std::sort(m_expired.begin(), m_expired.end(), [](BasicEvent const* a, BasicEvent const* b)
+        {
+            return a->m_execTime < b->m_execTime || (a->m_execTime == b->m_execTime && a->m_seq < b->m_seq);
+        });
+
+    // main event loop, events added meanwhile with already passed time are appended and executed too
+    // KillAllEvents called from executed event clears or nulls the entries
+    for (std::size_t i = 0; i < m_expired.size(); ++i)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_expired[i];
+        if (!Event)
+            continue;
+
+        m_expired[i] = nullptr;
 
         if (!Event->to_Abort)
         {
@@ -56,6 +367,30 @@ void EventProcessor::Update(uint32 p_time)
             delete Event;
         }
     }
+
+    m_expired.clear();
+}
+
+template<class F>
+void EventProcessor::VisitEvents(F const& func) const
+{
+    for (std::size_t i = 0; i < m_expired.size(); ++i)
+        if (m_expired[i])
+            func(m_expired[i]);
+
+    for (BasicEvent* Event = m_list; Event; Event = Event->m_next)
+        func(Event);
+
+    if (!m_wheel)
+        return;
+
+    for (uint32 level = 0; level < EVENT_WHEEL_LEVELS; ++level)
+        for (uint32 idx = 0; idx < EVENT_WHEEL_SLOTS; ++idx)
+            for (BasicEvent* Event = m_wheel->slots[level][idx]; Event; Event = Event->m_next)
+                func(Event);
+
+    for (BasicEvent* Event = m_wheel->overflow; Event; Event = Event->m_next)
+        func(Event);
 }
 
 void EventProcessor::KillAllEvents(bool force)
@@ -64,25 +399,29 @@ void EventProcessor::KillAllEvents(bool force)
     m_aborting = true;
 
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    EventList events = GetEvents();
+    for (EventList::const_iterator itr = events.begin(); itr != events.end(); ++itr)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        BasicEvent* Event = *itr;
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+        if (force || Event->IsDeletable())
         {
-            delete i_old->second;
+            if (Event->m_prevNext)
+            {
+                TimerWheel::Unlink(Event);
+                --m_count;
+            }
+            else
+                std::replace(m_expired.begin(), m_expired.end(), Event, (BasicEvent*)nullptr);
 
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            delete Event;
         }
     }
 
-    // fast clear event list (in force case)
+    // fast clear expired list (in force case)
     if (force)
-        m_events.clear();
+        m_expired.clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -91,10 +430,38 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Event->m_seq = m_nextSeq++;
+
+    // move list events to wheel, all times up to current time are already collected
+    if (!m_wheel && m_count >= EVENT_LIST_MAX_SIZE)
+    {
+        m_wheel = new TimerWheel;
+        m_wheelTime = m_time + 1;
+
+        BasicEvent* listEvent = m_list;
+        m_list = nullptr;
+        while (listEvent)
+        {
+            BasicEvent* next = listEvent->m_next;
+            listEvent->m_next = nullptr;
+            listEvent->m_prevNext = nullptr;
+            --m_count;
+            ScheduleEvent(listEvent);
+            listEvent = next;
+        }
+    }
+
+    ScheduleEvent(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+EventList EventProcessor::GetEvents() const
+{
+    EventList events;
+    VisitEvents([&events](BasicEvent* Event) { events.push_back(Event); });
+    return events;
+}
@@ -21,16 +21,21 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <cstddef>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
+class EventProcessor;
+
 class BasicEvent
 {
+        friend class EventProcessor;
+
     public:
 
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_addTime(0), m_execTime(0), m_seq(0), m_next(nullptr), m_prevNext(nullptr)
         {
         }
 
@@ -47,16 +52,33 @@ class BasicEvent
 
         virtual void Abort(uint64 /*e_time*/) {}            // this method executes when the event is aborted
 
+        // events are allocated from per thread pools of fixed size blocks
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size);
+
         bool to_Abort;                                      // set by externals when the event is aborted, aborted events don't execute
         // and get Abort call when deleted
 
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+
+    private:
+        uint64 m_seq;                                       // add order, keeps execution order of events with same time
+        BasicEvent* m_next;                                 // intrusive link in event list or timer wheel slot
+        BasicEvent** m_prevNext;
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+typedef std::vector<BasicEvent*> EventList;
 
+/**
+ * Hierarchical timer wheel of events.
+ *
+ * Events are linked into wheel slots by execution time, so adding and unlinking an event is O(1).
+ * Update moves all expired slots into one batch and executes it in time order, events with same
+ * time are executed in add order. Most processors hold only few events, these are kept in small
+ * sorted list and wheel slots are allocated only when list grows over EVENT_LIST_MAX_SIZE events.
+ */
 class EventProcessor
 {
     public:
@@ -68,12 +90,29 @@ class EventProcessor
         void KillAllEvents(bool force);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
+        // copy of all queued events, in no particular order
+        EventList GetEvents() const;
 
     protected:
 
+        struct TimerWheel;
+
+        void ScheduleEvent(BasicEvent* Event);
+        void CascadeSlot(BasicEvent*& slot);
+        void CascadeSlots();
+        uint64 GetNextSlotTime() const;
+        void CollectExpired();
+        void CollectExpiredList();
+        template<class F> void VisitEvents(F const& func) const;
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_wheelTime;                                 // next not yet processed wheel time
+        uint64 m_nextCheckTime;                             // wheel has nothing to expire before this time
+        uint64 m_nextSeq;
+        uint32 m_count;                                     // events linked in list or wheel
+        BasicEvent* m_list;                                 // events sorted by time, used until wheel is allocated
+        TimerWheel* m_wheel;
+        EventList m_expired;                                // expired events waiting for execution
         bool m_aborting;
 };
 
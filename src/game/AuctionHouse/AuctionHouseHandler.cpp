@@ -585,17 +585,6 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
-    std::vector<AuctionEntry*> auctions;
-    auctions.reserve(aucs.size());
-
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = aucs.begin(); itr != aucs.end(); ++itr)
-        auctions.push_back(itr->second);
-
-    AuctionSorter sorter(Sort, GetPlayer());
-    std::sort(auctions.begin(), auctions.end(), sorter);
-
     // remove fake death
     if (GetPlayer()->IsFeigningDeath())
         GetPlayer()->RemoveSpellsCausingAura(SPELL_AURA_FEIGN_DEATH);
@@ -615,8 +604,31 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
 
     wstrToLower(wsearchedname);
 
-    BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
-                          auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, !!isFull);
+    AuctionSearchQuery query;
+    query.locale = GetSessionDbLocaleIndex();
+    memcpy(query.sort, Sort, sizeof(query.sort));
+
+    // full scan lists everything
+    if (isFull)
+    {
+        query.levelMin = query.levelMax = 0x00;
+        query.inventoryType = query.itemClass = query.itemSubClass = query.quality = 0xffffffff;
+    }
+    else
+    {
+        query.name = wsearchedname;
+        query.levelMin = levelmin;
+        query.levelMax = levelmax;
+        query.inventoryType = auctionSlotID;
+        query.itemClass = auctionMainCategory;
+        query.itemSubClass = auctionSubCategory;
+        query.quality = quality;
+    }
+
+    // sorted and filtered by item template
+    AuctionHouseObject::AuctionEntryList const& auctions = auctionHouse->SearchAuctions(query, GetPlayer());
+
+    BuildListAuctionItems(auctions, data, listfrom, usable, count, totalcount, !!isFull);
 
     data.put<uint32>(0, count);
     data << uint32(totalcount);
@@ -38,6 +38,16 @@
 
 INSTANTIATE_SINGLETON_1(AuctionHouseMgr);
 
+// max cached browse query shapes per auction house
+#define AUCTION_SEARCH_CACHE_SIZE 256
+// max auction pointers held by all cached results of auction house, 8 bytes each
+#define AUCTION_SEARCH_CACHE_MAX_ENTRIES 250000
+
+static uint64 GetNameTrigram(std::wstring const& name, size_t pos)
+{
+    return (uint64(name[pos] & 0x1FFFFF) << 42) | (uint64(name[pos + 1] & 0x1FFFFF) << 21) | uint64(name[pos + 2] & 0x1FFFFF);
+}
+
 AuctionHouseMgr::AuctionHouseMgr()
 {
 }
@@ -593,12 +603,265 @@ void AuctionHouseObject::Update()
 
             itr->second->DeleteFromDB();
             sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
+            RemoveFromSearchIndex(itr->second);
             delete itr->second;
             AuctionsMap.erase(itr++);
         }
     }
 }
 
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    RemoveFromSearchIndex(itr->second);
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+void AuctionHouseObject::AddToSearchIndex(AuctionEntry* auction)
+{
+    InvalidateSearchCache();
+
+    uint32 itemTemplate = auction->itemTemplate;
+    AuctionEntrySet& auctions = m_templateAuctions[itemTemplate];
+    auctions.insert(auction);
+    if (auctions.size() > 1)                                // template already indexed
+        return;
+
+    m_templates.insert(itemTemplate);
+
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itemTemplate);
+    if (!proto)
+        return;
+
+    m_classIndex[(proto->Class << 16) | proto->SubClass].insert(itemTemplate);
+    m_qualityIndex[proto->Quality].insert(itemTemplate);
+    m_levelIndex[proto->RequiredLevel].insert(itemTemplate);
+
+    std::wstring& name = m_templateNames[itemTemplate];
+    if (!Utf8toWStr(proto->Name1, name))
+        return;
+
+    wstrToLower(name);
+    for (size_t i = 0; i + 3 <= name.size(); ++i)
+        m_nameTrigramIndex[GetNameTrigram(name, i)].insert(itemTemplate);
+}
+
+void AuctionHouseObject::RemoveFromSearchIndex(AuctionEntry* auction)
+{
+    InvalidateSearchCache();
+
+    uint32 itemTemplate = auction->itemTemplate;
+    std::unordered_map<uint32, AuctionEntrySet>::iterator auctions = m_templateAuctions.find(itemTemplate);
+    if (auctions == m_templateAuctions.end())
+        return;
+
+    auctions->second.erase(auction);
+    if (!auctions->second.empty())                          // other auctions still use template
+        return;
+
+    m_templateAuctions.erase(auctions);
+    m_templates.erase(itemTemplate);
+
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itemTemplate);
+    if (!proto)
+        return;
+
+    ItemTemplateIndex* indexes[] = { &m_classIndex, &m_qualityIndex, &m_levelIndex };
+    uint32 keys[] = { (proto->Class << 16) | proto->SubClass, proto->Quality, proto->RequiredLevel };
+    for (uint32 i = 0; i < countof(indexes); ++i)
+    {
+        ItemTemplateIndex::iterator itr = indexes[i]->find(keys[i]);
+        if (itr == indexes[i]->end())
+            continue;
+
+        itr->second.erase(itemTemplate);
+        if (itr->second.empty())
+            indexes[i]->erase(itr);
+    }
+
+    std::unordered_map<uint32, std::wstring>::iterator name = m_templateNames.find(itemTemplate);
+    if (name == m_templateNames.end())
+        return;
+
+    for (size_t i = 0; i + 3 <= name->second.size(); ++i)
+    {
+        std::unordered_map<uint64, ItemTemplateSet>::iterator itr = m_nameTrigramIndex.find(GetNameTrigram(name->second, i));
+        if (itr == m_nameTrigramIndex.end())
+            continue;
+
+        itr->second.erase(itemTemplate);
+        if (itr->second.empty())
+            m_nameTrigramIndex.erase(itr);
+    }
+
+    m_templateNames.erase(name);
+}
+
+// returns smallest known superset of templates matching query, buffer must be empty and is used for merged sets
+AuctionHouseObject::ItemTemplateSet const& AuctionHouseObject::SelectSearchCandidates(AuctionSearchQuery const& query, ItemTemplateSet& buffer) const
+{
+    // name trigrams are most selective, but known only for default locale names
+    if (query.locale < 0 && query.name.size() >= 3)
+    {
+        std::vector<ItemTemplateSet const*> postings;
+        for (size_t i = 0; i + 3 <= query.name.size(); ++i)
+        {
+            std::unordered_map<uint64, ItemTemplateSet>::const_iterator itr = m_nameTrigramIndex.find(GetNameTrigram(query.name, i));
+            if (itr == m_nameTrigramIndex.end())
+                return buffer;                              // no name contains this trigram
+
+            postings.push_back(&itr->second);
+        }
+
+        std::sort(postings.begin(), postings.end(), [](ItemTemplateSet const * a, ItemTemplateSet const * b) { return a->size() < b->size(); });
+
+        buffer = *postings[0];
+        for (size_t i = 1; i < postings.size() && !buffer.empty(); ++i)
+        {
+            for (ItemTemplateSet::iterator itr = buffer.begin(); itr != buffer.end();)
+            {
+                if (postings[i]->find(*itr) == postings[i]->end())
+                    itr = buffer.erase(itr);
+                else
+                    ++itr;
+            }
+        }
+
+        return buffer;
+    }
+
+    if (query.itemClass != 0xffffffff)
+    {
+        if (query.itemSubClass != 0xffffffff)
+        {
+            ItemTemplateIndex::const_iterator itr = m_classIndex.find((query.itemClass << 16) | query.itemSubClass);
+            return itr != m_classIndex.end() ? itr->second : buffer;
+        }
+
+        for (ItemTemplateIndex::const_iterator itr = m_classIndex.lower_bound(query.itemClass << 16); itr != m_classIndex.end() && (itr->first >> 16) == query.itemClass; ++itr)
+            buffer.insert(itr->second.begin(), itr->second.end());
+
+        return buffer;
+    }
+
+    if (query.levelMin != 0x00)
+    {
+        ItemTemplateIndex::const_iterator end = query.levelMax != 0x00 ? m_levelIndex.upper_bound(query.levelMax) : m_levelIndex.end();
+        for (ItemTemplateIndex::const_iterator itr = m_levelIndex.lower_bound(query.levelMin); itr != end; ++itr)
+            buffer.insert(itr->second.begin(), itr->second.end());
+
+        return buffer;
+    }
+
+    if (query.quality != 0xffffffff)
+    {
+        for (ItemTemplateIndex::const_iterator itr = m_qualityIndex.lower_bound(query.quality); itr != m_qualityIndex.end(); ++itr)
+            buffer.insert(itr->second.begin(), itr->second.end());
+
+        return buffer;
+    }
+
+    return m_templates;
+}
+
+bool AuctionHouseObject::IsMatchingTemplate(uint32 itemTemplate, AuctionSearchQuery const& query) const
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itemTemplate);
+    if (!proto)
+        return false;
+
+    if (query.itemClass != 0xffffffff && proto->Class != query.itemClass)
+        return false;
+
+    if (query.itemSubClass != 0xffffffff && proto->SubClass != query.itemSubClass)
+        return false;
+
+    if (query.inventoryType != 0xffffffff && proto->InventoryType != query.inventoryType)
+        return false;
+
+    if (query.quality != 0xffffffff && proto->Quality < query.quality)
+        return false;
+
+    if (query.levelMin != 0x00 && (proto->RequiredLevel < query.levelMin || (query.levelMax != 0x00 && proto->RequiredLevel > query.levelMax)))
+        return false;
+
+    if (query.name.empty())
+        return true;
+
+    if (query.locale < 0)
+    {
+        std::unordered_map<uint32, std::wstring>::const_iterator name = m_templateNames.find(itemTemplate);
+        return name != m_templateNames.end() && name->second.find(query.name) != std::wstring::npos;
+    }
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, query.locale, &name);
+    return Utf8FitTo(name, query.name);
+}
+
+AuctionHouseObject::AuctionEntryList const& AuctionHouseObject::SearchAuctions(AuctionSearchQuery const& query, Player* viewPlayer)
+{
+    std::map<AuctionSearchQuery, SearchResult>::iterator cached = m_searchCache.find(query);
+    if (cached != m_searchCache.end() && cached->second.generation == m_searchGeneration)
+        return cached->second.auctions;
+
+    if (cached == m_searchCache.end())
+    {
+        if (m_searchCache.size() >= AUCTION_SEARCH_CACHE_SIZE)
+        {
+            m_searchCache.clear();
+            m_searchCacheEntries = 0;
+        }
+
+        cached = m_searchCache.insert(std::make_pair(query, SearchResult())).first;
+    }
+
+    SearchResult& result = cached->second;
+    result.generation = m_searchGeneration;
+    m_searchCacheEntries -= result.auctions.capacity();
+    result.auctions.clear();
+
+    ItemTemplateSet buffer;
+    ItemTemplateSet const& candidates = SelectSearchCandidates(query, buffer);
+    for (ItemTemplateSet::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+    {
+        if (!IsMatchingTemplate(*itr, query))
+            continue;
+
+        std::unordered_map<uint32, AuctionEntrySet>::const_iterator auctions = m_templateAuctions.find(*itr);
+        if (auctions != m_templateAuctions.end())
+            result.auctions.insert(result.auctions.end(), auctions->second.begin(), auctions->second.end());
+    }
+
+    // id order for auctions equal by all sort columns, as in auction map
+    std::sort(result.auctions.begin(), result.auctions.end(), [](AuctionEntry const * a, AuctionEntry const * b) { return a->Id < b->Id; });
+    std::stable_sort(result.auctions.begin(), result.auctions.end(), AuctionSorter(query.sort, viewPlayer));
+
+    // drop other results when cache holds too many entries, returned result must stay valid
+    m_searchCacheEntries += result.auctions.capacity();
+    if (m_searchCacheEntries > AUCTION_SEARCH_CACHE_MAX_ENTRIES)
+    {
+        DEBUG_LOG("AuctionHouse: search cache over %u entries, dropping %u cached results", AUCTION_SEARCH_CACHE_MAX_ENTRIES, uint32(m_searchCache.size() - 1));
+        for (std::map<AuctionSearchQuery, SearchResult>::iterator itr = m_searchCache.begin(); itr != m_searchCache.end();)
+        {
+            if (itr == cached)
+            {
+                ++itr;
+                continue;
+            }
+
+            m_searchCacheEntries -= itr->second.auctions.capacity();
+            itr = m_searchCache.erase(itr);
+        }
+    }
+
+    return result.auctions;
+}
+
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
 {
     for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
@@ -760,6 +1023,27 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
     return 0;
 }
 
+bool AuctionSearchQuery::operator<(AuctionSearchQuery const& other) const
+{
+    if (levelMin != other.levelMin)
+        return levelMin < other.levelMin;
+    if (levelMax != other.levelMax)
+        return levelMax < other.levelMax;
+    if (inventoryType != other.inventoryType)
+        return inventoryType < other.inventoryType;
+    if (itemClass != other.itemClass)
+        return itemClass < other.itemClass;
+    if (itemSubClass != other.itemSubClass)
+        return itemSubClass < other.itemSubClass;
+    if (quality != other.quality)
+        return quality < other.quality;
+    if (locale != other.locale)
+        return locale < other.locale;
+    if (int diff = memcmp(sort, other.sort, sizeof(sort)))
+        return diff < 0;
+    return name < other.name;
+}
+
 bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const
 {
     if (m_sort[0] == MAX_AUCTION_SORT)                      // not sorted
@@ -781,11 +1065,9 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
     return false;                                           // "equal" by all sorts
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
-        uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const
+void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, uint32 listfrom, uint32 usable,
+        uint32& count, uint32& totalcount, bool isFull) const
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
-
     for (std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
     {
         AuctionEntry* Aentry = *itr;
@@ -800,28 +1082,13 @@ void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& aucti
         }
         else
         {
-            ItemPrototype const* proto = item->GetProto();
-
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
-
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
-
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
-
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
-
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
-
+            // item template filters are already applied by AuctionHouseObject::SearchAuctions
             if (usable != 0x00)
             {
                 if (_player->CanUseItem(item) != EQUIP_ERR_OK)
                     continue;
 
+                ItemPrototype const* proto = item->GetProto();
                 if (proto->Class == ITEM_CLASS_RECIPE)
                 {
                     if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
@@ -832,12 +1099,6 @@ void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& aucti
                 }
             }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
-
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
-
             if (count < 50 && totalcount >= listfrom)
             {
                 ++count;
@@ -935,9 +1196,9 @@ uint32 AuctionEntry::GetAuctionCut() const
 }
 
 /// the sum of outbid is (1% from current bid)*5, if bid is very small, it is 1c
-uint32 AuctionEntry::GetAuctionOutBid() const
+uint32 AuctionEntry::GetAuctionOutBid(uint32 currentBid)
 {
-    uint32 outbid = (bid / 100) * 5;
+    uint32 outbid = (currentBid / 100) * 5;
     if (!outbid)
         outbid = 1;
     return outbid;
@@ -998,6 +1259,7 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=nullptr*/)
 
     bidder = newbidder ? newbidder->GetGUIDLow() : 0;
     bid = newbid;
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->InvalidateSearchCache();
 
     if ((newbid < buyout) || (buyout == 0))                 // bid
     {
@@ -72,7 +72,8 @@ struct AuctionEntry
     uint32 GetHouseId() const { return auctionHouseEntry->houseId; }
     uint32 GetHouseFaction() const { return auctionHouseEntry->faction; }
     uint32 GetAuctionCut() const;
-    uint32 GetAuctionOutBid() const;
+    uint32 GetAuctionOutBid() const { return GetAuctionOutBid(bid); }
+    static uint32 GetAuctionOutBid(uint32 currentBid);     // minimal outbid of current bid
     bool BuildAuctionInfo(WorldPacket& data) const;
     void DeleteFromDB() const;
     void SaveToDB() const;
@@ -84,11 +85,27 @@ struct AuctionEntry
     bool UpdateBid(uint32 newbid, Player* newbidder = nullptr);// true if normal bid, false if buyout, bidder==nullptr for generated bid
 };
 
+// browse query filters, 0xffffffff (levels: 0) mean not filtered
+struct AuctionSearchQuery
+{
+    std::wstring name;                                      // lower case
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;
+    int32 locale;                                           // name filter and sort locale
+    uint8 sort[MAX_AUCTION_SORT];
+
+    bool operator<(AuctionSearchQuery const& other) const;
+};
+
 // this class is used as auctionhouse instance
 class AuctionHouseObject
 {
     public:
-        AuctionHouseObject() {}
+        AuctionHouseObject() : m_searchGeneration(0), m_searchCacheEntries(0) {}
         ~AuctionHouseObject()
         {
             for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
@@ -97,6 +114,7 @@ class AuctionHouseObject
 
         typedef std::map<uint32, AuctionEntry*> AuctionEntryMap;
         typedef std::pair<AuctionEntryMap::const_iterator, AuctionEntryMap::const_iterator> AuctionEntryMapBounds;
+        typedef std::vector<AuctionEntry*> AuctionEntryList;
 
         uint32 GetCount() const { return AuctionsMap.size(); }
 
@@ -107,6 +125,7 @@ class AuctionHouseObject
         {
             MANGOS_ASSERT(ah);
             AuctionsMap[ah->Id] = ah;
+            AddToSearchIndex(ah);
         }
 
         AuctionEntry* GetAuction(uint32 id) const
@@ -115,27 +134,61 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : nullptr;
         }
 
-        bool RemoveAuction(uint32 id) { return !!AuctionsMap.erase(id); }
+        bool RemoveAuction(uint32 id);
 
         void Update();
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
         void BuildListOwnerItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
 
+        // Sorted auctions matching item based filters of query, result is cached until next auction change
+        // cache is limited to AUCTION_SEARCH_CACHE_SIZE queries and AUCTION_SEARCH_CACHE_MAX_ENTRIES auctions in all results
+        AuctionEntryList const& SearchAuctions(AuctionSearchQuery const& query, Player* viewPlayer);
+        // Must be called when auction data used in sorting is changed
+        void InvalidateSearchCache() { ++m_searchGeneration; }
+
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
     private:
+        typedef std::set<AuctionEntry*> AuctionEntrySet;
+        typedef std::set<uint32> ItemTemplateSet;
+        typedef std::map<uint32, ItemTemplateSet> ItemTemplateIndex;
+
+        struct SearchResult
+        {
+            uint32 generation;
+            AuctionEntryList auctions;
+        };
+
+        void AddToSearchIndex(AuctionEntry* auction);
+        void RemoveFromSearchIndex(AuctionEntry* auction);
+        ItemTemplateSet const& SelectSearchCandidates(AuctionSearchQuery const& query, ItemTemplateSet& buffer) const;
+        bool IsMatchingTemplate(uint32 itemTemplate, AuctionSearchQuery const& query) const;
+
         AuctionEntryMap AuctionsMap;
+
+        // search indexes are kept by item template, auctions of same template share all searched properties
+        std::unordered_map<uint32, AuctionEntrySet> m_templateAuctions;
+        std::unordered_map<uint32, std::wstring> m_templateNames;   // lower case default locale names
+        ItemTemplateSet m_templates;
+        ItemTemplateIndex m_classIndex;                     // class << 16 | subclass
+        ItemTemplateIndex m_qualityIndex;
+        ItemTemplateIndex m_levelIndex;                     // required level
+        std::unordered_map<uint64, ItemTemplateSet> m_nameTrigramIndex;
+
+        std::map<AuctionSearchQuery, SearchResult> m_searchCache;
+        uint32 m_searchGeneration;
+        size_t m_searchCacheEntries;                        // allocated auction slots of all cached results
 };
 
 class AuctionSorter
 {
     public:
         AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer) {}
-        AuctionSorter(uint8* sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
+        AuctionSorter(uint8 const* sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
         bool operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const;
 
     private:
-        uint8* m_sort;
+        uint8 const* m_sort;
         Player* m_viewPlayer;
 };
 
@@ -24,6 +24,12 @@
 #include "SystemConfig.h"
 #include "Server/SQLStorages.h"
 #include "World/World.h"
+#include "Threading.h"
+#include "Timer.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 // Format is YYYYMMDDRR where RR is the change in the conf file
 // for that day.
@@ -31,6 +37,110 @@
 
 #include "Policies/Singleton.h"
 
+// Auction data copied at world thread, planner thread must not access live auctions
+struct AuctionBotAuctionInfo
+{
+    uint32 Id;
+    uint32 ItemEntry;
+    uint32 ItemCount;
+    uint32 Owner;
+    uint32 Bidder;
+    uint32 Bid;
+    uint32 StartBid;
+    uint32 Buyout;
+};
+
+struct AuctionBotSnapshot
+{
+    AuctionBotSnapshot() : HouseType(AUCTION_HOUSE_NEUTRAL) {}
+
+    AuctionBotAuctionInfo const* FindAuction(uint32 auctionId) const
+    {
+        std::vector<AuctionBotAuctionInfo>::const_iterator itr = std::lower_bound(Auctions.begin(), Auctions.end(), auctionId,
+                [](AuctionBotAuctionInfo const & info, uint32 id) { return info.Id < id; });
+        return itr != Auctions.end() && itr->Id == auctionId ? &*itr : nullptr;
+    }
+
+    AuctionHouseType HouseType;
+    std::vector<AuctionBotAuctionInfo> Auctions;            // auctions with accessible item, ordered by id
+};
+
+enum AuctionBotActionType
+{
+    AHBOT_ACTION_SELL,
+    AHBOT_ACTION_BID,
+    AHBOT_ACTION_BUY,
+};
+
+struct AuctionBotAction
+{
+    AuctionBotAction(AuctionBotActionType type, AuctionHouseType houseType) : Type(type), HouseType(houseType),
+        AuctionId(0), ExpectedBid(0), ItemEntry(0), ItemCount(0), BidPrice(0), BuyoutPrice(0), Duration(0) {}
+
+    AuctionBotActionType Type;
+    AuctionHouseType HouseType;
+    uint32 AuctionId;                                       // bid and buy
+    uint32 ExpectedBid;                                     // bid and buy, action dropped if auction bid changed since planning
+    uint32 ItemEntry;                                       // sell
+    uint32 ItemCount;                                       // sell
+    uint32 BidPrice;
+    uint32 BuyoutPrice;                                     // sell
+    uint32 Duration;                                        // sell
+};
+
+// Runs agents planning out of world thread, one snapshot at a time
+class AuctionBotPlanner : public MaNGOS::Runnable
+{
+    public:
+        AuctionBotPlanner() : m_agent(nullptr), m_running(true) {}
+
+        void run() override;
+        void Stop();
+
+        // world thread only functions below
+        bool IsPlanning();
+        void Schedule(AuctionBotAgent* agent, AuctionBotSnapshot& snapshot);
+        void Wait();
+        bool PopAction(AuctionBotAction& action);
+        bool HasActions();
+        void ClearActions();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        AuctionBotAgent* m_agent;                           // set while planning is scheduled or running
+        AuctionBotSnapshot m_snapshot;
+        AuctionBotActionList m_planned;                     // guarded by m_mutex
+        std::deque<AuctionBotAction> m_pending;             // world thread only
+        bool m_running;
+};
+
+static void FillAuctionSnapshot(AuctionHouseType houseType, AuctionBotSnapshot& snapshot)
+{
+    snapshot.HouseType = houseType;
+    snapshot.Auctions.clear();
+
+    AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(houseType)->GetAuctionsBounds();
+    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+    {
+        AuctionEntry* Aentry = itr->second;
+        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+        if (!item || !item->GetProto())
+            continue;
+
+        AuctionBotAuctionInfo info;
+        info.Id = Aentry->Id;
+        info.ItemEntry = item->GetEntry();
+        info.ItemCount = item->GetCount();
+        info.Owner = Aentry->owner;
+        info.Bidder = Aentry->bidder;
+        info.Bid = Aentry->bid;
+        info.StartBid = Aentry->startbid;
+        info.Buyout = Aentry->buyout;
+        snapshot.Auctions.push_back(info);
+    }
+}
+
 struct BuyerAuctionEval
 {
     BuyerAuctionEval() : AuctionId(0), LastChecked(0), LastExist(0) {}
@@ -175,10 +285,11 @@ class AuctionBotBuyer : public AuctionBotAgent
         ~AuctionBotBuyer();
 
         bool        Initialize() override;
-        bool        Update(AuctionHouseType houseType) override;
+        bool        PrepareSnapshot(AuctionHouseType houseType, AuctionBotSnapshot& snapshot) const override;
+        void        Plan(AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions) override;
 
         void        LoadConfig();
-        void        addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const;
+        void        addNewAuctionBuyerBotBid(AHB_Buyer_Config& config, AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions) const;
 
     private:
         uint32              m_CheckInterval;
@@ -187,10 +298,10 @@ class AuctionBotBuyer : public AuctionBotAgent
         void        LoadBuyerValues(AHB_Buyer_Config& config) const;
         bool        IsBuyableEntry(uint32 buyoutPrice, double InGame_BuyPrice, double MaxBuyablePrice, uint32 MinBuyPrice, uint32 MaxChance, uint32 ChanceRatio) const;
         bool        IsBidableEntry(uint32 bidPrice, double InGame_BuyPrice, double MaxBidablePrice, uint32 MinBidPrice, uint32 MaxChance, uint32 ChanceRatio) const;
-        void        PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice) const;
-        void        BuyEntry(AuctionEntry* auction) const;
+        void        PlaceBidToEntry(AHB_Buyer_Config const& config, AuctionBotAuctionInfo const& auction, uint32 bidPrice, AuctionBotActionList& actions) const;
+        void        BuyEntry(AHB_Buyer_Config const& config, AuctionBotAuctionInfo const& auction, AuctionBotActionList& actions) const;
         void        PrepareListOfEntry(AHB_Buyer_Config& config) const;
-        uint32      GetBuyableEntry(AHB_Buyer_Config& config) const;
+        uint32      GetBuyableEntry(AHB_Buyer_Config& config, AuctionBotSnapshot const& snapshot) const;
 };
 
 // This class handle all Selling method
@@ -204,9 +315,10 @@ class AuctionBotSeller : public AuctionBotAgent
         ~AuctionBotSeller();
 
         bool Initialize() override;
-        bool Update(AuctionHouseType houseType) override;
+        bool PrepareSnapshot(AuctionHouseType houseType, AuctionBotSnapshot& snapshot) const override;
+        void Plan(AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions) override;
 
-        void addNewAuctions(AHB_Seller_Config& config);
+        void addNewAuctions(AHB_Seller_Config& config, AuctionBotActionList& actions);
         void SetItemsRatio(uint32 al, uint32 ho, uint32 ne);
         void SetItemsRatioForHouse(AuctionHouseType house, uint32 val);
         void SetItemsAmount(uint32(&vals)[MAX_AUCTION_QUALITY]);
@@ -219,7 +331,7 @@ class AuctionBotSeller : public AuctionBotAgent
         ItemPool m_ItemPool[MAX_AUCTION_QUALITY][MAX_ITEM_CLASS];
 
         void        LoadSellerValues(AHB_Seller_Config& config) const;
-        uint32      SetStat(AHB_Seller_Config& config) const;
+        uint32      SetStat(AHB_Seller_Config& config, AuctionBotSnapshot const& snapshot) const;
         bool        getRandomArray(AHB_Seller_Config& config, RandomArray& ra, const std::vector<std::vector<uint32> >& addedItem) const;
         void        SetPricesOfItem(AHB_Seller_Config& config, uint32& buyp, uint32& bidp, ItemQualities itemQuality);
         void        LoadItemsQuantity(AHB_Seller_Config& config) const;
@@ -345,6 +457,7 @@ void AuctionBotConfig::GetConfigFromFile()
 
     setConfig(CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_BOOST      , "AuctionHouseBot.ItemsPerCycle.Boost"         , 75);
     setConfig(CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_NORMAL     , "AuctionHouseBot.ItemsPerCycle.Normal"        , 20);
+    setConfig(CONFIG_UINT32_AHBOT_ACTIONS_TIME_BUDGET        , "AuctionHouseBot.ActionsTimeBudget"           , 2);
 
     setConfig(CONFIG_UINT32_AHBOT_ITEM_MIN_ITEM_LEVEL        , "AuctionHouseBot.Items.ItemLevel.Min"         , 0);
     setConfig(CONFIG_UINT32_AHBOT_ITEM_MAX_ITEM_LEVEL        , "AuctionHouseBot.Items.ItemLevel.Max"         , 0);
@@ -527,66 +640,58 @@ void AuctionBotBuyer::LoadConfig()
     }
 }
 
-uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
+uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config, AuctionBotSnapshot const& snapshot) const
 {
     config.SameItemInfo.clear();
     uint32 count = 0;
     time_t Now = time(nullptr);
 
-    AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(config.GetHouseType())->GetAuctionsBounds();
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+    for (std::vector<AuctionBotAuctionInfo>::const_iterator itr = snapshot.Auctions.begin(); itr != snapshot.Auctions.end(); ++itr)
     {
-        AuctionEntry* Aentry = itr->second;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (item)
+        AuctionBotAuctionInfo const& Aentry = *itr;
+
+        BuyerItemInfo& buyerItem = config.SameItemInfo[Aentry.ItemEntry];    // Structure constructor will make sure Element are correctly initialised if entry is created here.
+        ++buyerItem.ItemCount;
+        buyerItem.BuyPrice = buyerItem.BuyPrice + (double(Aentry.Buyout) / Aentry.ItemCount);
+        buyerItem.BidPrice = buyerItem.BidPrice + (double(Aentry.StartBid) / Aentry.ItemCount);
+        if (Aentry.Buyout != 0)
         {
-            ItemPrototype const* prototype = item->GetProto();
-            if (prototype)
-            {
-                BuyerItemInfo& buyerItem = config.SameItemInfo[item->GetEntry()];    // Structure constructor will make sure Element are correctly initialised if entry is created here.
-                ++buyerItem.ItemCount;
-                buyerItem.BuyPrice = buyerItem.BuyPrice + (double(Aentry->buyout) / item->GetCount());
-                buyerItem.BidPrice = buyerItem.BidPrice + (double(Aentry->startbid) / item->GetCount());
-                if (Aentry->buyout != 0)
-                {
-                    if (Aentry->buyout / item->GetCount() < buyerItem.MinBuyPrice)
-                        buyerItem.MinBuyPrice = Aentry->buyout / item->GetCount();
-                    else if (buyerItem.MinBuyPrice == 0)
-                        buyerItem.MinBuyPrice = Aentry->buyout / item->GetCount();
-                }
-                if (Aentry->startbid / item->GetCount() < buyerItem.MinBidPrice)
-                    buyerItem.MinBidPrice = Aentry->startbid / item->GetCount();
-                else if (buyerItem.MinBidPrice == 0)
-                    buyerItem.MinBidPrice = Aentry->startbid / item->GetCount();
+            if (Aentry.Buyout / Aentry.ItemCount < buyerItem.MinBuyPrice)
+                buyerItem.MinBuyPrice = Aentry.Buyout / Aentry.ItemCount;
+            else if (buyerItem.MinBuyPrice == 0)
+                buyerItem.MinBuyPrice = Aentry.Buyout / Aentry.ItemCount;
+        }
+        if (Aentry.StartBid / Aentry.ItemCount < buyerItem.MinBidPrice)
+            buyerItem.MinBidPrice = Aentry.StartBid / Aentry.ItemCount;
+        else if (buyerItem.MinBidPrice == 0)
+            buyerItem.MinBidPrice = Aentry.StartBid / Aentry.ItemCount;
 
-                if (!Aentry->owner)
-                {
-                    if ((Aentry->bid != 0) && Aentry->bidder) // Add bided by player
-                    {
-                        config.CheckedEntry[Aentry->Id].LastExist = Now;
-                        config.CheckedEntry[Aentry->Id].AuctionId = Aentry->Id;
-                        ++count;
-                    }
-                }
-                else
+        if (!Aentry.Owner)
+        {
+            if ((Aentry.Bid != 0) && Aentry.Bidder) // Add bided by player
+            {
+                config.CheckedEntry[Aentry.Id].LastExist = Now;
+                config.CheckedEntry[Aentry.Id].AuctionId = Aentry.Id;
+                ++count;
+            }
+        }
+        else
+        {
+            if (Aentry.Bid != 0)
+            {
+                if (Aentry.Bidder)
                 {
-                    if (Aentry->bid != 0)
-                    {
-                        if (Aentry->bidder)
-                        {
-                            config.CheckedEntry[Aentry->Id].LastExist = Now;
-                            config.CheckedEntry[Aentry->Id].AuctionId = Aentry->Id;
-                            ++count;
-                        }
-                    }
-                    else
-                    {
-                        config.CheckedEntry[Aentry->Id].LastExist = Now;
-                        config.CheckedEntry[Aentry->Id].AuctionId = Aentry->Id;
-                        ++count;
-                    }
+                    config.CheckedEntry[Aentry.Id].LastExist = Now;
+                    config.CheckedEntry[Aentry.Id].AuctionId = Aentry.Id;
+                    ++count;
                 }
             }
+            else
+            {
+                config.CheckedEntry[Aentry.Id].LastExist = Now;
+                config.CheckedEntry[Aentry.Id].AuctionId = Aentry.Id;
+                ++count;
+            }
         }
     }
 
@@ -713,22 +818,30 @@ bool AuctionBotBuyer::IsBidableEntry(uint32 bidPrice, double InGame_BuyPrice, do
     }
 }
 
-void AuctionBotBuyer::PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice) const
+void AuctionBotBuyer::PlaceBidToEntry(AHB_Buyer_Config const& config, AuctionBotAuctionInfo const& auction, uint32 bidPrice, AuctionBotActionList& actions) const
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Bid placed to entry %u, %.2fg", auction->Id, float(bidPrice) / 10000.0f);
-    auction->UpdateBid(bidPrice);
+    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Bid placed to entry %u, %.2fg", auction.Id, float(bidPrice) / 10000.0f);
+
+    AuctionBotAction action(AHBOT_ACTION_BID, config.GetHouseType());
+    action.AuctionId = auction.Id;
+    action.ExpectedBid = auction.Bid;
+    action.BidPrice = bidPrice;
+    actions.push_back(action);
 }
 
-void AuctionBotBuyer::BuyEntry(AuctionEntry* auction) const
+void AuctionBotBuyer::BuyEntry(AHB_Buyer_Config const& config, AuctionBotAuctionInfo const& auction, AuctionBotActionList& actions) const
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u buyed at %.2fg", auction->Id, float(auction->buyout) / 10000.0f);
-    auction->UpdateBid(auction->buyout);
+    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u buyed at %.2fg", auction.Id, float(auction.Buyout) / 10000.0f);
+
+    AuctionBotAction action(AHBOT_ACTION_BUY, config.GetHouseType());
+    action.AuctionId = auction.Id;
+    action.ExpectedBid = auction.Bid;
+    action.BidPrice = auction.Buyout;
+    actions.push_back(action);
 }
 
-void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
+void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config, AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions) const
 {
-    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(config.GetHouseType());
-
     PrepareListOfEntry(config);
 
     time_t Now = time(nullptr);
@@ -744,7 +857,7 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
     for (CheckEntryMap::iterator itr = config.CheckedEntry.begin(); itr != config.CheckedEntry.end();)
     {
         BuyerAuctionEval& auctionEval = itr->second;
-        AuctionEntry* auction = auctionHouse->GetAuction(auctionEval.AuctionId);
+        AuctionBotAuctionInfo const* auction = snapshot.FindAuction(auctionEval.AuctionId);
         if (!auction)                                       // is auction not active now
         {
             DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u on ah doesn't exists, perhaps bought already?",
@@ -766,32 +879,26 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
 
         uint32 MaxChance = 5000;
 
-        Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
-        if (!item)                                          // auction item not accessible, possible auction in payment pending mode
-        {
-            config.CheckedEntry.erase(itr++);
-            continue;
-        }
-
-        ItemPrototype const* prototype = item->GetProto();
+        // snapshot contains only auctions with accessible item
+        ItemPrototype const* prototype = sObjectMgr.GetItemPrototype(auction->ItemEntry);
 
         uint32 BasePrice = sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_BUYPRICE_BUYER) ? prototype->BuyPrice : prototype->SellPrice;
-        BasePrice *= item->GetCount();
+        BasePrice *= auction->ItemCount;
 
         double MaxBuyablePrice = (double(BasePrice) * config.BuyerPriceRatio) / 100;
-        uint32 buyoutPrice = auction->buyout / item->GetCount();
+        uint32 buyoutPrice = auction->Buyout / auction->ItemCount;
         uint32 bidPrice;
         uint32 bidPriceByItem;
 
-        if (auction->bid >= auction->startbid)
+        if (auction->Bid >= auction->StartBid)
         {
-            bidPrice = auction->GetAuctionOutBid();
-            bidPriceByItem = auction->bid / item->GetCount();
+            bidPrice = AuctionEntry::GetAuctionOutBid(auction->Bid);
+            bidPriceByItem = auction->Bid / auction->ItemCount;
         }
         else
         {
-            bidPrice = auction->startbid;
-            bidPriceByItem = auction->startbid / item->GetCount();
+            bidPrice = auction->StartBid;
+            bidPriceByItem = auction->StartBid / auction->ItemCount;
         }
 
         double InGame_BuyPrice;
@@ -799,7 +906,7 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
         uint32 minBidPrice;
         uint32 minBuyPrice;
 
-        BuyerItemInfoMap::iterator sameitem_itr = config.SameItemInfo.find(item->GetEntry());
+        BuyerItemInfoMap::iterator sameitem_itr = config.SameItemInfo.find(auction->ItemEntry);
         if (sameitem_itr == config.SameItemInfo.end())
         {
             InGame_BuyPrice = 0;
@@ -829,28 +936,28 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
                          minBuyPrice / 10000, minBidPrice / 10000);
         DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Actual Entry price,  Buy=%ug, Bid=%ug.", buyoutPrice / 10000, bidPrice / 10000);
 
-        if (!auction->owner)                // Original auction owner
+        if (!auction->Owner)                // Original auction owner
         {
             MaxChance = MaxChance / 5;      // if Owner is AHBot this mean player placed bid on this auction. We divide by 5 chance for AhBuyer to place bid on it. (This make more challenge than ignore entry)
         }
-        if (auction->buyout != 0)           // Is the item directly buyable?
+        if (auction->Buyout != 0)           // Is the item directly buyable?
         {
             if (IsBuyableEntry(buyoutPrice, InGame_BuyPrice, MaxBuyablePrice, minBuyPrice, MaxChance, config.FactionChance))
             {
                 if (IsBidableEntry(bidPriceByItem, InGame_BuyPrice, MaxBidablePrice, minBidPrice, MaxChance / 2, config.FactionChance))
-                        if (urand(0, 5) == 0) PlaceBidToEntry(auction, bidPrice); else BuyEntry(auction);
+                        if (urand(0, 5) == 0) PlaceBidToEntry(config, *auction, bidPrice, actions); else BuyEntry(config, *auction, actions);
                 else
-                    BuyEntry(auction);
+                    BuyEntry(config, *auction, actions);
             }
             else
             {
                 if (IsBidableEntry(bidPriceByItem, InGame_BuyPrice, MaxBidablePrice, minBidPrice, MaxChance / 2, config.FactionChance))
-                    PlaceBidToEntry(auction, bidPrice);
+                    PlaceBidToEntry(config, *auction, bidPrice, actions);
             }
         }
         else // buyout = 0 mean only bid are possible
             if (IsBidableEntry(bidPriceByItem, InGame_BuyPrice, MaxBidablePrice, minBidPrice, MaxChance, config.FactionChance))
-                PlaceBidToEntry(auction, bidPrice);
+                PlaceBidToEntry(config, *auction, bidPrice, actions);
 
         auctionEval.LastChecked = Now;
         --BuyCycles;
@@ -859,18 +966,24 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
     }
 }
 
-bool AuctionBotBuyer::Update(AuctionHouseType houseType)
+bool AuctionBotBuyer::PrepareSnapshot(AuctionHouseType houseType, AuctionBotSnapshot& snapshot) const
 {
     if (sAuctionBotConfig.getConfigBuyerEnabled(houseType))
     {
         DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: %s buying ...", AuctionBotConfig::GetHouseTypeName(houseType));
-        if (GetBuyableEntry(m_HouseConfig[houseType]) > 0)
-            addNewAuctionBuyerBotBid(m_HouseConfig[houseType]);
+        FillAuctionSnapshot(houseType, snapshot);
         return true;
     }
     else return false;
 }
 
+void AuctionBotBuyer::Plan(AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions)
+{
+    AHB_Buyer_Config& config = m_HouseConfig[snapshot.HouseType];
+    if (GetBuyableEntry(config, snapshot) > 0)
+        addNewAuctionBuyerBotBid(config, snapshot, actions);
+}
+
 //== AuctionBotSeller functions ============================
 
 AuctionBotSeller::AuctionBotSeller()
@@ -1400,25 +1513,16 @@ void AuctionBotSeller::LoadSellerValues(AHB_Seller_Config& config) const
 
 // Set static of items on one AH faction.
 // Fill ItemInfos object with real content of AH.
-uint32 AuctionBotSeller::SetStat(AHB_Seller_Config& config) const
+uint32 AuctionBotSeller::SetStat(AHB_Seller_Config& config, AuctionBotSnapshot const& snapshot) const
 {
     std::vector<std::vector<uint32> > ItemsInAH(MAX_AUCTION_QUALITY, std::vector< uint32 > (MAX_ITEM_CLASS));
 
-    AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(config.GetHouseType())->GetAuctionsBounds();
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+    for (std::vector<AuctionBotAuctionInfo>::const_iterator itr = snapshot.Auctions.begin(); itr != snapshot.Auctions.end(); ++itr)
     {
-        AuctionEntry* Aentry = itr->second;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (item)
+        if (!itr->Owner)                                    // Add only ahbot items
         {
-            ItemPrototype const* prototype = item->GetProto();
-            if (prototype)
-            {
-                if (!Aentry->owner)                         // Add only ahbot items
-                {
-                    ++ItemsInAH[prototype->Quality][prototype->Class];
-                }
-            }
+            ItemPrototype const* prototype = sObjectMgr.GetItemPrototype(itr->ItemEntry);
+            ++ItemsInAH[prototype->Quality][prototype->Class];
         }
     }
     uint32 count = 0;
@@ -1539,7 +1643,7 @@ void AuctionBotSeller::SetItemsAmountForQuality(AuctionQuality quality, uint32 v
 
 // Add new auction to one of the factions.
 // Faction and setting assossiated is defined passed argument ( config )
-void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
+void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config, AuctionBotActionList& actions)
 {
     uint32 items;
 
@@ -1551,18 +1655,6 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
     }
     else items = sAuctionBotConfig.GetItemPerCycleNormal();
 
-    uint32 houseid;
-    switch (config.GetHouseType())
-    {
-        case AUCTION_HOUSE_ALLIANCE: houseid =  1; break;
-        case AUCTION_HOUSE_HORDE:    houseid =  6; break;
-        default:                     houseid =  7; break;
-    }
-
-    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(houseid);
-
-    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(config.GetHouseType());
-
     RandomArray randArray;
     std::vector<std::vector<uint32> > ItemsAdded(MAX_AUCTION_QUALITY, std::vector<uint32> (MAX_ITEM_CLASS));
     // Main loop
@@ -1593,57 +1685,168 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
 
         uint32 stackCount = urand(1, prototype->GetMaxStackSize());
 
-
-        Item* item = Item::CreateItem(itemID, stackCount);
-        if (!item)
-        {
-            sLog.outError("AHBot: Item::CreateItem() returned nullptr for item %u (stack: %u)", itemID, stackCount);
-            return;
-        }
-
         uint32 buyoutPrice;
         uint32 bidPrice = 0;
 
         // Not sure if i will keep the next test
         if (sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_BUYPRICE_SELLER))
-            buyoutPrice  = prototype->BuyPrice * item->GetCount();
+            buyoutPrice  = prototype->BuyPrice * stackCount;
         else
-            buyoutPrice  = prototype->SellPrice * item->GetCount();
+            buyoutPrice  = prototype->SellPrice * stackCount;
 
         // Price of items are set here
         SetPricesOfItem(config, buyoutPrice, bidPrice, ItemQualities(prototype->Quality));
 
-        auctionHouse->AddAuction(ahEntry, item, urand(config.GetMinTime(), config.GetMaxTime()) * HOUR, bidPrice, buyoutPrice);
+        // item itself is created when action is applied at world thread
+        AuctionBotAction action(AHBOT_ACTION_SELL, config.GetHouseType());
+        action.ItemEntry = itemID;
+        action.ItemCount = stackCount;
+        action.BidPrice = bidPrice;
+        action.BuyoutPrice = buyoutPrice;
+        action.Duration = urand(config.GetMinTime(), config.GetMaxTime()) * HOUR;
+        actions.push_back(action);
     }
 }
 
-bool AuctionBotSeller::Update(AuctionHouseType houseType)
+bool AuctionBotSeller::PrepareSnapshot(AuctionHouseType houseType, AuctionBotSnapshot& snapshot) const
 {
     if (sAuctionBotConfig.getConfigItemAmountRatio(houseType) > 0)
     {
         DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_SELLER, "AHBot: %s selling ...", AuctionBotConfig::GetHouseTypeName(houseType));
-        if (SetStat(m_HouseConfig[houseType]))
-            addNewAuctions(m_HouseConfig[houseType]);
+        FillAuctionSnapshot(houseType, snapshot);
         return true;
     }
     else
         return false;
 }
 
+void AuctionBotSeller::Plan(AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions)
+{
+    AHB_Seller_Config& config = m_HouseConfig[snapshot.HouseType];
+    if (SetStat(config, snapshot))
+        addNewAuctions(config, actions);
+}
+
+//== AuctionBotPlanner functions ===========================
+
+void AuctionBotPlanner::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running)
+    {
+        if (!m_agent)
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        // world thread does not touch agent and snapshot until planning is done
+        AuctionBotAgent* agent = m_agent;
+        lock.unlock();
+
+        AuctionBotActionList actions;
+        agent->Plan(m_snapshot, actions);
+
+        lock.lock();
+        m_planned.insert(m_planned.end(), actions.begin(), actions.end());
+        m_agent = nullptr;
+        m_condition.notify_all();
+    }
+}
+
+void AuctionBotPlanner::Stop()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_running = false;
+    m_condition.notify_all();
+}
+
+bool AuctionBotPlanner::IsPlanning()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_agent != nullptr;
+}
+
+void AuctionBotPlanner::Schedule(AuctionBotAgent* agent, AuctionBotSnapshot& snapshot)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    MANGOS_ASSERT(!m_agent);
+    m_agent = agent;
+    std::swap(m_snapshot, snapshot);
+    m_condition.notify_all();
+}
+
+void AuctionBotPlanner::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_agent && m_running)
+        m_condition.wait(lock);
+}
+
+bool AuctionBotPlanner::PopAction(AuctionBotAction& action)
+{
+    if (m_pending.empty())
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_pending.insert(m_pending.end(), m_planned.begin(), m_planned.end());
+        m_planned.clear();
+    }
+
+    if (m_pending.empty())
+        return false;
+
+    action = m_pending.front();
+    m_pending.pop_front();
+    return true;
+}
+
+bool AuctionBotPlanner::HasActions()
+{
+    if (!m_pending.empty())
+        return true;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return !m_planned.empty();
+}
+
+void AuctionBotPlanner::ClearActions()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_planned.clear();
+    m_pending.clear();
+}
+
 //== AuctionHouseBot functions =============================
 
-AuctionHouseBot::AuctionHouseBot() : m_Buyer(nullptr), m_Seller(nullptr), m_OperationSelector(0)
+AuctionHouseBot::AuctionHouseBot() : m_Buyer(nullptr), m_Seller(nullptr), m_Planner(nullptr), m_PlannerThread(nullptr), m_OperationSelector(0)
 {
 }
 
 AuctionHouseBot::~AuctionHouseBot()
 {
+    StopPlanner();
+
     delete m_Buyer;
     delete m_Seller;
 }
 
+void AuctionHouseBot::StopPlanner()
+{
+    if (!m_PlannerThread)
+        return;
+
+    m_Planner->Stop();
+    m_PlannerThread->wait();
+    delete m_PlannerThread;                                 // This also deletes m_Planner
+    m_PlannerThread = nullptr;
+    m_Planner = nullptr;
+}
+
 void AuctionHouseBot::InitilizeAgents()
 {
+    // agents are replaced, running planning and actions planned by old agents are dropped
+    StopPlanner();
+
     if (sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_SELLER_ENABLED))
     {
         delete m_Seller;
@@ -1664,6 +1867,12 @@ void AuctionHouseBot::InitilizeAgents()
             m_Buyer = nullptr;
         }
     }
+
+    if (m_Buyer || m_Seller)
+    {
+        m_Planner = new AuctionBotPlanner();
+        m_PlannerThread = new MaNGOS::Thread(m_Planner);
+    }
 }
 
 void AuctionHouseBot::Initialize()
@@ -1675,29 +1884,44 @@ void AuctionHouseBot::Initialize()
 void AuctionHouseBot::SetItemsRatio(uint32 al, uint32 ho, uint32 ne) const
 {
     if (AuctionBotSeller* seller = dynamic_cast<AuctionBotSeller*>(m_Seller))
+    {
+        m_Planner->Wait();                                  // seller config is used by planning
         seller->SetItemsRatio(al, ho, ne);
+    }
 }
 
 void AuctionHouseBot::SetItemsRatioForHouse(AuctionHouseType house, uint32 val) const
 {
     if (AuctionBotSeller* seller = dynamic_cast<AuctionBotSeller*>(m_Seller))
+    {
+        m_Planner->Wait();                                  // seller config is used by planning
         seller->SetItemsRatioForHouse(house, val);
+    }
 }
 
 void AuctionHouseBot::SetItemsAmount(uint32(&vals)[MAX_AUCTION_QUALITY]) const
 {
     if (AuctionBotSeller* seller = dynamic_cast<AuctionBotSeller*>(m_Seller))
+    {
+        m_Planner->Wait();                                  // seller config is used by planning
         seller->SetItemsAmount(vals);
+    }
 }
 
 void AuctionHouseBot::SetItemsAmountForQuality(AuctionQuality quality, uint32 val) const
 {
     if (AuctionBotSeller* seller = dynamic_cast<AuctionBotSeller*>(m_Seller))
+    {
+        m_Planner->Wait();                                  // seller config is used by planning
         seller->SetItemsAmountForQuality(quality, val);
+    }
 }
 
 bool AuctionHouseBot::ReloadAllConfig()
 {
+    if (m_Planner)
+        m_Planner->Wait();                                  // config is used by planning
+
     if (!sAuctionBotConfig.Reload())
     {
         sLog.outError("AHBot: Error while trying to reload config from file!");
@@ -1740,7 +1964,8 @@ void AuctionHouseBot::Rebuild(bool all) const
 {
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
@@ -1748,6 +1973,9 @@ void AuctionHouseBot::Rebuild(bool all) const
                 if (all || entry->bid == 0)                 // expire now auction if no bid or forced
                     entry->expireTime = sWorld.GetGameTime();
         }
+
+        // duration sort order changed
+        auctionHouse->InvalidateSearchCache();
     }
 }
 
@@ -1757,20 +1985,22 @@ void AuctionHouseBot::Update()
     if (!m_Buyer && !m_Seller)
         return;
 
+    // previous planning still running or its actions not applied yet, new snapshot would miss their changes
+    if (m_Planner->IsPlanning() || m_Planner->HasActions())
+        return;
+
     // scan all possible update cases until first success
     for (uint32 count = 0; count < 2 * MAX_AUCTION_HOUSE_TYPE; ++count)
     {
         bool successStep = false;
+        AuctionBotAgent* agent = m_OperationSelector < MAX_AUCTION_HOUSE_TYPE ? m_Seller : m_Buyer;
+        AuctionHouseType houseType = AuctionHouseType(m_OperationSelector % MAX_AUCTION_HOUSE_TYPE);
 
-        if (m_OperationSelector < MAX_AUCTION_HOUSE_TYPE)
+        AuctionBotSnapshot snapshot;
+        if (agent && agent->PrepareSnapshot(houseType, snapshot))
         {
-            if (m_Seller)
-                successStep = m_Seller->Update(AuctionHouseType(m_OperationSelector));
-        }
-        else
-        {
-            if (m_Buyer)
-                successStep = m_Buyer->Update(AuctionHouseType(m_OperationSelector - MAX_AUCTION_HOUSE_TYPE));
+            m_Planner->Schedule(agent, snapshot);
+            successStep = true;
         }
 
         ++m_OperationSelector;
@@ -1782,3 +2012,65 @@ void AuctionHouseBot::Update()
             break;
     }
 }
+
+void AuctionHouseBot::ApplyPlannedActions()
+{
+    if (!m_Planner)
+        return;
+
+    uint32 startTime = WorldTimer::getMSTime();
+
+    AuctionBotAction action(AHBOT_ACTION_SELL, AUCTION_HOUSE_NEUTRAL);
+    while (m_Planner->PopAction(action))
+    {
+        ApplyAction(action);
+
+        if (WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= sAuctionBotConfig.getConfig(CONFIG_UINT32_AHBOT_ACTIONS_TIME_BUDGET))
+            break;
+    }
+}
+
+void AuctionHouseBot::ApplyAction(AuctionBotAction const& action) const
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(action.HouseType);
+
+    switch (action.Type)
+    {
+        case AHBOT_ACTION_SELL:
+        {
+            uint32 houseid;
+            switch (action.HouseType)
+            {
+                case AUCTION_HOUSE_ALLIANCE: houseid =  1; break;
+                case AUCTION_HOUSE_HORDE:    houseid =  6; break;
+                default:                     houseid =  7; break;
+            }
+
+            AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(houseid);
+
+            Item* item = Item::CreateItem(action.ItemEntry, action.ItemCount);
+            if (!item)
+            {
+                sLog.outError("AHBot: Item::CreateItem() returned nullptr for item %u (stack: %u)", action.ItemEntry, action.ItemCount);
+                return;
+            }
+
+            auctionHouse->AddAuction(ahEntry, item, action.Duration, action.BidPrice, action.BuyoutPrice);
+            break;
+        }
+        case AHBOT_ACTION_BID:
+        case AHBOT_ACTION_BUY:
+        {
+            // auction can be bought, outbid or expired since planning
+            AuctionEntry* auction = auctionHouse->GetAuction(action.AuctionId);
+            if (!auction || auction->bid != action.ExpectedBid || !sAuctionMgr.GetAItem(auction->itemGuidLow))
+            {
+                DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u changed since planning, action skipped", action.AuctionId);
+                return;
+            }
+
+            auction->UpdateBid(action.BidPrice);
+            break;
+        }
+    }
+}
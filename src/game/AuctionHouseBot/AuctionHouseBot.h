@@ -44,6 +44,7 @@ enum AuctionBotConfigUInt32Values
     CONFIG_UINT32_AHBOT_MINTIME,
     CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_BOOST,
     CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_NORMAL,
+    CONFIG_UINT32_AHBOT_ACTIONS_TIME_BUDGET,
     CONFIG_UINT32_AHBOT_ALLIANCE_ITEM_AMOUNT_RATIO,
     CONFIG_UINT32_AHBOT_HORDE_ITEM_AMOUNT_RATIO,
     CONFIG_UINT32_AHBOT_NEUTRAL_ITEM_AMOUNT_RATIO,
@@ -171,6 +172,10 @@ class AuctionBotConfig
 
 #define sAuctionBotConfig MaNGOS::Singleton<AuctionBotConfig>::Instance()
 
+struct AuctionBotSnapshot;
+struct AuctionBotAction;
+typedef std::vector<AuctionBotAction> AuctionBotActionList;
+
 class AuctionBotAgent
 {
     public:
@@ -178,9 +183,19 @@ class AuctionBotAgent
         virtual ~AuctionBotAgent() {}
     public:
         virtual bool Initialize() = 0;
-        virtual bool Update(AuctionHouseType houseType) = 0;
+        // World thread: copy auction house state needed by Plan, false if agent not active for house
+        virtual bool PrepareSnapshot(AuctionHouseType houseType, AuctionBotSnapshot& snapshot) const = 0;
+        // Planner thread: decide actions from snapshot, applied later at world thread
+        virtual void Plan(AuctionBotSnapshot const& snapshot, AuctionBotActionList& actions) = 0;
 };
 
+class AuctionBotPlanner;
+
+namespace MaNGOS
+{
+    class Thread;
+}
+
 struct AuctionHouseBotStatusInfoPerType
 {
     uint32 ItemsCount;
@@ -198,6 +213,8 @@ class AuctionHouseBot
         ~AuctionHouseBot();
 
         void Update();
+        // Applies actions planned by planner thread, called every world tick
+        void ApplyPlannedActions();
         void Initialize();
 
         // Followed method is mainly used by level3.cpp for ingame/console command
@@ -211,10 +228,15 @@ class AuctionHouseBot
         void PrepareStatusInfos(AuctionHouseBotStatusInfo& statusInfo) const;
     private:
         void InitilizeAgents();
+        void StopPlanner();
+        void ApplyAction(AuctionBotAction const& action) const;
 
         AuctionBotAgent* m_Buyer;
         AuctionBotAgent* m_Seller;
 
+        AuctionBotPlanner* m_Planner;
+        MaNGOS::Thread* m_PlannerThread;
+
         uint32 m_OperationSelector;                         // 0..2*MAX_AUCTION_HOUSE_TYPE-1
 };
 
@@ -0,0 +1,244 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "BattleGround/BattleGroundMatchmaker.h"
+#include "Timer.h"
+
+void ArenaMatchmaker::run()
+{
+    std::vector<Command> commands;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running)
+    {
+        if (m_commands.empty())
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+
+        commands.swap(m_commands);
+        lock.unlock();
+
+        for (std::vector<Command>::const_iterator itr = commands.begin(); itr != commands.end(); ++itr)
+            ProcessCommand(*itr);
+        commands.clear();
+
+        lock.lock();
+    }
+}
+
+void ArenaMatchmaker::Stop()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_running = false;
+    m_condition.notify_all();
+}
+
+void ArenaMatchmaker::AddTeam(BattleGroundQueueTypeId bgQueueTypeId, BattleGroundBracketId bracketId, uint32 ticket, PvpTeamIndex teamIndex, uint32 rating, uint32 joinTime)
+{
+    Command command;
+    command.Type = COMMAND_ADD_TEAM;
+    command.Match.QueueTypeId = bgQueueTypeId;
+    command.Match.BracketId = bracketId;
+    command.Ticket = ticket;
+    command.TeamIndex = teamIndex;
+    command.Rating = rating;
+    command.JoinTime = joinTime;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_commands.push_back(command);
+    m_condition.notify_all();
+}
+
+void ArenaMatchmaker::RemoveTeam(uint32 ticket)
+{
+    Command command;
+    command.Type = COMMAND_REMOVE_TEAM;
+    command.Ticket = ticket;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_commands.push_back(command);
+    m_condition.notify_all();
+}
+
+void ArenaMatchmaker::RequestMatch(BattleGroundQueueTypeId bgQueueTypeId, BattleGroundTypeId bgTypeId, BattleGroundBracketId bracketId, ArenaType arenaType,
+                                   uint32 arenaRating, uint32 maxRatingDiff, uint32 discardTime)
+{
+    Command command;
+    command.Type = COMMAND_MATCH;
+    command.Match.QueueTypeId = bgQueueTypeId;
+    command.Match.BgTypeId = bgTypeId;
+    command.Match.BracketId = bracketId;
+    command.Match.arenaType = arenaType;
+    command.Match.RequestTime = WorldTimer::getMSTime();
+    command.Rating = arenaRating;
+    command.MaxRatingDiff = maxRatingDiff;
+    command.DiscardTime = discardTime;
+
+    ++m_stats.Requests;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_commands.push_back(command);
+    m_condition.notify_all();
+}
+
+bool ArenaMatchmaker::PopProposal(ArenaMatchProposal& proposal)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_proposals.empty())
+        return false;
+
+    proposal = m_proposals.front();
+    m_proposals.erase(m_proposals.begin());
+    return true;
+}
+
+void ArenaMatchmaker::ProcessCommand(Command const& command)
+{
+    switch (command.Type)
+    {
+        case COMMAND_ADD_TEAM:
+            DoAddTeam(GetKey(command.Match.QueueTypeId, command.Match.BracketId), command.Ticket, command.TeamIndex, command.Rating, command.JoinTime);
+            break;
+        case COMMAND_REMOVE_TEAM:
+            DoRemoveTeam(command.Ticket);
+            break;
+        case COMMAND_MATCH:
+            DoMatch(command);
+            break;
+    }
+}
+
+void ArenaMatchmaker::DoAddTeam(uint32 key, uint32 ticket, PvpTeamIndex teamIndex, uint32 rating, uint32 joinTime)
+{
+    RatedTeam& team = m_teams[ticket];
+    team.Key = key;
+    team.TeamIndex = teamIndex;
+    team.Rating = rating;
+    team.JoinTime = joinTime;
+
+    RatedBracket& bracket = m_brackets[key];
+    bracket.Teams[teamIndex][ticket] = joinTime;
+    bracket.Buckets[teamIndex][rating / ARENA_MATCHMAKER_RATING_BUCKET][ticket] = rating;
+}
+
+void ArenaMatchmaker::DoRemoveTeam(uint32 ticket)
+{
+    std::unordered_map<uint32, RatedTeam>::iterator itr = m_teams.find(ticket);
+    if (itr == m_teams.end())                               // already matched
+        return;
+
+    RatedTeam const& team = itr->second;
+    RatedBracket& bracket = m_brackets[team.Key];
+    bracket.Teams[team.TeamIndex].erase(ticket);
+
+    std::map<uint32, TicketRatingMap>::iterator bItr = bracket.Buckets[team.TeamIndex].find(team.Rating / ARENA_MATCHMAKER_RATING_BUCKET);
+    if (bItr != bracket.Buckets[team.TeamIndex].end())
+    {
+        bItr->second.erase(ticket);
+        if (bItr->second.empty())
+            bracket.Buckets[team.TeamIndex].erase(bItr);
+    }
+
+    m_teams.erase(itr);
+}
+
+// returns ticket of longest waiting team in rating range or waiting longer than discard time, 0 if none
+uint32 ArenaMatchmaker::FindTeam(RatedBracket const& bracket, PvpTeamIndex teamIndex, uint32 minRating, uint32 maxRating, uint32 discardTime, uint32 excludeTicket) const
+{
+    // only oldest team can exceed discard time before others do
+    for (std::map<uint32, uint32>::const_iterator itr = bracket.Teams[teamIndex].begin(); itr != bracket.Teams[teamIndex].end(); ++itr)
+    {
+        if (itr->first == excludeTicket)
+            continue;
+
+        if (itr->second < discardTime)
+            return itr->first;
+        break;
+    }
+
+    uint32 found = 0;
+    std::map<uint32, TicketRatingMap> const& buckets = bracket.Buckets[teamIndex];
+    for (std::map<uint32, TicketRatingMap>::const_iterator bItr = buckets.lower_bound(minRating / ARENA_MATCHMAKER_RATING_BUCKET);
+            bItr != buckets.end() && bItr->first <= maxRating / ARENA_MATCHMAKER_RATING_BUCKET; ++bItr)
+    {
+        for (TicketRatingMap::const_iterator tItr = bItr->second.begin(); tItr != bItr->second.end(); ++tItr)
+        {
+            if (found && tItr->first > found)
+                break;
+
+            if (tItr->first != excludeTicket && tItr->second >= minRating && tItr->second <= maxRating)
+            {
+                found = tItr->first;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+void ArenaMatchmaker::DoMatch(Command const& command)
+{
+    std::unordered_map<uint32, RatedBracket>::const_iterator bracketItr = m_brackets.find(GetKey(command.Match.QueueTypeId, command.Match.BracketId));
+    if (bracketItr == m_brackets.end())
+        return;
+
+    RatedBracket const& bracket = bracketItr->second;
+
+    // 0 is on automatic update call and we must use rating of team with longest wait time
+    uint32 arenaRating = command.Rating;
+    if (!arenaRating)
+    {
+        uint32 oldest = 0;
+        for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+            if (!bracket.Teams[i].empty() && (!oldest || bracket.Teams[i].begin()->first < oldest))
+                oldest = bracket.Teams[i].begin()->first;
+
+        if (!oldest)                                        // queues are empty
+            return;
+
+        arenaRating = m_teams.find(oldest)->second.Rating;
+    }
+
+    uint32 minRating = (arenaRating <= command.MaxRatingDiff) ? 0 : arenaRating - command.MaxRatingDiff;
+    uint32 maxRating = arenaRating + command.MaxRatingDiff;
+
+    uint32 tickets[PVP_TEAM_COUNT];
+    for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+        tickets[i] = FindTeam(bracket, PvpTeamIndex(i), minRating, maxRating, command.DiscardTime, 0);
+
+    // no opponent at other faction, try to find one in same faction queue
+    if (!tickets[TEAM_INDEX_ALLIANCE] && tickets[TEAM_INDEX_HORDE])
+        tickets[TEAM_INDEX_ALLIANCE] = FindTeam(bracket, TEAM_INDEX_HORDE, minRating, maxRating, command.DiscardTime, tickets[TEAM_INDEX_HORDE]);
+    else if (!tickets[TEAM_INDEX_HORDE] && tickets[TEAM_INDEX_ALLIANCE])
+        tickets[TEAM_INDEX_HORDE] = FindTeam(bracket, TEAM_INDEX_ALLIANCE, minRating, maxRating, command.DiscardTime, tickets[TEAM_INDEX_ALLIANCE]);
+
+    if (!tickets[TEAM_INDEX_ALLIANCE] || !tickets[TEAM_INDEX_HORDE])
+        return;
+
+    ArenaMatchProposal proposal = command.Match;
+    for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+    {
+        proposal.Tickets[i] = tickets[i];
+        DoRemoveTeam(tickets[i]);                           // world thread adds team again if proposal is rejected
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_proposals.push_back(proposal);
+}
@@ -0,0 +1,142 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __BATTLEGROUNDMATCHMAKER_H
+#define __BATTLEGROUNDMATCHMAKER_H
+
+#include "Common.h"
+#include "Globals/SharedDefines.h"
+#include "BattleGround.h"
+#include "Threading.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// width of rating bucket used to find teams in rating window
+#define ARENA_MATCHMAKER_RATING_BUCKET 50
+
+// Two rated arena teams selected to play against each other, slot by team index
+struct ArenaMatchProposal
+{
+    BattleGroundQueueTypeId QueueTypeId;
+    BattleGroundTypeId BgTypeId;
+    BattleGroundBracketId BracketId;
+    ArenaType arenaType;
+    uint32 Tickets[PVP_TEAM_COUNT];
+    uint32 RequestTime;                                     // ms time of match request, for latency stats
+};
+
+struct ArenaMatchmakerStats
+{
+    ArenaMatchmakerStats() : Requests(0), Proposals(0), Rejected(0), LatencySum(0), LatencyMax(0) {}
+
+    uint32 Requests;                                        // match requests sent to matchmaker
+    uint32 Proposals;                                       // proposals applied at world thread
+    uint32 Rejected;                                        // proposals with team not queued anymore
+    uint32 LatencySum;                                      // request to applied proposal time, ms
+    uint32 LatencyMax;
+};
+
+/**
+ * Rated arena matchmaking thread.
+ *
+ * Keeps own copy of queued rated teams, indexed by join order and by rating bucket for every
+ * queue type and bracket, so finding teams in rating window does not scan whole queue.
+ * World thread sends team add/remove and match requests and applies returned proposals,
+ * proposals must be validated against real queue state as teams can leave in meantime.
+ * Teams in proposal are removed from matchmaker state, world thread adds them back if proposal is rejected.
+ */
+class ArenaMatchmaker : public MaNGOS::Runnable
+{
+    public:
+        ArenaMatchmaker() : m_running(true) {}
+
+        void run() override;
+        void Stop();
+
+        // world thread only functions below
+        void AddTeam(BattleGroundQueueTypeId bgQueueTypeId, BattleGroundBracketId bracketId, uint32 ticket, PvpTeamIndex teamIndex, uint32 rating, uint32 joinTime);
+        void RemoveTeam(uint32 ticket);
+        void RequestMatch(BattleGroundQueueTypeId bgQueueTypeId, BattleGroundTypeId bgTypeId, BattleGroundBracketId bracketId, ArenaType arenaType,
+                          uint32 arenaRating, uint32 maxRatingDiff, uint32 discardTime);
+        bool PopProposal(ArenaMatchProposal& proposal);
+
+        ArenaMatchmakerStats& GetStats() { return m_stats; }
+
+    private:
+        enum CommandType
+        {
+            COMMAND_ADD_TEAM,
+            COMMAND_REMOVE_TEAM,
+            COMMAND_MATCH,
+        };
+
+        struct Command
+        {
+            CommandType Type;
+            ArenaMatchProposal Match;                       // queue and bracket for add and match
+            uint32 Ticket;
+            PvpTeamIndex TeamIndex;
+            uint32 Rating;                                  // team rating for add, rating to match against for match
+            uint32 JoinTime;
+            uint32 MaxRatingDiff;
+            uint32 DiscardTime;
+        };
+
+        struct RatedTeam
+        {
+            uint32 Key;
+            PvpTeamIndex TeamIndex;
+            uint32 Rating;
+            uint32 JoinTime;
+        };
+
+        typedef std::map<uint32 /*ticket*/, uint32 /*rating*/> TicketRatingMap;
+
+        struct RatedBracket
+        {
+            std::map<uint32 /*ticket*/, uint32 /*join time*/> Teams[PVP_TEAM_COUNT];   // ticket order is join order
+            std::map<uint32 /*rating bucket*/, TicketRatingMap> Buckets[PVP_TEAM_COUNT];
+        };
+
+        static uint32 GetKey(BattleGroundQueueTypeId bgQueueTypeId, BattleGroundBracketId bracketId) { return bgQueueTypeId * MAX_BATTLEGROUND_BRACKETS + bracketId; }
+
+        void ProcessCommand(Command const& command);
+        void DoAddTeam(uint32 key, uint32 ticket, PvpTeamIndex teamIndex, uint32 rating, uint32 joinTime);
+        void DoRemoveTeam(uint32 ticket);
+        void DoMatch(Command const& command);
+        uint32 FindTeam(RatedBracket const& bracket, PvpTeamIndex teamIndex, uint32 minRating, uint32 maxRating, uint32 discardTime, uint32 excludeTicket) const;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::vector<Command> m_commands;                    // guarded by m_mutex
+        std::vector<ArenaMatchProposal> m_proposals;        // guarded by m_mutex
+        bool m_running;
+
+        // matchmaker thread only
+        std::unordered_map<uint32 /*ticket*/, RatedTeam> m_teams;
+        std::unordered_map<uint32 /*key*/, RatedBracket> m_brackets;
+
+        // world thread only
+        ArenaMatchmakerStats m_stats;
+};
+
+#endif
@@ -42,6 +42,9 @@
 
 INSTANTIATE_SINGLETON_1(BattleGroundMgr);
 
+// interval of arena matchmaker stats output
+#define ARENA_MATCHMAKER_STATS_INTERVAL (10 * MINUTE * IN_MILLISECONDS)
+
 /*********************************************************/
 /***            BATTLEGROUND QUEUE SYSTEM              ***/
 /*********************************************************/
@@ -58,6 +61,13 @@ BattleGroundQueue::BattleGroundQueue()
                 m_WaitTimes[i][j][k] = 0;
         }
     }
+
+    for (uint8 i = 0; i < MAX_BATTLEGROUND_BRACKETS; ++i)
+    {
+        for (uint8 j = 0; j < PVP_TEAM_COUNT; ++j)
+            m_NormalQueuedPlayersCount[i][j] = 0;
+        m_NormalQueuedPlayersCountChanged[i] = false;
+    }
 }
 
 BattleGroundQueue::~BattleGroundQueue()
@@ -156,6 +166,7 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
     ginfo->GroupTeam                 = leader->GetTeam();
     ginfo->ArenaTeamRating           = arenaRating;
     ginfo->OpponentsTeamRating       = 0;
+    ginfo->MatchmakerTicket          = 0;
 
     ginfo->Players.clear();
 
@@ -204,6 +215,15 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
 
         // add GroupInfo to m_QueuedGroups
         m_QueuedGroups[bracketId][index].push_back(ginfo);
+        m_NormalQueuedPlayersCountChanged[bracketId] = true;
+
+        // rated teams are matched by arena matchmaker
+        if (isRated)
+        {
+            ginfo->MatchmakerTicket = sBattleGroundMgr.GenerateMatchmakerTicket();
+            m_RatedTeams[ginfo->MatchmakerTicket] = ginfo;
+            AddToArenaMatchmaker(ginfo, bracketId);
+        }
 
         // announce to world, this code needs mutex
         if (arenaType == ARENA_TYPE_NONE && !isRated && !isPremade && sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN))
@@ -215,13 +235,8 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* grp, BattleGr
                 uint32 qHorde = 0;
                 uint32 qAlliance = 0;
                 uint32 q_min_level = leader->GetMinLevelForBattleGroundBracketId(bracketId, BgTypeId);
-                GroupsQueueType::const_iterator itr;
-                for (itr = m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].begin(); itr != m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].end(); ++itr)
-                    if (!(*itr)->IsInvitedToBGInstanceGUID)
-                        qAlliance += (*itr)->Players.size();
-                for (itr = m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].begin(); itr != m_QueuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].end(); ++itr)
-                    if (!(*itr)->IsInvitedToBGInstanceGUID)
-                        qHorde += (*itr)->Players.size();
+                qAlliance = GetNormalQueuedPlayersCount(bracketId, TEAM_INDEX_ALLIANCE);
+                qHorde = GetNormalQueuedPlayersCount(bracketId, TEAM_INDEX_HORDE);
 
                 // Show queue status to player only (when joining queue)
                 if (sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN) == 1)
@@ -292,6 +307,28 @@ uint32 BattleGroundQueue::GetAverageQueueWaitTime(GroupQueueInfo* ginfo, BattleG
         return 0;
 }
 
+uint32 BattleGroundQueue::GetNormalQueuedPlayersCount(BattleGroundBracketId bracket_id, PvpTeamIndex teamIndex)
+{
+    if (m_NormalQueuedPlayersCountChanged[bracket_id])
+    {
+        for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+        {
+            m_NormalQueuedPlayersCount[bracket_id][i] = 0;
+            for (GroupsQueueType::const_iterator itr = m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].begin(); itr != m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].end(); ++itr)
+                if (!(*itr)->IsInvitedToBGInstanceGUID)
+                    m_NormalQueuedPlayersCount[bracket_id][i] += (*itr)->Players.size();
+        }
+        m_NormalQueuedPlayersCountChanged[bracket_id] = false;
+    }
+    return m_NormalQueuedPlayersCount[bracket_id][teamIndex];
+}
+
+void BattleGroundQueue::AddToArenaMatchmaker(GroupQueueInfo* ginfo, BattleGroundBracketId bracket_id) const
+{
+    sBattleGroundMgr.GetArenaMatchmaker().AddTeam(BattleGroundMgr::BGQueueTypeId(ginfo->BgTypeId, ginfo->arenaType), bracket_id, ginfo->MatchmakerTicket,
+            BattleGround::GetTeamIndexByTeamId(ginfo->GroupTeam), ginfo->ArenaTeamRating, ginfo->JoinTime);
+}
+
 // remove player from queue and from group info, if group info is empty then remove it too
 void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
 {
@@ -363,6 +400,7 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
 
     // remove player queue info
     m_QueuedPlayers.erase(itr);
+    m_NormalQueuedPlayersCountChanged[bracket_id] = true;
 
     // announce to world if arena team left queue for rated match, show only once
     if (group->arenaType != ARENA_TYPE_NONE && group->IsRated && group->Players.empty() && sWorld.getConfig(CONFIG_BOOL_ARENA_QUEUE_ANNOUNCER_EXIT))
@@ -387,6 +425,12 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove group queue info if needed
     if (group->Players.empty())
     {
+        if (group->MatchmakerTicket)
+        {
+            sBattleGroundMgr.GetArenaMatchmaker().RemoveTeam(group->MatchmakerTicket);
+            m_RatedTeams.erase(group->MatchmakerTicket);
+        }
+
         m_QueuedGroups[bracket_id][index].erase(group_itr);
         delete group;
     }
@@ -447,6 +491,7 @@ bool BattleGroundQueue::InviteGroupToBG(GroupQueueInfo* ginfo, BattleGround* bg,
         BattleGroundTypeId bgTypeId = bg->GetTypeID();
         BattleGroundQueueTypeId bgQueueTypeId = BattleGroundMgr::BGQueueTypeId(bgTypeId, bg->GetArenaType());
         BattleGroundBracketId bracket_id = bg->GetBracketId();
+        m_NormalQueuedPlayersCountChanged[bracket_id] = true;
 
         // set ArenaTeamId for rated matches
         if (bg->isArena() && bg->isRated())
@@ -629,6 +674,7 @@ bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracket_id, uint
                 // we must insert group to normal queue and erase pointer from premade queue
                 m_QueuedGroups[bracket_id][BG_QUEUE_NORMAL_ALLIANCE + i].push_front((*itr));
                 m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE + i].erase(itr);
+                m_NormalQueuedPlayersCountChanged[bracket_id] = true;
             }
         }
     }
@@ -639,6 +685,12 @@ bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracket_id, uint
 // this method tries to create battleground or arena with MinPlayersPerTeam against MinPlayersPerTeam
 bool BattleGroundQueue::CheckNormalMatch(BattleGround* bg_template, BattleGroundBracketId bracket_id, uint32 minPlayers, uint32 maxPlayers)
 {
+    // no selection can reach min players at any side, skip queue scan
+    uint32 aliCount = GetNormalQueuedPlayersCount(bracket_id, TEAM_INDEX_ALLIANCE);
+    uint32 hordeCount = GetNormalQueuedPlayersCount(bracket_id, TEAM_INDEX_HORDE);
+    if (aliCount < minPlayers && hordeCount < minPlayers && !(sBattleGroundMgr.isTesting() && (aliCount || hordeCount)))
+        return false;
+
     GroupsQueueType::const_iterator itr_team[PVP_TEAM_COUNT];
     for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
     {
@@ -717,6 +769,7 @@ bool BattleGroundQueue::CheckSkirmishForSameFaction(BattleGroundBracketId bracke
         return false;
 
     // here we have correct 2 selections and we need to change one teams team and move selection pool teams to other team's queue
+    m_NormalQueuedPlayersCountChanged[bracket_id] = true;
     for (GroupsQueueType::iterator itr = m_SelectionPools[otherTeamIdx].SelectedGroups.begin(); itr != m_SelectionPools[otherTeamIdx].SelectedGroups.end(); ++itr)
     {
         // set correct team
@@ -884,138 +937,70 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
     }
     else if (bg_template->isArena())
     {
-        // found out the minimum and maximum ratings the newly added team should battle against
-        // arenaRating is the rating of the latest joined team, or 0
-        // 0 is on (automatic update call) and we must set it to team's with longest wait time
-        if (!arenaRating)
-        {
-            GroupQueueInfo* front1 = nullptr;
-            GroupQueueInfo* front2 = nullptr;
-            if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].empty())
-            {
-                front1 = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].front();
-                arenaRating = front1->ArenaTeamRating;
-            }
-            if (!m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].empty())
-            {
-                front2 = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].front();
-                arenaRating = front2->ArenaTeamRating;
-            }
-            if (front1 && front2)
-            {
-                if (front1->JoinTime < front2->JoinTime)
-                    arenaRating = front1->ArenaTeamRating;
-            }
-            else if (!front1 && !front2)
-                return; // queues are empty
-        }
-
-        // set rating range
-        uint32 arenaMinRating = (arenaRating <= sBattleGroundMgr.GetMaxRatingDifference()) ? 0 : arenaRating - sBattleGroundMgr.GetMaxRatingDifference();
-        uint32 arenaMaxRating = arenaRating + sBattleGroundMgr.GetMaxRatingDifference();
-        // if max rating difference is set and the time past since server startup is greater than the rating discard time
-        // (after what time the ratings aren't taken into account when making teams) then
-        // the discard time is current_time - time_to_discard, teams that joined after that, will have their ratings taken into account
-        // else leave the discard time on 0, this way all ratings will be discarded
-        uint32 discardTime = WorldTimer::getMSTime() - sBattleGroundMgr.GetRatingDiscardTimer();
-
-        // we need to find 2 teams which will play next game
+        // arenaRating is the rating of the latest joined team, or 0 on automatic update call
+        // teams are selected by arena matchmaker, match is started at BattleGroundMgr::Update
+        sBattleGroundMgr.GetArenaMatchmaker().RequestMatch(BattleGroundMgr::BGQueueTypeId(bgTypeId, arenaType), bgTypeId, bracket_id, arenaType, arenaRating,
+                sBattleGroundMgr.GetMaxRatingDifference(), WorldTimer::getMSTime() - sBattleGroundMgr.GetRatingDiscardTimer());
+    }
+}
 
-        GroupsQueueType::iterator itr_team[PVP_TEAM_COUNT];
+// starts rated arena match for teams selected by arena matchmaker
+bool BattleGroundQueue::StartRatedArenaMatch(ArenaMatchProposal const& proposal)
+{
+    GroupQueueInfo* teams[PVP_TEAM_COUNT];
+    bool valid = true;
+    for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+    {
+        RatedTeamsMap::const_iterator itr = m_RatedTeams.find(proposal.Tickets[i]);
+        teams[i] = (itr != m_RatedTeams.end() && !itr->second->IsInvitedToBGInstanceGUID) ? itr->second : nullptr;
+        if (!teams[i])
+            valid = false;
+    }
 
-        // optimalization : --- we dont need to use selection_pools - each update we select max 2 groups
+    BattleGround* arena = valid ? sBattleGroundMgr.CreateNewBattleGround(proposal.BgTypeId, proposal.BracketId, proposal.arenaType, true) : nullptr;
+    if (!arena)
+    {
+        if (valid)
+            sLog.outError("BattlegroundQueue::StartRatedArenaMatch couldn't create arena instance for rated arena match!");
 
-        for (uint8 i = BG_QUEUE_PREMADE_ALLIANCE; i < BG_QUEUE_NORMAL_ALLIANCE; ++i)
+        // team left queue after match was found, give others back to matchmaker
+        for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
         {
-            // take the group that joined first
-            itr_team[i] = m_QueuedGroups[bracket_id][i].begin();
-            for (; itr_team[i] != m_QueuedGroups[bracket_id][i].end(); ++(itr_team[i]))
+            if (teams[i])
             {
-                // if group match conditions, then add it to pool
-                if (!(*itr_team[i])->IsInvitedToBGInstanceGUID
-                        && (((*itr_team[i])->ArenaTeamRating >= arenaMinRating && (*itr_team[i])->ArenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[i])->JoinTime < discardTime))
-                {
-                    m_SelectionPools[i].AddGroup((*itr_team[i]), MaxPlayersPerTeam);
-                    // break for cycle to be able to start selecting another group from same faction queue
-                    break;
-                }
-            }
-        }
-        // now we are done if we have 2 groups - ali vs horde!
-        // if we don't have, we must try to continue search in same queue
-        // tmp variables are correctly set
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in HORDE queue
-        if (m_SelectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount() == 0 && m_SelectionPools[TEAM_INDEX_HORDE].GetPlayerCount())
-        {
-            itr_team[TEAM_INDEX_ALLIANCE] = itr_team[TEAM_INDEX_HORDE];
-            ++itr_team[TEAM_INDEX_ALLIANCE];
-            for (; itr_team[TEAM_INDEX_ALLIANCE] != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].end(); ++(itr_team[TEAM_INDEX_ALLIANCE]))
-            {
-                if (!(*itr_team[TEAM_INDEX_ALLIANCE])->IsInvitedToBGInstanceGUID
-                        && (((*itr_team[TEAM_INDEX_ALLIANCE])->ArenaTeamRating >= arenaMinRating && (*itr_team[TEAM_INDEX_ALLIANCE])->ArenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[TEAM_INDEX_ALLIANCE])->JoinTime < discardTime))
-                {
-                    m_SelectionPools[TEAM_INDEX_ALLIANCE].AddGroup((*itr_team[TEAM_INDEX_ALLIANCE]), MaxPlayersPerTeam);
-                    break;
-                }
-            }
-        }
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in ALLIANCE queue
-        if (m_SelectionPools[TEAM_INDEX_HORDE].GetPlayerCount() == 0 && m_SelectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount())
-        {
-            itr_team[TEAM_INDEX_HORDE] = itr_team[TEAM_INDEX_ALLIANCE];
-            ++itr_team[TEAM_INDEX_HORDE];
-            for (; itr_team[TEAM_INDEX_HORDE] != m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].end(); ++(itr_team[TEAM_INDEX_HORDE]))
-            {
-                if (!(*itr_team[TEAM_INDEX_HORDE])->IsInvitedToBGInstanceGUID
-                        && (((*itr_team[TEAM_INDEX_HORDE])->ArenaTeamRating >= arenaMinRating && (*itr_team[TEAM_INDEX_HORDE])->ArenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[TEAM_INDEX_HORDE])->JoinTime < discardTime))
-                {
-                    m_SelectionPools[TEAM_INDEX_HORDE].AddGroup((*itr_team[TEAM_INDEX_HORDE]), MaxPlayersPerTeam);
-                    break;
-                }
+                AddToArenaMatchmaker(teams[i], proposal.BracketId);
+                sBattleGroundMgr.ScheduleQueueUpdate(teams[i]->ArenaTeamRating, proposal.arenaType, proposal.QueueTypeId, proposal.BgTypeId, proposal.BracketId);
             }
         }
+        return false;
+    }
 
-        // if we have 2 teams, then start new arena and invite players!
-        if (m_SelectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount() && m_SelectionPools[TEAM_INDEX_HORDE].GetPlayerCount())
-        {
-            BattleGround* arena = sBattleGroundMgr.CreateNewBattleGround(bgTypeId, bracket_id, arenaType, true);
-            if (!arena)
-            {
-                sLog.outError("BattlegroundQueue::Update couldn't create arena instance for rated arena match!");
-                return;
-            }
+    teams[TEAM_INDEX_ALLIANCE]->OpponentsTeamRating = teams[TEAM_INDEX_HORDE]->ArenaTeamRating;
+    DEBUG_LOG("setting oposite teamrating for team %u to %u", teams[TEAM_INDEX_ALLIANCE]->ArenaTeamId, teams[TEAM_INDEX_ALLIANCE]->OpponentsTeamRating);
+    teams[TEAM_INDEX_HORDE]->OpponentsTeamRating = teams[TEAM_INDEX_ALLIANCE]->ArenaTeamRating;
+    DEBUG_LOG("setting oposite teamrating for team %u to %u", teams[TEAM_INDEX_HORDE]->ArenaTeamId, teams[TEAM_INDEX_HORDE]->OpponentsTeamRating);
 
-            (*(itr_team[TEAM_INDEX_ALLIANCE]))->OpponentsTeamRating = (*(itr_team[TEAM_INDEX_HORDE]))->ArenaTeamRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[TEAM_INDEX_ALLIANCE]))->ArenaTeamId, (*(itr_team[TEAM_INDEX_ALLIANCE]))->OpponentsTeamRating);
-            (*(itr_team[TEAM_INDEX_HORDE]))->OpponentsTeamRating = (*(itr_team[TEAM_INDEX_ALLIANCE]))->ArenaTeamRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[TEAM_INDEX_HORDE]))->ArenaTeamId, (*(itr_team[TEAM_INDEX_HORDE]))->OpponentsTeamRating);
-            // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
-            if ((*(itr_team[TEAM_INDEX_ALLIANCE]))->GroupTeam != ALLIANCE)
-            {
-                // add to alliance queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].push_front(*(itr_team[TEAM_INDEX_ALLIANCE]));
-                // erase from horde queue
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].erase(itr_team[TEAM_INDEX_ALLIANCE]);
-                itr_team[TEAM_INDEX_ALLIANCE] = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].begin();
-            }
-            if ((*(itr_team[TEAM_INDEX_HORDE]))->GroupTeam != HORDE)
-            {
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].push_front(*(itr_team[TEAM_INDEX_HORDE]));
-                m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_ALLIANCE].erase(itr_team[TEAM_INDEX_HORDE]);
-                itr_team[TEAM_INDEX_HORDE] = m_QueuedGroups[bracket_id][BG_QUEUE_PREMADE_HORDE].begin();
-            }
+    // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
+    for (uint8 i = 0; i < PVP_TEAM_COUNT; ++i)
+    {
+        Team side = i == TEAM_INDEX_ALLIANCE ? ALLIANCE : HORDE;
+        if (teams[i]->GroupTeam != side)
+        {
+            GroupsQueueType& oldQueue = m_QueuedGroups[proposal.BracketId][BG_QUEUE_PREMADE_ALLIANCE + (i + 1) % PVP_TEAM_COUNT];
+            GroupsQueueType::iterator itr = std::find(oldQueue.begin(), oldQueue.end(), teams[i]);
+            if (itr != oldQueue.end())
+                oldQueue.erase(itr);
+            m_QueuedGroups[proposal.BracketId][BG_QUEUE_PREMADE_ALLIANCE + i].push_front(teams[i]);
+        }
+    }
 
-            InviteGroupToBG(*(itr_team[TEAM_INDEX_ALLIANCE]), arena, ALLIANCE);
-            InviteGroupToBG(*(itr_team[TEAM_INDEX_HORDE]), arena, HORDE);
+    InviteGroupToBG(teams[TEAM_INDEX_ALLIANCE], arena, ALLIANCE);
+    InviteGroupToBG(teams[TEAM_INDEX_HORDE], arena, HORDE);
 
-            DEBUG_LOG("Starting rated arena match!");
+    DEBUG_LOG("Starting rated arena match!");
 
-            arena->StartBattleGround();
-        }
-    }
+    arena->StartBattleGround();
+    return true;
 }
 
 /*********************************************************/
@@ -1110,16 +1095,24 @@ void BGQueueRemoveEvent::Abort(uint64 /*e_time*/)
 /***            BATTLEGROUND MANAGER                   ***/
 /*********************************************************/
 
-BattleGroundMgr::BattleGroundMgr() : m_NextAutoDistributionTime(0), m_AutoDistributionTimeChecker(0), m_ArenaTesting(false)
+BattleGroundMgr::BattleGroundMgr() : m_NextAutoDistributionTime(0), m_AutoDistributionTimeChecker(0), m_ArenaTesting(false),
+    m_NextMatchmakerTicket(0), m_MatchmakerStatsTimer(ARENA_MATCHMAKER_STATS_INTERVAL)
 {
     for (uint8 i = BATTLEGROUND_TYPE_NONE; i < MAX_BATTLEGROUND_TYPE_ID; ++i)
         m_BattleGrounds[i].clear();
     m_NextRatingDiscardUpdate = sWorld.getConfig(CONFIG_UINT32_ARENA_RATING_DISCARD_TIMER);
     m_Testing = false;
+
+    m_ArenaMatchmaker = new ArenaMatchmaker;
+    m_ArenaMatchmakerThread = new MaNGOS::Thread(m_ArenaMatchmaker);
 }
 
 BattleGroundMgr::~BattleGroundMgr()
 {
+    m_ArenaMatchmaker->Stop();
+    m_ArenaMatchmakerThread->wait();
+    delete m_ArenaMatchmakerThread;                         // This also deletes m_ArenaMatchmaker
+
     DeleteAllBattleGrounds();
 }
 
@@ -1164,6 +1157,36 @@ void BattleGroundMgr::Update(uint32 diff)
         }
     }
 
+    // start rated arena matches found by matchmaker
+    ArenaMatchmakerStats& matchmakerStats = m_ArenaMatchmaker->GetStats();
+    ArenaMatchProposal proposal;
+    while (m_ArenaMatchmaker->PopProposal(proposal))
+    {
+        if (m_BattleGroundQueues[proposal.QueueTypeId].StartRatedArenaMatch(proposal))
+        {
+            uint32 latency = WorldTimer::getMSTimeDiff(proposal.RequestTime, WorldTimer::getMSTime());
+            ++matchmakerStats.Proposals;
+            matchmakerStats.LatencySum += latency;
+            matchmakerStats.LatencyMax = std::max(matchmakerStats.LatencyMax, latency);
+        }
+        else
+            ++matchmakerStats.Rejected;
+    }
+
+    if (m_MatchmakerStatsTimer < diff)
+    {
+        if (matchmakerStats.Requests)
+        {
+            sLog.outDetail("BattleGroundMgr: arena matchmaker handled %u requests, started %u matches (%u rejected), match latency avg %u ms, max %u ms",
+                           matchmakerStats.Requests, matchmakerStats.Proposals, matchmakerStats.Rejected,
+                           matchmakerStats.Proposals ? matchmakerStats.LatencySum / matchmakerStats.Proposals : 0, matchmakerStats.LatencyMax);
+            matchmakerStats = ArenaMatchmakerStats();
+        }
+        m_MatchmakerStatsTimer = ARENA_MATCHMAKER_STATS_INTERVAL;
+    }
+    else
+        m_MatchmakerStatsTimer -= diff;
+
     // if rating difference counts, maybe force-update queues
     if (sWorld.getConfig(CONFIG_UINT32_ARENA_MAX_RATING_DIFFERENCE) && sWorld.getConfig(CONFIG_UINT32_ARENA_RATING_DISCARD_TIMER))
     {
@@ -24,6 +24,7 @@
 #include "Globals/SharedDefines.h"
 #include "Server/DBCEnums.h"
 #include "BattleGround.h"
+#include "BattleGroundMatchmaker.h"
 
 #include <mutex>
 
@@ -61,6 +62,7 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  IsInvitedToBGInstanceGUID;                      // was invited to certain BG
     uint32  ArenaTeamRating;                                // if rated match, inited to the rating of the team
     uint32  OpponentsTeamRating;                            // for rated arena matches
+    uint32  MatchmakerTicket;                               // for rated arena matches, team id at arena matchmaker
 };
 
 enum BattleGroundQueueGroupTypes
@@ -91,6 +93,7 @@ class BattleGroundQueue
         bool GetPlayerGroupInfoData(ObjectGuid guid, GroupQueueInfo* ginfo);
         void PlayerInvitedToBGUpdateAverageWaitTime(GroupQueueInfo* ginfo, BattleGroundBracketId bracket_id);
         uint32 GetAverageQueueWaitTime(GroupQueueInfo* ginfo, BattleGroundBracketId bracket_id);
+        bool StartRatedArenaMatch(ArenaMatchProposal const& proposal);
 
     private:
         // mutex that should not allow changing private data, nor allowing to update Queue during private data change.
@@ -114,6 +117,16 @@ class BattleGroundQueue
         */
         GroupsQueueType m_QueuedGroups[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
 
+        // not invited players count in normal queues, recounted on use after queue changes
+        uint32 GetNormalQueuedPlayersCount(BattleGroundBracketId bracket_id, PvpTeamIndex teamIndex);
+        uint32 m_NormalQueuedPlayersCount[MAX_BATTLEGROUND_BRACKETS][PVP_TEAM_COUNT];
+        bool m_NormalQueuedPlayersCountChanged[MAX_BATTLEGROUND_BRACKETS];
+
+        // rated arena teams by matchmaker ticket
+        typedef std::unordered_map<uint32, GroupQueueInfo*> RatedTeamsMap;
+        RatedTeamsMap m_RatedTeams;
+        void AddToArenaMatchmaker(GroupQueueInfo* ginfo, BattleGroundBracketId bracket_id) const;
+
         // class to select and invite groups to bg
         class SelectionPool
         {
@@ -230,6 +243,9 @@ class BattleGroundMgr
 
         BGFreeSlotQueueType BGFreeSlotQueue[MAX_BATTLEGROUND_TYPE_ID];
 
+        ArenaMatchmaker& GetArenaMatchmaker() { return *m_ArenaMatchmaker; }
+        uint32 GenerateMatchmakerTicket() { return ++m_NextMatchmakerTicket; }
+
         void ScheduleQueueUpdate(uint32 arenaRating, ArenaType arenaType, BattleGroundQueueTypeId bgQueueTypeId, BattleGroundTypeId bgTypeId, BattleGroundBracketId bracket_id);
         uint32 GetMaxRatingDifference() const;
         uint32 GetRatingDiscardTimer()  const;
@@ -293,6 +309,12 @@ class BattleGroundMgr
         uint32 m_AutoDistributionTimeChecker;
         bool   m_ArenaTesting;
         bool   m_Testing;
+
+        /* Rated arena matchmaking */
+        ArenaMatchmaker* m_ArenaMatchmaker;
+        MaNGOS::Thread* m_ArenaMatchmakerThread;
+        uint32 m_NextMatchmakerTicket;
+        uint32 m_MatchmakerStatsTimer;
 };
 
 #define sBattleGroundMgr MaNGOS::Singleton<BattleGroundMgr>::Instance()
@@ -503,7 +503,12 @@ class ChatHandler
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
         bool HandleServerMotdCommand(char* args);
+        bool HandleServerOpcodesResetCommand(char* args);
+        bool HandleServerOpcodesShowCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
+        bool HandleServerProfileDumpCommand(char* args);
+        bool HandleServerProfileResetCommand(char* args);
+        bool HandleServerProfileShowCommand(char* args);
         bool HandleServerResetAllRaidCommand(char* args);
         bool HandleServerRestartCommand(char* args);
         bool HandleServerSetMotdCommand(char* args);
@@ -56,6 +56,8 @@
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "Server/SQLStorages.h"
 #include "Loot/LootMgr.h"
+#include "World/TickProfiler.h"
+#include "Server/OpcodeCost.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -694,6 +696,7 @@ bool ChatHandler::HandleReloadSpellAffectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading SpellAffect definitions...");
     sSpellMgr.LoadSpellAffects();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_affect` (spell mods apply requirements) reloaded.");
     return true;
 }
@@ -702,6 +705,7 @@ bool ChatHandler::HandleReloadSpellAreaCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading SpellArea Data...");
     sSpellMgr.LoadSpellAreas();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_area` (spell dependences from area/quest/auras state) reloaded.");
     return true;
 }
@@ -710,6 +714,7 @@ bool ChatHandler::HandleReloadSpellBonusesCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Bonus Data...");
     sSpellMgr.LoadSpellBonuses();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_bonus_data` (spell damage/healing coefficients) reloaded.");
     return true;
 }
@@ -718,6 +723,7 @@ bool ChatHandler::HandleReloadSpellChainCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Chain Data... ");
     sSpellMgr.LoadSpellChains();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_chain` (spell ranks) reloaded.");
     return true;
 }
@@ -726,6 +732,7 @@ bool ChatHandler::HandleReloadSpellElixirCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Elixir types...");
     sSpellMgr.LoadSpellElixirs();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_elixir` (spell elixir types) reloaded.");
     return true;
 }
@@ -742,6 +749,7 @@ bool ChatHandler::HandleReloadSpellProcEventCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Proc Event conditions...");
     sSpellMgr.LoadSpellProcEvents();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_proc_event` (spell proc trigger requirements) reloaded.");
     return true;
 }
@@ -750,6 +758,7 @@ bool ChatHandler::HandleReloadSpellProcItemEnchantCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Proc Item Enchant...");
     sSpellMgr.LoadSpellProcItemEnchant();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_proc_item_enchant` (item enchantment ppm) reloaded.");
     return true;
 }
@@ -766,6 +775,7 @@ bool ChatHandler::HandleReloadSpellTargetPositionCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading spell target destination coordinates...");
     sSpellMgr.LoadSpellTargetPositions();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_target_position` (destination coordinates for spell targets) reloaded.");
     return true;
 }
@@ -774,6 +784,7 @@ bool ChatHandler::HandleReloadSpellThreatsCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Aggro Spells Definitions...");
     sSpellMgr.LoadSpellThreats();
+    sSpellMgr.BuildSpellCompiledInfo();
     SendGlobalSysMessage("DB table `spell_threat` (spell aggro definitions) reloaded.");
     return true;
 }
@@ -5911,6 +5922,77 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerOpcodesShowCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 15))
+        return false;
+
+    sOpcodeCostMgr.ShowStats(this, count);
+    return true;
+}
+
+bool ChatHandler::HandleServerOpcodesResetCommand(char* /*args*/)
+{
+    sOpcodeCostMgr.Reset();
+    SendSysMessage("Opcode handler statistics reset.");
+    return true;
+}
+
+// .server profile [subsystem|map|opcode|script] [count]
+bool ChatHandler::HandleServerProfileShowCommand(char* args)
+{
+    if (!sTickProfiler.IsEnabled())
+    {
+        SendSysMessage("Profiler is disabled, it needs BUILD_PROFILER build and Profiler.Enable config option.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    ProfileCategory category = PROFILE_SUBSYSTEM;
+    if (char* param = ExtractLiteralArg(&args))
+    {
+        int l = strlen(param);
+        if (strncmp(param, "subsystem", l) == 0)
+            category = PROFILE_SUBSYSTEM;
+        else if (strncmp(param, "map", l) == 0)
+            category = PROFILE_MAP;
+        else if (strncmp(param, "opcode", l) == 0)
+            category = PROFILE_OPCODE;
+        else if (strncmp(param, "script", l) == 0)
+            category = PROFILE_SCRIPT;
+        else
+            return false;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 15))
+        return false;
+
+    sTickProfiler.ShowStats(this, category, count);
+    return true;
+}
+
+bool ChatHandler::HandleServerProfileResetCommand(char* /*args*/)
+{
+    sTickProfiler.Reset();
+    SendSysMessage("Profiler statistics and trace reset.");
+    return true;
+}
+
+bool ChatHandler::HandleServerProfileDumpCommand(char* /*args*/)
+{
+    if (!sTickProfiler.Dump())
+    {
+        SendSysMessage("No profiled zones to dump or previous dump is still being written.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    SendSysMessage("Profiler trace is written to dump directory.");
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
@@ -72,6 +72,8 @@ class Camera
     public:
         GridReference<Camera>& GetGridRef() { return m_gridRef; }
         bool isActiveObject() const { return false; }
+        // camera follows its view point, cell hot data would not follow its moves
+        static bool const HasGridHotData = false;
     private:
         GridReference<Camera> m_gridRef;
 };
@@ -38,6 +38,10 @@
 #include "Util.h"
 #include "Tools/Language.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
+#include "Timer.h"
+
+#include <algorithm>
+#include <vector>
 
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotMgr.h"
@@ -51,19 +55,75 @@ enum CinematicsSkipMode
     CINEMATICS_SKIP_ALL       = 2,
 };
 
+#define LOGIN_STATS_INTERVAL    (10 * MINUTE * IN_MILLISECONDS)
+#define LOGIN_STATS_MAX_SAMPLES 4096
+
 class LoginQueryHolder : public SqlQueryHolder
 {
     private:
         uint32 m_accountId;
         ObjectGuid m_guid;
+        uint32 m_startTime;
     public:
         LoginQueryHolder(uint32 accountId, ObjectGuid guid)
-            : m_accountId(accountId), m_guid(guid) { }
+            : m_accountId(accountId), m_guid(guid), m_startTime(WorldTimer::getMSTime()) { }
         ObjectGuid GetGuid() const { return m_guid; }
         uint32 GetAccountId() const { return m_accountId; }
+        uint32 GetStartTime() const { return m_startTime; }
         bool Initialize();
 };
 
+// percentiles of login times, queries are counted from login request until results reach world thread
+class LoginTimeStats
+{
+    public:
+        LoginTimeStats() : m_logins(0), m_lastLogTime(WorldTimer::getMSTime()) {}
+
+        void Add(uint32 queryTime, uint32 totalTime)
+        {
+            ++m_logins;
+            if (m_queryTimes.size() < LOGIN_STATS_MAX_SAMPLES)
+            {
+                m_queryTimes.push_back(queryTime);
+                m_totalTimes.push_back(totalTime);
+            }
+
+            uint32 now = WorldTimer::getMSTime();
+            if (WorldTimer::getMSTimeDiff(m_lastLogTime, now) >= LOGIN_STATS_INTERVAL)
+            {
+                m_lastLogTime = now;
+                LogStats();
+            }
+        }
+
+    private:
+        static uint32 Percentile(std::vector<uint32> const& sorted, uint32 percent)
+        {
+            return sorted[(sorted.size() - 1) * percent / 100];
+        }
+
+        void LogStats()
+        {
+            std::sort(m_queryTimes.begin(), m_queryTimes.end());
+            std::sort(m_totalTimes.begin(), m_totalTimes.end());
+
+            sLog.outDetail("Player logins: %u, queries p50 %u ms p95 %u ms p99 %u ms, total p50 %u ms p95 %u ms p99 %u ms max %u ms",
+                           m_logins, Percentile(m_queryTimes, 50), Percentile(m_queryTimes, 95), Percentile(m_queryTimes, 99),
+                           Percentile(m_totalTimes, 50), Percentile(m_totalTimes, 95), Percentile(m_totalTimes, 99), m_totalTimes.back());
+
+            m_logins = 0;
+            m_queryTimes.clear();
+            m_totalTimes.clear();
+        }
+
+        uint32 m_logins;
+        std::vector<uint32> m_queryTimes;
+        std::vector<uint32> m_totalTimes;
+        uint32 m_lastLogTime;
+};
+
+static LoginTimeStats loginTimeStats;
+
 bool LoginQueryHolder::Initialize()
 {
     SetSize(MAX_PLAYER_LOGIN_QUERY);
@@ -179,6 +239,7 @@ void WorldSession::HandleCharEnum(QueryResult* result)
     SendPacket(data);
 }
 
+// thread-safe: only queues async query, result is handled by world thread
 void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
 {
     /// get all the data necessary for loading all characters (along with their pets) on the account
@@ -524,6 +585,7 @@ void PlayerbotMgr::LoginPlayerBot(ObjectGuid playerGuid)
 void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 {
     ObjectGuid playerGuid = holder->GetGuid();
+    uint32 queryTime = WorldTimer::getMSTimeDiff(holder->GetStartTime(), WorldTimer::getMSTime());
 
     Player* pCurrChar = new Player(this);
     pCurrChar->GetMotionMaster()->Initialize();
@@ -739,6 +801,10 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
     if (!pCurrChar->IsStandState() && !pCurrChar->hasUnitState(UNIT_STAT_STUNNED))
         pCurrChar->SetStandState(UNIT_STAND_STATE_STAND);
 
+    // bots have no socket, their logins are not waited for by any client
+    if (m_Socket)
+        loginTimeStats.Add(queryTime, WorldTimer::getMSTimeDiff(holder->GetStartTime(), WorldTimer::getMSTime()));
+
     m_playerLoading = false;
     delete holder;
 }
@@ -628,6 +628,18 @@ void Creature::Update(uint32 update_diff, uint32 diff)
     }
 }
 
+uint32 Creature::GetUpdateLodInterval(CreatureUpdateLod lod) const
+{
+    if (lod == CREATURE_LOD_NEAR)
+        return 0;
+
+    // creatures which state players can notice at any distance keep full rate
+    if (isInCombat() || IsInEvadeMode() || isActiveObject() || GetMasterGuid() || IsNonMeleeSpellCasted(false))
+        return 0;
+
+    return sWorld.getConfig(lod == CREATURE_LOD_FAR ? CONFIG_UINT32_CREATURE_LOD_FAR_INTERVAL : CONFIG_UINT32_CREATURE_LOD_UNOBSERVED_INTERVAL);
+}
+
 void Creature::RegenerateAll(uint32 update_diff)
 {
     if (m_regenTimer > 0)
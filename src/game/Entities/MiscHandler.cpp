@@ -951,6 +951,7 @@ void WorldSession::HandleMoveRootAck(WorldPacket& recv_data)
     */
 }
 
+// thread-safe: without player only logged, player in world is updated in Map::Update()
 void WorldSession::HandleSetActionBarTogglesOpcode(WorldPacket& recv_data)
 {
     uint8 ActionBar;
@@ -1260,6 +1261,7 @@ void WorldSession::HandleComplainChat(WorldPacket& recv_data)
     DEBUG_LOG("REPORT SPAM CHAT: Spammer %s, unk1 %u, messageType %u, channelId %u, secondsSinceMessage %u, description %s", spammer.GetString().c_str(), unk1, messageType, channelId, secondsSinceMessage, description.c_str());
 }
 
+// thread-safe: only answers with constant realm state
 void WorldSession::HandleRealmSplitOpcode(WorldPacket& recv_data)
 {
     DEBUG_LOG("WORLD: Received opcode CMSG_REALM_SPLIT");
@@ -1445,6 +1447,7 @@ void WorldSession::HandleRequestPetInfoOpcode(WorldPacket& /*recv_data */)
         _player->CharmSpellInitialize();
 }
 
+// thread-safe: only logged
 void WorldSession::HandleSetTaxiBenchmarkOpcode(WorldPacket& recv_data)
 {
     uint8 mode;
@@ -24,6 +24,9 @@
 #include "World/World.h"
 #include "Entities/Creature.h"
 #include "Entities/Player.h"
+#include "Entities/GameObject.h"
+#include "Entities/DynamicObject.h"
+#include "Entities/Corpse.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
 #include "Entities/UpdateData.h"
@@ -975,10 +978,18 @@ void WorldObject::_Create(uint32 guidlow, HighGuid guidhigh)
 
 void WorldObject::Relocate(float x, float y, float z, float orientation)
 {
+    if (isType(TYPEMASK_UNIT) && IsInWorld())
+    {
+        UnitPositionIndex& positionIndex = GetMap()->GetUnitPositionIndex();
+        positionIndex.Invalidate(m_position.x, m_position.y);
+        positionIndex.Invalidate(x, y);
+    }
+
     m_position.x = x;
     m_position.y = y;
     m_position.z = z;
     m_position.o = orientation;
+    UpdateGridHotPosition();
 
     if (isType(TYPEMASK_UNIT))
         ((Unit*)this)->m_movementInfo.ChangePosition(x, y, z, orientation);
@@ -986,14 +997,55 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
 
 void WorldObject::Relocate(float x, float y, float z)
 {
+    if (isType(TYPEMASK_UNIT) && IsInWorld())
+    {
+        UnitPositionIndex& positionIndex = GetMap()->GetUnitPositionIndex();
+        positionIndex.Invalidate(m_position.x, m_position.y);
+        positionIndex.Invalidate(x, y);
+    }
+
     m_position.x = x;
     m_position.y = y;
     m_position.z = z;
+    UpdateGridHotPosition();
 
     if (isType(TYPEMASK_UNIT))
         ((Unit*)this)->m_movementInfo.ChangePosition(x, y, z, GetOrientation());
 }
 
+void WorldObject::GetGridHotData(GridObjectHotData& data) const
+{
+    data.x = m_position.x;
+    data.y = m_position.y;
+    data.z = m_position.z;
+    data.typeMask = m_objectType;
+    data.guid = GetObjectGuid().GetRawValue();
+}
+
+void WorldObject::UpdateGridHotPosition()
+{
+    switch (GetTypeId())
+    {
+        case TYPEID_UNIT:
+            static_cast<Creature*>(this)->GetGridRef().UpdateHotPosition(m_position.x, m_position.y, m_position.z);
+            break;
+        case TYPEID_PLAYER:
+            static_cast<Player*>(this)->GetGridRef().UpdateHotPosition(m_position.x, m_position.y, m_position.z);
+            break;
+        case TYPEID_GAMEOBJECT:
+            static_cast<GameObject*>(this)->GetGridRef().UpdateHotPosition(m_position.x, m_position.y, m_position.z);
+            break;
+        case TYPEID_DYNAMICOBJECT:
+            static_cast<DynamicObject*>(this)->GetGridRef().UpdateHotPosition(m_position.x, m_position.y, m_position.z);
+            break;
+        case TYPEID_CORPSE:
+            static_cast<Corpse*>(this)->GetGridRef().UpdateHotPosition(m_position.x, m_position.y, m_position.z);
+            break;
+        default:
+            break;
+    }
+}
+
 void WorldObject::SetOrientation(float orientation)
 {
     m_position.o = orientation;
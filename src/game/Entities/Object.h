@@ -325,6 +325,23 @@ class WorldUpdateCounter
         uint32 m_tmStart;
 };
 
+// update rate level of creatures, by distance of nearest player to creature cell
+enum CreatureUpdateLod
+{
+    CREATURE_LOD_NEAR               = 0,                    // cell near to player, updated every tick
+    CREATURE_LOD_FAR                = 1,                    // cell in visibility range of player
+    CREATURE_LOD_UNOBSERVED         = 2,                    // cell updated only for active non-player objects
+};
+
+struct CreatureUpdateLodStats
+{
+    CreatureUpdateLodStats() : FullUpdates(0), ThrottledUpdates(0), DeferredUpdates(0) {}
+
+    uint32 FullUpdates;                                     // creatures updated every tick
+    uint32 ThrottledUpdates;                                // updates of far or unobserved creatures with accumulated diff
+    uint32 DeferredUpdates;                                 // updates of far or unobserved creatures left for later tick
+};
+
 class Object
 {
     public:
@@ -644,6 +661,18 @@ class WorldObject : public Object
                     m_obj->m_updateTracker.Reset();
                 }
 
+                // updates with time accumulated since last update when at least minInterval passed
+                bool UpdateThrottled(uint32 minInterval)
+                {
+                    uint32 elapsed = m_obj->m_updateTracker.timeElapsed();
+                    if (elapsed < minInterval)
+                        return false;
+
+                    m_obj->Update(elapsed, elapsed);
+                    m_obj->m_updateTracker.Reset();
+                    return true;
+                }
+
             private:
                 UpdateHelper(const UpdateHelper&);
                 UpdateHelper& operator=(const UpdateHelper&);
@@ -664,6 +693,10 @@ class WorldObject : public Object
         void Relocate(float x, float y, float z, float orientation);
         void Relocate(float x, float y, float z);
 
+        // cell visitors hot data, see GridRefManager
+        static bool const HasGridHotData = true;
+        void GetGridHotData(GridObjectHotData& data) const;
+
         void SetOrientation(float orientation);
 
         float GetPositionX() const { return m_position.x; }
@@ -883,6 +916,8 @@ class WorldObject : public Object
     protected:
         explicit WorldObject();
 
+        void UpdateGridHotPosition();
+
         // these functions are used mostly for Relocate() and Corpse/Player specific stuff...
         // use them ONLY in LoadFromDB()/Create() funcs and nowhere else!
         // mapId/instanceId should be set in SetMap() function!
@@ -464,6 +464,7 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
     SetGroupInvite(nullptr);
     m_groupUpdateMask = 0;
     m_auraUpdateMask = 0;
+    m_groupUpdateTimer = 0;
 
     duel = nullptr;
 
@@ -1409,7 +1410,7 @@ void Player::Update(uint32 update_diff, uint32 p_time)
         m_createdInstanceClearTimer -= update_diff;
 
     // Group update
-    SendUpdateToOutOfRangeGroupMembers();
+    SendUpdateToOutOfRangeGroupMembers(update_diff);
 
     Pet* pet = GetPet();
     if (pet && !pet->IsWithinDistInMap(this, GetMap()->GetVisibilityDistance()) && (GetCharmGuid() && (pet->GetObjectGuid() != GetCharmGuid())))
@@ -18818,10 +18819,21 @@ void Player::SendInitialPacketsAfterAddToMap()
     SendItemDurations();                                    // must be after add to map
 }
 
-void Player::SendUpdateToOutOfRangeGroupMembers()
+void Player::SendUpdateToOutOfRangeGroupMembers(uint32 diff)
 {
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_GROUP_OUT_OF_RANGE_UPDATE_INTERVAL);
+    if (m_groupUpdateTimer < interval)
+        m_groupUpdateTimer += diff;
+
     if (m_groupUpdateMask == GROUP_UPDATE_FLAG_NONE)
         return;
+
+    // health, power, position and aura changes are collected until interval passed, every one of them in raid is a packet to all far members
+    if (!(m_groupUpdateMask & GROUP_UPDATE_FLAGS_URGENT) && m_groupUpdateTimer < interval)
+        return;
+
+    m_groupUpdateTimer = 0;
+
     if (Group* group = GetGroup())
         group->UpdatePlayerOutOfRange(this);
 
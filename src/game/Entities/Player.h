@@ -1590,7 +1590,7 @@ class Player : public Unit
         void UninviteFromGroup();
         static void RemoveFromGroup(Group* group, ObjectGuid guid);
         void RemoveFromGroup() { RemoveFromGroup(GetGroup(), GetObjectGuid()); }
-        void SendUpdateToOutOfRangeGroupMembers();
+        void SendUpdateToOutOfRangeGroupMembers(uint32 diff);
 
         void SetInGuild(uint32 GuildId) { SetUInt32Value(PLAYER_GUILDID, GuildId); }
         void SetRank(uint32 rankId) { SetUInt32Value(PLAYER_GUILDRANK, rankId); }
@@ -2412,6 +2412,7 @@ class Player : public Unit
         Group* m_groupInvite;
         uint32 m_groupUpdateMask;
         uint64 m_auraUpdateMask;
+        uint32 m_groupUpdateTimer;                          // time since last stats sent to out of range members
 
         // Player summoning
         time_t m_summon_expire;
@@ -22,6 +22,7 @@
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
 #include "World/World.h"
+#include "World/TickProfiler.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
@@ -490,7 +491,13 @@ void Unit::Update(uint32 update_diff, uint32 p_time)
     i_motionMaster.UpdateMotion(p_time);
 
     if (AI() && isAlive())
+    {
+#ifdef BUILD_PROFILER
+        uint32 scriptId = GetTypeId() == TYPEID_UNIT ? static_cast<Creature*>(this)->GetScriptId() : 0;
+        PROFILE_ZONE(PROFILE_SCRIPT, scriptId, scriptId ? sScriptDevAIMgr.GetScriptName(scriptId) : "no script");
+#endif
         AI()->UpdateAI(p_time);   // AI not react good at real update delays (while freeze in non-active part of map)
+    }
 
     if (isAlive())
     {
@@ -11492,8 +11499,9 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_Events = (*iter)->m_Events.GetEvents().begin(); i_Events != (*iter)->m_Events.GetEvents().end(); ++i_Events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_Events->second))
+        EventList events = (*iter)->m_Events.GetEvents();
+        for (auto i_Events = events.begin(); i_Events != events.end(); ++i_Events)
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(*i_Events))
                 if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
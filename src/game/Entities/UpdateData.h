@@ -60,11 +60,12 @@ class UpdateData
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        // zlib compression used by compressed packets, dst_size is 0 on failure
+        static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
-
-        static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
 };
 #endif
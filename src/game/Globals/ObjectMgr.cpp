@@ -1248,6 +1248,26 @@ void ObjectMgr::LoadCreatureModelRace()
     sLog.outString();
 }
 
+template<class T>
+static void AddSpawnToList(CellSpawnGuidList& spawns, uint32 guid, T const& data)
+{
+    CellPair cell_pair = MaNGOS::ComputeCellPair(data.posX, data.posY);
+    uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
+
+    uint8 mask = data.spawnMask;
+    for (uint8 i = 0; mask != 0; ++i, mask >>= 1)
+    {
+        if (mask & 1)
+        {
+            CellSpawnGuid spawn;
+            spawn.mapKey = MAKE_PAIR32(data.mapid, i);
+            spawn.cellId = cell_id;
+            spawn.guid = guid;
+            spawns.push_back(spawn);
+        }
+    }
+}
+
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
@@ -1282,6 +1302,9 @@ void ObjectMgr::LoadCreatures()
 
     BarGoLink bar(result->GetRowCount());
 
+    mCreatureDataMap.reserve(result->GetRowCount());
+    CellSpawnGuidList gridSpawns;
+
     do
     {
         Field* fields = result->Fetch();
@@ -1416,7 +1439,7 @@ void ObjectMgr::LoadCreatures()
 
         if (gameEvent == 0 && GuidPoolId == 0 && EntryPoolId == 0) // if not this is to be managed by GameEvent System or Pool system
         {
-            AddCreatureToGrid(guid, &data);
+            AddSpawnToList(gridSpawns, guid, data);
 
             if (cInfo->ExtraFlags & CREATURE_EXTRA_FLAG_ACTIVE)
                 m_activeCreatures.insert(ActiveCreatureGuidsOnMap::value_type(data.mapid, guid));
@@ -1428,6 +1451,8 @@ void ObjectMgr::LoadCreatures()
 
     delete result;
 
+    AddSpawnsToGrid(gridSpawns, &CellObjectGuids::creatures);
+
     sLog.outString(">> Loaded " SIZEFMTD " creatures", mCreatureDataMap.size());
     sLog.outString();
 }
@@ -1442,7 +1467,7 @@ void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
+            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)].Get(cell_id);
             cell_guids.creatures.insert(guid);
         }
     }
@@ -1458,7 +1483,7 @@ void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
+            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)].Get(cell_id);
             cell_guids.creatures.erase(guid);
         }
     }
@@ -1490,6 +1515,9 @@ void ObjectMgr::LoadGameObjects()
 
     BarGoLink bar(result->GetRowCount());
 
+    mGameObjectDataMap.reserve(result->GetRowCount());
+    CellSpawnGuidList gridSpawns;
+
     do
     {
         Field* fields = result->Fetch();
@@ -1600,7 +1628,7 @@ void ObjectMgr::LoadGameObjects()
         }
 
         if (gameEvent == 0 && GuidPoolId == 0 && EntryPoolId == 0) // if not this is to be managed by GameEvent System or Pool system
-            AddGameobjectToGrid(guid, &data);
+            AddSpawnToList(gridSpawns, guid, data);
 
         //uint32 zoneId, areaId;
         //sTerrainMgr.LoadTerrain(data.mapid)->GetZoneAndAreaId(zoneId, areaId, data.posX, data.posY, data.posZ);
@@ -1612,7 +1640,10 @@ void ObjectMgr::LoadGameObjects()
 
     delete result;
 
+    AddSpawnsToGrid(gridSpawns, &CellObjectGuids::gameobjects);
+
     sLog.outString(">> Loaded " SIZEFMTD " gameobjects", mGameObjectDataMap.size());
+    LogCellObjectGuidsStatistic();
     sLog.outString();
 }
 
@@ -1626,7 +1657,7 @@ void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
+            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)].Get(cell_id);
             cell_guids.gameobjects.insert(guid);
         }
     }
@@ -1642,7 +1673,7 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
+            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)].Get(cell_id);
             cell_guids.gameobjects.erase(guid);
         }
     }
@@ -5103,120 +5134,6 @@ void ObjectMgr::LoadAreatriggerLocales()
     sLog.outString();
 }
 
-// not very fast function but it is called only once a day, or on starting-up
-/// @param serverUp true if the server is already running, false when the server is started
-void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
-{
-    time_t basetime = time(nullptr);
-    DEBUG_LOG("Returning mails current time: hour: %d, minute: %d, second: %d ", localtime(&basetime)->tm_hour, localtime(&basetime)->tm_min, localtime(&basetime)->tm_sec);
-    // delete all old mails without item and without body immediately, if starting server
-    if (!serverUp)
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)basetime);
-    //                                                     0  1           2      3        4          5         6           7   8       9
-    QueryResult* result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,itemTextId,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
-    if (!result)
-    {
-        BarGoLink bar(1);
-        bar.step();
-        sLog.outString(">> Only expired mails (need to be return or delete) or DB table `mail` is empty.");
-        sLog.outString();
-        return;                                             // any mails need to be returned or deleted
-    }
-
-    // std::ostringstream delitems, delmails; // will be here for optimization
-    // bool deletemail = false, deleteitem = false;
-    // delitems << "DELETE FROM item_instance WHERE guid IN ( ";
-    // delmails << "DELETE FROM mail WHERE id IN ( "
-
-    BarGoLink bar(result->GetRowCount());
-    uint32 count = 0;
-    Field* fields;
-
-    do
-    {
-        bar.step();
-
-        fields = result->Fetch();
-        Mail* m = new Mail;
-        m->messageID = fields[0].GetUInt32();
-        m->messageType = fields[1].GetUInt8();
-        m->sender = fields[2].GetUInt32();
-        m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
-        bool has_items = fields[5].GetBool();
-        m->expire_time = (time_t)fields[6].GetUInt64();
-        m->deliver_time = 0;
-        m->COD = fields[7].GetUInt32();
-        m->checked = fields[8].GetUInt32();
-        m->mailTemplateId = fields[9].GetInt16();
-
-        Player* pl = nullptr;
-        if (serverUp)
-            pl = GetPlayer(m->receiverGuid);
-        if (pl)
-        {
-            // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
-            // his in mailbox and he has already listed his mails )
-            delete m;
-            continue;
-        }
-        // delete or return mail:
-        if (has_items)
-        {
-            QueryResult* resultItems = CharacterDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", m->messageID);
-            if (resultItems)
-            {
-                do
-                {
-                    Field* fields2 = resultItems->Fetch();
-
-                    uint32 item_guid_low = fields2[0].GetUInt32();
-                    uint32 item_template = fields2[1].GetUInt32();
-
-                    m->AddItem(item_guid_low, item_template);
-                }
-                while (resultItems->NextRow());
-
-                delete resultItems;
-            }
-            // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
-            if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
-            {
-                // mail open and then not returned
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                    CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid = '%u'", itr2->item_guid);
-            }
-            else
-            {
-                // mail will be returned:
-                CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "',cod = '0', checked = '%u' WHERE id = '%u'",
-                                           m->receiverGuid.GetCounter(), m->sender, (uint64)(basetime + 30 * DAY), (uint64)basetime, MAIL_CHECK_MASK_RETURNED, m->messageID);
-                for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
-                {
-                    // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
-                    CharacterDatabase.PExecute("UPDATE mail_items SET receiver = %u WHERE item_guid = '%u'", m->sender, itr2->item_guid);
-                    CharacterDatabase.PExecute("UPDATE item_instance SET owner_guid = %u WHERE guid = '%u'", m->sender, itr2->item_guid);
-                }
-                delete m;
-                continue;
-            }
-        }
-
-        if (m->itemTextId)
-            CharacterDatabase.PExecute("DELETE FROM item_text WHERE id = '%u'", m->itemTextId);
-
-        // deletemail = true;
-        // delmails << m->messageID << ", ";
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", m->messageID);
-        delete m;
-        ++count;
-    }
-    while (result->NextRow());
-    delete result;
-
-    sLog.outString(">> Loaded %u mails", count);
-    sLog.outString();
-}
-
 void ObjectMgr::LoadQuestAreaTriggers()
 {
     mQuestAreaTriggerMap.clear();                           // need for reload case
@@ -6936,17 +6853,137 @@ void ObjectMgr::DeleteGOData(uint32 guid)
     mGameObjectDataMap.erase(guid);
 }
 
+CellObjectGuids const* CellObjectGuidsMap::Find(uint32 cellId) const
+{
+    std::vector<uint32>::const_iterator itr = std::lower_bound(m_cellIds.begin(), m_cellIds.end(), cellId);
+    if (itr == m_cellIds.end() || *itr != cellId)
+        return nullptr;
+
+    return &m_cells[itr - m_cellIds.begin()];
+}
+
+CellObjectGuids& CellObjectGuidsMap::Get(uint32 cellId)
+{
+    std::vector<uint32>::iterator itr = std::lower_bound(m_cellIds.begin(), m_cellIds.end(), cellId);
+    size_t index = itr - m_cellIds.begin();
+    if (itr == m_cellIds.end() || *itr != cellId)
+    {
+        m_cellIds.insert(itr, cellId);
+        m_cells.insert(m_cells.begin() + index, CellObjectGuids());
+    }
+
+    return m_cells[index];
+}
+
+void CellObjectGuidsMap::AddSorted(CellSpawnGuidList::const_iterator begin, CellSpawnGuidList::const_iterator end, CellGuidSet CellObjectGuids::* guids)
+{
+    // merge existing cells with new ones in one pass instead of inserting cells one by one
+    std::vector<uint32> cellIds;
+    std::vector<CellObjectGuids> cells;
+    cellIds.reserve(m_cellIds.size() + std::distance(begin, end));
+    cells.reserve(m_cells.size() + std::distance(begin, end));
+
+    size_t old = 0;
+    for (CellSpawnGuidList::const_iterator itr = begin; itr != end; ++itr)
+    {
+        while (old < m_cellIds.size() && m_cellIds[old] < itr->cellId)
+        {
+            cellIds.push_back(m_cellIds[old]);
+            cells.push_back(std::move(m_cells[old]));
+            ++old;
+        }
+
+        if (cellIds.empty() || cellIds.back() != itr->cellId)
+        {
+            cellIds.push_back(itr->cellId);
+            if (old < m_cellIds.size() && m_cellIds[old] == itr->cellId)
+                cells.push_back(std::move(m_cells[old++]));
+            else
+                cells.push_back(CellObjectGuids());
+        }
+
+        (cells.back().*guids).insert(itr->guid);
+    }
+
+    for (; old < m_cellIds.size(); ++old)
+    {
+        cellIds.push_back(m_cellIds[old]);
+        cells.push_back(std::move(m_cells[old]));
+    }
+
+    for (std::vector<CellObjectGuids>::iterator itr = cells.begin(); itr != cells.end(); ++itr)
+        ((*itr).*guids).shrink_to_fit();
+
+    cellIds.shrink_to_fit();
+    cells.shrink_to_fit();
+    m_cellIds.swap(cellIds);
+    m_cells.swap(cells);
+}
+
+void CellObjectGuidsMap::GetStatistic(uint32& cells, uint32& guids, size_t& memory) const
+{
+    cells += m_cells.size();
+    memory += m_cellIds.capacity() * sizeof(uint32) + m_cells.capacity() * sizeof(CellObjectGuids);
+
+    for (std::vector<CellObjectGuids>::const_iterator itr = m_cells.begin(); itr != m_cells.end(); ++itr)
+    {
+        guids += itr->creatures.size() + itr->gameobjects.size();
+        memory += (itr->creatures.capacity() + itr->gameobjects.capacity()) * sizeof(uint32);
+    }
+}
+
+CellObjectGuids const& ObjectMgr::GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id) const
+{
+    static CellObjectGuids const emptyCell;
+
+    MapObjectGuids::const_iterator itr = mMapObjectGuids.find(MAKE_PAIR32(mapid, spawnMode));
+    if (itr == mMapObjectGuids.end())
+        return emptyCell;
+
+    CellObjectGuids const* cell_guids = itr->second.Find(cell_id);
+    return cell_guids ? *cell_guids : emptyCell;
+}
+
+void ObjectMgr::AddSpawnsToGrid(CellSpawnGuidList& spawns, CellGuidSet CellObjectGuids::* guids)
+{
+    std::sort(spawns.begin(), spawns.end());
+
+    for (CellSpawnGuidList::const_iterator itr = spawns.begin(); itr != spawns.end();)
+    {
+        CellSpawnGuidList::const_iterator mapEnd = itr;
+        while (mapEnd != spawns.end() && mapEnd->mapKey == itr->mapKey)
+            ++mapEnd;
+
+        mMapObjectGuids[itr->mapKey].AddSorted(itr, mapEnd, guids);
+        itr = mapEnd;
+    }
+}
+
+void ObjectMgr::LogCellObjectGuidsStatistic() const
+{
+    uint32 cells = 0, guids = 0;
+    size_t memory = 0;
+    for (MapObjectGuids::const_iterator itr = mMapObjectGuids.begin(); itr != mMapObjectGuids.end(); ++itr)
+        itr->second.GetStatistic(cells, guids, memory);
+
+    // previous layout: hash map node per cell holding two std::set and std::map, std::set node per guid
+    size_t setLayoutMemory = cells * (sizeof(void*) * 2 + sizeof(uint32) + sizeof(std::set<uint32>) * 2 + sizeof(CellCorpseSet)) +
+                             guids * (sizeof(void*) * 4 + sizeof(uint32) * 2);
+
+    sLog.outString(">> Spawn grid index: %u cells, %u guids, " SIZEFMTD " KB (" SIZEFMTD " KB in node based layout)", cells, guids, memory / 1024, setLayoutMemory / 1024);
+}
+
 void ObjectMgr::AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid, uint32 instance)
 {
     // corpses are always added to spawn mode 0 and they are spawned by their instance id
-    CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid, 0)][cellid];
+    CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid, 0)].Get(cellid);
     cell_guids.corpses[player_guid] = instance;
 }
 
 void ObjectMgr::DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid)
 {
     // corpses are always added to spawn mode 0 and they are spawned by their instance id
-    CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid, 0)][cellid];
+    CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid, 0)].Get(cellid);
     cell_guids.corpses.erase(player_guid);
 }
 
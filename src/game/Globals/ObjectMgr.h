@@ -95,7 +95,43 @@ struct CellObjectGuids
     CellGuidSet gameobjects;
     CellCorpseSet corpses;
 };
-typedef std::unordered_map<uint32/*cell_id*/, CellObjectGuids> CellObjectGuidsMap;
+
+// static spawn of loaded DB table, grouped by map and cell before adding to grid spawn index
+struct CellSpawnGuid
+{
+    uint32 mapKey;                                          // (mapid,spawnMode) pair
+    uint32 cellId;
+    uint32 guid;
+
+    bool operator<(CellSpawnGuid const& other) const
+    {
+        if (mapKey != other.mapKey)
+            return mapKey < other.mapKey;
+        if (cellId != other.cellId)
+            return cellId < other.cellId;
+        return guid < other.guid;
+    }
+};
+
+typedef std::vector<CellSpawnGuid> CellSpawnGuidList;
+
+// cells of one map and spawn mode having spawns, sorted by cell id
+class CellObjectGuidsMap
+{
+    public:
+        CellObjectGuids const* Find(uint32 cellId) const;
+        CellObjectGuids& Get(uint32 cellId);                // add cell if not exist
+
+        // add spawns of this map and spawn mode sorted by cell and guid
+        void AddSorted(CellSpawnGuidList::const_iterator begin, CellSpawnGuidList::const_iterator end, CellGuidSet CellObjectGuids::* guids);
+
+        void GetStatistic(uint32& cells, uint32& guids, size_t& memory) const;
+
+    private:
+        std::vector<uint32> m_cellIds;                      // searched separately from cell data
+        std::vector<CellObjectGuids> m_cells;
+};
+
 typedef std::unordered_map<uint32/*(mapid,spawnMode) pair*/, CellObjectGuidsMap> MapObjectGuids;
 
 // mangos string ranges
@@ -753,8 +789,6 @@ class ObjectMgr
             return itr != mFishingBaseForArea.end() ? itr->second : 0;
         }
 
-        void ReturnOrDeleteOldMails(bool serverUp);
-
         void SetHighestGuids();
 
         // used for set initial guid counter for map local guids
@@ -953,10 +987,8 @@ class ObjectMgr
         void SetDBCLocaleIndex(uint32 lang) { DBCLocaleIndex = GetIndexForLocale(LocaleConstant(lang)); }
 
         // global grid objects state (static DB spawns, global spawn mods from gameevent system)
-        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id)
-        {
-            return mMapObjectGuids[MAKE_PAIR32(mapid, spawnMode)][cell_id];
-        }
+        // not modify index, so can be called from map threads
+        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id) const;
 
         // modifiers for global grid objects state (static DB spawns, global spawn mods from gameevent system)
         // Don't must be used for modify instance specific spawn state modifications
@@ -1193,6 +1225,8 @@ class ObjectMgr
         void LoadCreatureAddons(SQLStorage& creatureaddons, char const* entryName, char const* comment);
         void ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr);
         void LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table);
+        void AddSpawnsToGrid(CellSpawnGuidList& spawns, CellGuidSet CellObjectGuids::* guids);
+        void LogCellObjectGuidsStatistic() const;
         void LoadVendors(char const* tableName, bool isTemplates);
         void LoadTrainers(char const* tableName, bool isTemplates);
 
@@ -111,7 +111,9 @@ namespace MaNGOS
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32& diff) : i_timeDiff(diff) {}
+        CreatureUpdateLod i_lod;                            // update rate level of visited cell
+        CreatureUpdateLodStats* i_stats;                    // nullptr when update rate levels are disabled
+        explicit ObjectUpdater(const uint32& diff, CreatureUpdateLodStats* stats = nullptr) : i_timeDiff(diff), i_lod(CREATURE_LOD_NEAR), i_stats(stats) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(PlayerMapType&) {}
         void Visit(CorpseMapType&) {}
@@ -341,13 +343,13 @@ namespace MaNGOS
     };
 
     // All accepted by Check units if any
-    template<class Check>
+    template<class Check, class Container = std::list<Unit*> >
     struct UnitListSearcher
     {
-        std::list<Unit*>& i_objects;
+        Container& i_objects;
         Check& i_check;
 
-        UnitListSearcher(std::list<Unit*>& objects, Check& check) : i_objects(objects), i_check(check) {}
+        UnitListSearcher(Container& objects, Check& check) : i_objects(objects), i_check(check) {}
 
         void Visit(PlayerMapType& m);
         void Visit(CreatureMapType& m);
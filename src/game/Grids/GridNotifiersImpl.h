@@ -44,8 +44,20 @@ inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        WorldObject::UpdateHelper helper(iter->getSource());
-        helper.Update(i_timeDiff);
+        Creature* creature = iter->getSource();
+        WorldObject::UpdateHelper helper(creature);
+
+        uint32 minInterval = i_stats ? creature->GetUpdateLodInterval(i_lod) : 0;
+        if (!minInterval)
+        {
+            helper.Update(i_timeDiff);
+            if (i_stats)
+                ++i_stats->FullUpdates;
+        }
+        else if (helper.UpdateThrottled(minInterval))
+            ++i_stats->ThrottledUpdates;
+        else
+            ++i_stats->DeferredUpdates;
     }
 }
 
@@ -456,16 +468,16 @@ void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
     }
 }
 
-template<class Check>
-void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
+template<class Check, class Container>
+void MaNGOS::UnitListSearcher<Check, Container>::Visit(PlayerMapType& m)
 {
     for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
             i_objects.push_back(itr->getSource());
 }
 
-template<class Check>
-void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
+template<class Check, class Container>
+void MaNGOS::UnitListSearcher<Check, Container>::Visit(CreatureMapType& m)
 {
     for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         if (i_check(itr->getSource()))
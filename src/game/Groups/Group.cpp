@@ -29,10 +29,42 @@
 #include "BattleGround/BattleGround.h"
 #include "Maps/MapManager.h"
 #include "Maps/MapPersistentStateMgr.h"
+#include "World/World.h"
+
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotMgr.h"
 #endif
 
+#define GROUP_MEMBER_STATS_INTERVAL (10 * MINUTE * IN_MILLISECONDS)
+
+namespace
+{
+    // SMSG_PARTY_MEMBER_STATS sent to out of range members, updated only from world thread (map updates are serial)
+    struct MemberStatsCounters
+    {
+        MemberStatsCounters() : Updates(0), Packets(0), Bytes(0) {}
+
+        uint32 Updates;                                     // built packets, one per member change
+        uint32 Packets;                                     // sent copies
+        uint64 Bytes;
+    };
+
+    MemberStatsCounters memberStatsCounters[MAX_GROUP_SIZE_CLASS];
+    char const* groupSizeClassNames[MAX_GROUP_SIZE_CLASS] = { "party", "raid 10", "raid 25", "raid 40" };
+    uint32 memberStatsTimer = 0;
+
+    GroupSizeClass GetGroupSizeClass(uint32 members)
+    {
+        if (members <= MAX_GROUP_SIZE)
+            return GROUP_SIZE_PARTY;
+        if (members <= 10)
+            return GROUP_SIZE_RAID_10;
+        if (members <= 25)
+            return GROUP_SIZE_RAID_25;
+        return GROUP_SIZE_RAID_40;
+    }
+}
+
 GroupMemberStatus GetGroupMemberStatus(const Player* member = nullptr)
 {
     if (!member || !member->GetSession() || (!member->IsInWorld() && !member->IsBeingTeleportedFar()))
@@ -594,13 +626,51 @@ void Group::UpdatePlayerOutOfRange(Player* pPlayer)
     if (pPlayer->GetGroupUpdateFlag() == GROUP_UPDATE_FLAG_NONE)
         return;
 
+    // in range members get changes with object updates, packet is built only if anyone else needs it
     WorldPacket data;
-    pPlayer->GetSession()->BuildPartyMemberStatsChangedPacket(pPlayer, data);
-
+    uint32 recipients = 0;
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
+    {
         if (Player* player = itr->getSource())
+        {
             if (player != pPlayer && !player->HaveAtClient(pPlayer))
+            {
+                if (!recipients)
+                    pPlayer->GetSession()->BuildPartyMemberStatsChangedPacket(pPlayer, data);
+
                 player->GetSession()->SendPacket(data);
+                ++recipients;
+            }
+        }
+    }
+
+    if (!recipients)
+        return;
+
+    MemberStatsCounters& counters = memberStatsCounters[GetGroupSizeClass(GetMembersCount())];
+    ++counters.Updates;
+    counters.Packets += recipients;
+    counters.Bytes += uint64(recipients) * (data.size() + 4);   // with server packet header
+}
+
+void Group::UpdateMemberStatsCounters(uint32 diff)
+{
+    memberStatsTimer += diff;
+    if (memberStatsTimer < GROUP_MEMBER_STATS_INTERVAL)
+        return;
+
+    memberStatsTimer = 0;
+
+    for (uint32 i = 0; i < MAX_GROUP_SIZE_CLASS; ++i)
+    {
+        MemberStatsCounters& counters = memberStatsCounters[i];
+        if (!counters.Updates)
+            continue;
+
+        sLog.outDetail("Group member stats (%s): %u updates sent as %u packets, " UI64FMTD " KB",
+                       groupSizeClassNames[i], counters.Updates, counters.Packets, counters.Bytes / 1024);
+        counters = MemberStatsCounters();
+    }
 }
 
 void Group::UpdatePlayerOnlineStatus(Player* player, bool online /*= true*/)
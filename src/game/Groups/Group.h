@@ -91,9 +91,23 @@ enum GroupUpdateFlags
     GROUP_UPDATE_FLAG_PET_AURAS         = 0x00040000,       // uint64 mask, for each bit set uint16 spellid + uint8 unk, pet auras...
     GROUP_UPDATE_PET                    = 0x0007FC00,       // all pet flags
     GROUP_UPDATE_FULL                   = 0x0007FFFF,       // all known flags
+    // changes sent to out of range members without Group.OutOfRangeUpdateInterval delay
+    GROUP_UPDATE_FLAGS_URGENT           = GROUP_UPDATE_FLAG_STATUS | GROUP_UPDATE_FLAG_POWER_TYPE | GROUP_UPDATE_FLAG_LEVEL | GROUP_UPDATE_FLAG_ZONE |
+                                          GROUP_UPDATE_FLAG_PET_GUID | GROUP_UPDATE_FLAG_PET_NAME | GROUP_UPDATE_FLAG_PET_MODEL_ID | GROUP_UPDATE_FLAG_PET_POWER_TYPE,
 };
 
 #define GROUP_UPDATE_FLAGS_COUNT          20
+
+// for SMSG_PARTY_MEMBER_STATS bandwidth statistics
+enum GroupSizeClass
+{
+    GROUP_SIZE_PARTY                    = 0,                // up to 5 members
+    GROUP_SIZE_RAID_10                  = 1,
+    GROUP_SIZE_RAID_25                  = 2,
+    GROUP_SIZE_RAID_40                  = 3,
+};
+
+#define MAX_GROUP_SIZE_CLASS              4
 // 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,11,12,13,14,15,16,17,18,19
 static const uint8 GroupUpdateLength[GROUP_UPDATE_FLAGS_COUNT] = { 0, 2, 2, 2, 1, 2, 2, 2, 2, 4, 8, 8, 1, 2, 2, 2, 1, 2, 2, 8};
 
@@ -245,6 +259,7 @@ class Group
         void SendTargetIconList(WorldSession* session) const;
         void SendUpdate();
         void UpdatePlayerOutOfRange(Player* pPlayer);
+        static void UpdateMemberStatsCounters(uint32 diff); // periodic log of out of range member stats bandwidth
         void UpdatePlayerOnlineStatus(Player* player, bool online = true);
         void UpdateOfflineLeader(time_t time, uint32 delay);
         // ignore: GUID of player that will be ignored
@@ -0,0 +1,339 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/**
+ * @addtogroup mailing
+ * @{
+ *
+ * @file MailExpiryMgr.cpp
+ * This file contains the code needed for MaNGOS to return or delete expired mails without stalling world update.
+ *
+ */
+
+#include "Mails/MailExpiryMgr.h"
+#include "Mails/Mail.h"
+#include "Policies/Singleton.h"
+#include "Database/DatabaseEnv.h"
+#include "Database/DatabaseImpl.h"
+#include "Globals/ObjectMgr.h"
+#include "World/World.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+INSTANTIATE_SINGLETON_1(MailExpiryMgr);
+
+// max ids in one IN (...) list of expiry statements
+#define MAIL_EXPIRY_MAX_IDS_PER_STATEMENT 1000
+
+namespace
+{
+    void AppendIdList(std::ostringstream& ss, std::vector<uint32>::const_iterator begin, std::vector<uint32>::const_iterator end)
+    {
+        ss << "(";
+        for (std::vector<uint32>::const_iterator itr = begin; itr != end; ++itr)
+        {
+            if (itr != begin)
+                ss << ",";
+            ss << *itr;
+        }
+        ss << ")";
+    }
+
+    void AppendIdList(std::ostringstream& ss, std::vector<uint32> const& ids)
+    {
+        AppendIdList(ss, ids.begin(), ids.end());
+    }
+
+    // statement ends with IN, executed once per chunk of ids
+    void ExecuteForIds(std::string const& statement, std::vector<uint32> const& ids)
+    {
+        for (size_t first = 0; first < ids.size(); first += MAIL_EXPIRY_MAX_IDS_PER_STATEMENT)
+        {
+            size_t last = std::min(ids.size(), first + MAIL_EXPIRY_MAX_IDS_PER_STATEMENT);
+
+            std::ostringstream ss;
+            ss << statement << " ";
+            AppendIdList(ss, ids.begin() + first, ids.begin() + last);
+            CharacterDatabase.Execute(ss.str().c_str());
+        }
+    }
+
+    // returned mails grouped by their original sender, who becomes new receiver
+    struct ReturnGroup
+    {
+        std::vector<uint32> mailIds;
+        std::vector<uint32> itemGuids;
+    };
+}
+
+MailExpiryMgr::MailExpiryMgr() : m_state(EXPIRY_STATE_IDLE), m_baseTime(0), m_lastMailId(0), m_applyIndex(0), m_batchFull(false), m_batchHasItems(false),
+    m_returnedCount(0), m_deletedCount(0), m_skippedCount(0)
+{
+}
+
+void MailExpiryMgr::ReturnOrDeleteOldMails(bool serverUp)
+{
+    if (m_state != EXPIRY_STATE_IDLE)
+    {
+        sLog.outError("MailExpiryMgr: previous return of expired mails not finished yet, skipped.");
+        return;
+    }
+
+    m_baseTime = time(nullptr);
+    m_lastMailId = 0;
+    m_returnedCount = 0;
+    m_deletedCount = 0;
+    m_skippedCount = 0;
+
+    DEBUG_LOG("Returning mails current time: hour: %d, minute: %d, second: %d ", localtime(&m_baseTime)->tm_hour, localtime(&m_baseTime)->tm_min, localtime(&m_baseTime)->tm_sec);
+
+    if (serverUp)
+    {
+        RequestBatch();
+        return;
+    }
+
+    // delete all old mails without item and without body immediately, if starting server
+    CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND itemTextId = 0", (uint64)m_baseTime);
+
+    // no players in world yet, so all batches can be done at once
+    for (;;)
+    {
+        if (!FillMails(CharacterDatabase.PQuery("%s", GetMailsQuery().c_str())))
+            break;
+
+        if (m_batchHasItems)
+            FillItems(CharacterDatabase.PQuery("%s", GetItemsQuery().c_str()));
+
+        ApplyMails(m_batch.size(), false);
+
+        if (!m_batchFull)
+            break;
+    }
+
+    Finish();
+    sLog.outString();
+}
+
+void MailExpiryMgr::Update()
+{
+    if (m_state != EXPIRY_STATE_APPLYING)
+        return;
+
+    ApplyMails(sWorld.getConfig(CONFIG_UINT32_MAIL_EXPIRY_APPLY_PER_TICK), true);
+
+    if (m_applyIndex < m_batch.size())
+        return;
+
+    if (m_batchFull)
+        RequestBatch();
+    else
+        Finish();
+}
+
+std::string MailExpiryMgr::GetMailsQuery() const
+{
+    std::ostringstream ss;
+    //        0  1           2      3        4          5         6
+    ss << "SELECT id,messageType,sender,receiver,itemTextId,has_items,checked FROM mail"
+       << " WHERE expire_time < '" << uint64(m_baseTime) << "' AND id > '" << m_lastMailId << "'"
+       << " ORDER BY id LIMIT " << sWorld.getConfig(CONFIG_UINT32_MAIL_EXPIRY_BATCH_SIZE);
+    return ss.str();
+}
+
+std::string MailExpiryMgr::GetItemsQuery() const
+{
+    std::vector<uint32> mailIds;
+    for (std::vector<ExpiredMail>::const_iterator itr = m_batch.begin(); itr != m_batch.end(); ++itr)
+        if (itr->hasItems)
+            mailIds.push_back(itr->id);
+
+    std::ostringstream ss;
+    ss << "SELECT mail_id,item_guid FROM mail_items WHERE mail_id IN ";
+    AppendIdList(ss, mailIds);
+    return ss.str();
+}
+
+// returns false if there are no more expired mails
+bool MailExpiryMgr::FillMails(QueryResult* result)
+{
+    m_batch.clear();
+    m_applyIndex = 0;
+    m_batchFull = false;
+    m_batchHasItems = false;
+
+    if (!result)
+        return false;
+
+    m_batch.reserve(result->GetRowCount());
+    do
+    {
+        Field* fields = result->Fetch();
+
+        ExpiredMail mail;
+        mail.id = fields[0].GetUInt32();
+        mail.messageType = fields[1].GetUInt8();
+        mail.sender = fields[2].GetUInt32();
+        mail.receiver = fields[3].GetUInt32();
+        mail.itemTextId = fields[4].GetUInt32();
+        mail.hasItems = fields[5].GetBool();
+        mail.checked = fields[6].GetUInt32();
+
+        m_batchHasItems |= mail.hasItems;
+        m_batch.push_back(mail);
+    }
+    while (result->NextRow());
+    delete result;
+
+    m_lastMailId = m_batch.back().id;
+    m_batchFull = m_batch.size() >= sWorld.getConfig(CONFIG_UINT32_MAIL_EXPIRY_BATCH_SIZE);
+    return true;
+}
+
+void MailExpiryMgr::FillItems(QueryResult* result)
+{
+    if (!result)
+        return;
+
+    // batch is sorted by mail id
+    do
+    {
+        Field* fields = result->Fetch();
+        uint32 mailId = fields[0].GetUInt32();
+
+        ExpiredMail key;
+        key.id = mailId;
+        std::vector<ExpiredMail>::iterator itr = std::lower_bound(m_batch.begin(), m_batch.end(), key,
+                [](ExpiredMail const& a, ExpiredMail const& b) { return a.id < b.id; });
+        if (itr != m_batch.end() && itr->id == mailId)
+            itr->items.push_back(fields[1].GetUInt32());
+    }
+    while (result->NextRow());
+    delete result;
+}
+
+void MailExpiryMgr::ApplyMails(uint32 count, bool serverUp)
+{
+    std::vector<uint32> deleteMails, deleteTexts, deleteItems;
+    std::map<uint32, ReturnGroup> returnGroups;
+
+    CharacterDatabase.BeginTransaction();
+
+    uint32 end = std::min(uint32(m_batch.size()), m_applyIndex + count);
+    for (; m_applyIndex < end; ++m_applyIndex)
+    {
+        ExpiredMail const& mail = m_batch[m_applyIndex];
+
+        // receiver mails are loaded, player handles their expiry itself
+        if (serverUp && sObjectMgr.GetPlayer(ObjectGuid(HIGHGUID_PLAYER, mail.receiver)))
+        {
+            ++m_skippedCount;
+            continue;
+        }
+
+        if (mail.hasItems)
+        {
+            // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
+            if (mail.messageType != MAIL_NORMAL || (mail.checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
+                deleteItems.insert(deleteItems.end(), mail.items.begin(), mail.items.end());
+            else
+            {
+                // mail will be returned
+                ReturnGroup& group = returnGroups[mail.sender];
+                group.mailIds.push_back(mail.id);
+                group.itemGuids.insert(group.itemGuids.end(), mail.items.begin(), mail.items.end());
+                ++m_returnedCount;
+                continue;
+            }
+        }
+
+        if (mail.itemTextId)
+            deleteTexts.push_back(mail.itemTextId);
+
+        deleteMails.push_back(mail.id);
+        ++m_deletedCount;
+    }
+
+    // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
+    for (std::map<uint32, ReturnGroup>::const_iterator itr = returnGroups.begin(); itr != returnGroups.end(); ++itr)
+    {
+        // old receiver becomes sender, assignment reads receiver before it is changed
+        std::ostringstream ss;
+        ss << "UPDATE mail SET sender = receiver, receiver = " << itr->first << ", expire_time = " << uint64(m_baseTime + 30 * DAY)
+           << ", deliver_time = " << uint64(m_baseTime) << ", cod = 0, checked = " << uint32(MAIL_CHECK_MASK_RETURNED) << " WHERE id IN";
+        ExecuteForIds(ss.str(), itr->second.mailIds);
+
+        ss.str("");
+        ss << "UPDATE mail_items SET receiver = " << itr->first << " WHERE mail_id IN";
+        ExecuteForIds(ss.str(), itr->second.mailIds);
+
+        ss.str("");
+        ss << "UPDATE item_instance SET owner_guid = " << itr->first << " WHERE guid IN";
+        ExecuteForIds(ss.str(), itr->second.itemGuids);
+    }
+
+    ExecuteForIds("DELETE FROM item_instance WHERE guid IN", deleteItems);
+    ExecuteForIds("DELETE FROM mail_items WHERE mail_id IN", deleteMails);
+    ExecuteForIds("DELETE FROM item_text WHERE id IN", deleteTexts);
+    ExecuteForIds("DELETE FROM mail WHERE id IN", deleteMails);
+
+    CharacterDatabase.CommitTransaction();
+}
+
+void MailExpiryMgr::Finish()
+{
+    m_state = EXPIRY_STATE_IDLE;
+    m_batch.clear();
+
+    sLog.outString(">> Expired mails: %u returned, %u deleted, %u skipped for online players", m_returnedCount, m_deletedCount, m_skippedCount);
+}
+
+void MailExpiryMgr::RequestBatch()
+{
+    m_state = EXPIRY_STATE_LOADING;
+    CharacterDatabase.AsyncPQuery(this, &MailExpiryMgr::HandleMailsResult, "%s", GetMailsQuery().c_str());
+}
+
+void MailExpiryMgr::HandleMailsResult(QueryResult* result)
+{
+    if (!FillMails(result))
+    {
+        Finish();
+        return;
+    }
+
+    if (m_batchHasItems)
+    {
+        CharacterDatabase.AsyncPQuery(this, &MailExpiryMgr::HandleItemsResult, "%s", GetItemsQuery().c_str());
+        return;
+    }
+
+    m_state = EXPIRY_STATE_APPLYING;
+}
+
+void MailExpiryMgr::HandleItemsResult(QueryResult* result)
+{
+    FillItems(result);
+    m_state = EXPIRY_STATE_APPLYING;
+}
+
+/*! @} */
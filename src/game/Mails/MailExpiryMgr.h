@@ -0,0 +1,114 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/**
+ * @addtogroup mailing
+ * @{
+ *
+ * @file MailExpiryMgr.h
+ * This file contains the headers needed for MaNGOS to return or delete expired mails without stalling world update.
+ *
+ */
+
+#ifndef MANGOS_MAIL_EXPIRY_MGR_H
+#define MANGOS_MAIL_EXPIRY_MGR_H
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+class QueryResult;
+
+/**
+ * A class to return expired mails to their senders or delete them.
+ *
+ * Expired mails are read in batches ordered by mail id, each batch continues after last id of previous one.
+ * At server startup all batches are processed at once, on running server batches are loaded by async queries
+ * and applied in world update with limited amount of mails per tick.
+ */
+class MailExpiryMgr
+{
+    public:                                                 // Constructors
+        MailExpiryMgr();
+
+    public:                                                 // modifiers
+        /**
+         * Return or delete all mails expired at call time.
+         *
+         * @param serverUp      true if the server is already running, false when the server is started
+         *
+         * Note: on running server work is done in next ticks, call is ignored if previous run is not finished yet
+         */
+        void ReturnOrDeleteOldMails(bool serverUp);
+
+        /**
+         * Next step in mail expiry, apply some amount of mails from loaded batch
+         */
+        void Update();
+
+    private:
+        enum ExpiryState
+        {
+            EXPIRY_STATE_IDLE,
+            EXPIRY_STATE_LOADING,                           // waiting for async query results
+            EXPIRY_STATE_APPLYING,                          // loaded batch applied in world update
+        };
+
+        struct ExpiredMail
+        {
+            uint32 id;
+            uint8 messageType;
+            uint32 sender;
+            uint32 receiver;
+            uint32 itemTextId;
+            bool hasItems;
+            uint32 checked;
+            std::vector<uint32> items;                      // item guids
+        };
+
+        std::string GetMailsQuery() const;
+        std::string GetItemsQuery() const;
+        bool FillMails(QueryResult* result);
+        void FillItems(QueryResult* result);
+        void ApplyMails(uint32 count, bool serverUp);
+        void Finish();
+
+        void RequestBatch();
+        void HandleMailsResult(QueryResult* result);
+        void HandleItemsResult(QueryResult* result);
+
+        ExpiryState m_state;
+        time_t m_baseTime;                                  // mails expired before it are processed in current run
+        uint32 m_lastMailId;                                // batches continue after this id
+
+        std::vector<ExpiredMail> m_batch;
+        uint32 m_applyIndex;                                // next mail of batch to apply
+        bool m_batchFull;                                   // more expired mails can follow current batch
+        bool m_batchHasItems;
+
+        uint32 m_returnedCount;
+        uint32 m_deletedCount;
+        uint32 m_skippedCount;                              // mails of online players, expired by player itself
+};
+
+#define sMailExpiryMgr MaNGOS::Singleton<MailExpiryMgr>::Instance()
+
+#endif
+/*! @} */
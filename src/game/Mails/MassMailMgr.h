@@ -18,11 +18,13 @@
 
 /**
  * @addtogroup mailing The mail system
- * The mailing system in MaNGOS consists of mostly 4 files:
+ * The mailing system in MaNGOS consists of mostly 6 files:
  * - Mail.h
  * - Mail.cpp
  * - MassMailMgr.h
  * - MassMailMgr.cpp
+ * - MailExpiryMgr.h
+ * - MailExpiryMgr.cpp
  *
  * @{
  *
@@ -0,0 +1,163 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/CollisionCache.h"
+#include "Maps/Map.h"
+#include "World/World.h"
+#include "Log.h"
+
+#define COLLISION_CACHE_LOS_ENTRIES     4096                // must be power of 2
+#define COLLISION_CACHE_HEIGHT_ENTRIES  4096                // must be power of 2
+#define COLLISION_CACHE_STATS_INTERVAL  (10 * MINUTE * IN_MILLISECONDS)
+
+namespace
+{
+    inline uint32 HashKey(int32 const* key, uint32 count)
+    {
+        uint32 hash = 2166136261u;
+        for (uint32 i = 0; i < count; ++i)
+            hash = (hash ^ uint32(key[i])) * 16777619u;
+        return hash ^ (hash >> 15);
+    }
+}
+
+CollisionCache::CollisionCache(Map& map) : m_map(map), m_precision(sWorld.getConfig(CONFIG_FLOAT_COLLISION_CACHE_PRECISION)),
+    m_dynamicEpoch(1), m_statsTimer(0)
+{
+}
+
+uint64 CollisionCache::GetEpoch() const
+{
+    return (uint64(m_map.GetTerrain()->GetEpoch()) << 32) | m_dynamicEpoch;
+}
+
+bool CollisionCache::FindLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool& result)
+{
+    if (!IsEnabled())
+        return false;
+
+    int32 key[6] = { Quantize(x1), Quantize(y1), Quantize(z1), Quantize(x2), Quantize(y2), Quantize(z2) };
+
+    if (!m_losEntries.empty())
+    {
+        LosEntry const& entry = m_losEntries[HashKey(key, 6) & (COLLISION_CACHE_LOS_ENTRIES - 1)];
+        if (entry.epoch == GetEpoch() && memcmp(entry.key, key, sizeof(key)) == 0)
+        {
+            result = entry.result;
+            ++m_stats.LosHits;
+            return true;
+        }
+    }
+
+    ++m_stats.LosMisses;
+    return false;
+}
+
+void CollisionCache::AddLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool result)
+{
+    if (!IsEnabled())
+        return;
+
+    int32 key[6] = { Quantize(x1), Quantize(y1), Quantize(z1), Quantize(x2), Quantize(y2), Quantize(z2) };
+
+    if (m_losEntries.empty())
+        m_losEntries.resize(COLLISION_CACHE_LOS_ENTRIES, LosEntry());
+
+    LosEntry& entry = m_losEntries[HashKey(key, 6) & (COLLISION_CACHE_LOS_ENTRIES - 1)];
+    memcpy(entry.key, key, sizeof(key));
+    entry.epoch = GetEpoch();
+    entry.result = result;
+}
+
+bool CollisionCache::FindHeight(float x, float y, float z, float& height)
+{
+    if (!IsEnabled())
+        return false;
+
+    int32 key[3] = { Quantize(x), Quantize(y), Quantize(z) };
+
+    if (!m_heightEntries.empty())
+    {
+        HeightEntry const& entry = m_heightEntries[HashKey(key, 3) & (COLLISION_CACHE_HEIGHT_ENTRIES - 1)];
+        if (entry.epoch == GetEpoch() && memcmp(entry.key, key, sizeof(key)) == 0)
+        {
+            height = entry.height;
+            ++m_stats.HeightHits;
+            return true;
+        }
+    }
+
+    ++m_stats.HeightMisses;
+    return false;
+}
+
+void CollisionCache::AddHeight(float x, float y, float z, float height)
+{
+    if (!IsEnabled())
+        return;
+
+    int32 key[3] = { Quantize(x), Quantize(y), Quantize(z) };
+
+    if (m_heightEntries.empty())
+        m_heightEntries.resize(COLLISION_CACHE_HEIGHT_ENTRIES, HeightEntry());
+
+    HeightEntry& entry = m_heightEntries[HashKey(key, 3) & (COLLISION_CACHE_HEIGHT_ENTRIES - 1)];
+    memcpy(entry.key, key, sizeof(key));
+    entry.height = height;
+    entry.epoch = GetEpoch();
+}
+
+void CollisionCache::Invalidate()
+{
+    // skip 0 on wrap, it marks empty entries
+    if (++m_dynamicEpoch == 0)
+        m_dynamicEpoch = 1;
+    ++m_stats.Invalidations;
+}
+
+void CollisionCache::Update(uint32 diff)
+{
+    // keys quantized with old precision could match other points with new one
+    float precision = sWorld.getConfig(CONFIG_FLOAT_COLLISION_CACHE_PRECISION);
+    if (precision != m_precision)
+    {
+        m_precision = precision;
+        Invalidate();
+    }
+
+    m_statsTimer += diff;
+    if (m_statsTimer >= COLLISION_CACHE_STATS_INTERVAL)
+    {
+        m_statsTimer = 0;
+        LogStats();
+    }
+}
+
+void CollisionCache::LogStats()
+{
+    uint32 losQueries = m_stats.LosHits + m_stats.LosMisses;
+    uint32 heightQueries = m_stats.HeightHits + m_stats.HeightMisses;
+    if (!losQueries && !heightQueries)
+        return;
+
+    sLog.outDetail("Map %u (instance %u) collision cache: %u LoS queries (%.1f%% hits), %u height queries (%.1f%% hits), %u invalidations",
+                   m_map.GetId(), m_map.GetInstanceId(), losQueries, losQueries ? m_stats.LosHits * 100.0f / losQueries : 0.0f,
+                   heightQueries, heightQueries ? m_stats.HeightHits * 100.0f / heightQueries : 0.0f, m_stats.Invalidations);
+
+    m_stats = CollisionCacheStats();
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_COLLISION_CACHE_H
+#define MANGOS_COLLISION_CACHE_H
+
+#include "Common.h"
+
+#include <vector>
+
+class Map;
+
+struct CollisionCacheStats
+{
+    CollisionCacheStats() : LosHits(0), LosMisses(0), HeightHits(0), HeightMisses(0), Invalidations(0) {}
+
+    uint32 LosHits;
+    uint32 LosMisses;
+    uint32 HeightHits;
+    uint32 HeightMisses;
+    uint32 Invalidations;                                   // dynamic tree changes
+};
+
+/**
+ * Per map cache of line of sight and ground height queries.
+ *
+ * Query coordinates are quantized to vmap.CachePrecision yards, queries with near identical
+ * endpoints repeated by AI, spells and movement generators return result of first one instead of
+ * ray casts through static and dynamic vmaps. Tables are direct mapped and overwrite on conflict.
+ * Entries are stamped with epoch of map dynamic tree and terrain, any gameobject model change
+ * or terrain grid (un)load invalidates all of them, and so does change of precision by config reload.
+ * Maps are updated serially and the cache is used only by their update, so it has no lock.
+ */
+class CollisionCache
+{
+    public:
+        explicit CollisionCache(Map& map);
+
+        bool FindLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool& result);
+        void AddLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool result);
+
+        bool FindHeight(float x, float y, float z, float& height);
+        void AddHeight(float x, float y, float z, float height);
+
+        // called on every change of map dynamic tree
+        void Invalidate();
+
+        void Update(uint32 diff);
+
+        bool IsEnabled() const { return m_precision > 0.0f; }
+
+    private:
+        struct LosEntry
+        {
+            int32 key[6];
+            uint64 epoch;                                   // 0 is empty entry
+            bool result;
+        };
+
+        struct HeightEntry
+        {
+            int32 key[3];
+            float height;
+            uint64 epoch;
+        };
+
+        int32 Quantize(float value) const { return int32(floorf(value / m_precision)); }
+        uint64 GetEpoch() const;
+
+        void LogStats();
+
+        Map& m_map;
+        float m_precision;                                  // yards, 0 disables cache
+        uint32 m_dynamicEpoch;
+
+        // allocated at first use, most instances never ask
+        std::vector<LosEntry> m_losEntries;
+        std::vector<HeightEntry> m_heightEntries;
+
+        CollisionCacheStats m_stats;
+        uint32 m_statsTimer;
+};
+
+#endif
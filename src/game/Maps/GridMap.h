@@ -237,6 +237,9 @@ class TerrainInfo : public Referencable<std::atomic_long>
         bool GetAreaInfo(float x, float y, float z, uint32& mogpflags, int32& adtId, int32& rootId, int32& groupId) const;
         bool IsOutdoors(float x, float y, float z) const;
 
+        // changes when any grid with its vmap is loaded or unloaded
+        uint32 GetEpoch() const { return m_epoch; }
+
 
         // this method should be used only by TerrainManager
         // to cleanup unreferenced GridMap objects - they are too heavy
@@ -265,6 +268,8 @@ class TerrainInfo : public Referencable<std::atomic_long>
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        std::atomic<uint32> m_epoch;
+
         // global garbage collection timer
         ShortIntervalTimer i_timer;
 
@@ -33,12 +33,16 @@
 #include "Server/DBCEnums.h"
 #include "Maps/MapPersistentStateMgr.h"
 #include "VMapFactory.h"
+#include "vmap/GameObjectModel.h"
 #include "MotionGenerators/MoveMap.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
 #include "Grids/ObjectGridLoader.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 
+// interval of creature update rate statistics log
+#define CREATURE_LOD_STATS_INTERVAL     (10 * MINUTE * IN_MILLISECONDS)
+
 Map::~Map()
 {
     UnloadAll(true);
@@ -87,8 +91,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
-      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(nullptr), i_script_id(0)
+      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)), m_creatureLodStatsTimer(0),
+      i_data(nullptr), i_script_id(0), m_unitPositionIndex(*this), m_movementBroadcaster(*this), m_collisionCache(*this)
 {
     m_CreatureGuids.Set(sObjectMgr.GetFirstTemporaryCreatureLowGuid());
     m_GameObjectGuids.Set(sObjectMgr.GetFirstTemporaryGameObjectLowGuid());
@@ -132,6 +136,7 @@ template<>
 void Map::AddToGrid(Player* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).AddWorldObject(obj);
+    m_unitPositionIndex.InvalidateCell(cell.cellPair());
 }
 
 template<>
@@ -164,6 +169,7 @@ void Map::AddToGrid(Creature* obj, NGridType* grid, Cell const& cell)
         (*grid)(cell.CellX(), cell.CellY()).AddGridObject<Creature>(obj);
         obj->SetCurrentCell(cell);
     }
+    m_unitPositionIndex.InvalidateCell(cell.cellPair());
 }
 
 template<class T>
@@ -176,6 +182,7 @@ template<>
 void Map::RemoveFromGrid(Player* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).RemoveWorldObject(obj);
+    m_unitPositionIndex.InvalidateCell(cell.cellPair());
 }
 
 template<>
@@ -206,6 +213,7 @@ void Map::RemoveFromGrid(Creature* obj, NGridType* grid, Cell const& cell)
     {
         (*grid)(cell.CellX(), cell.CellY()).RemoveGridObject<Creature>(obj);
     }
+    m_unitPositionIndex.InvalidateCell(cell.cellPair());
 }
 
 void Map::DeleteFromWorld(Player* pl)
@@ -283,6 +291,9 @@ bool Map::EnsureGridLoaded(const Cell& cell)
 
         // Add resurrectable corpses to world object list in grid
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(), cell.GridY()), (*grid)(cell.CellX(), cell.CellY()), this);
+
+        // loaded units bypass AddToGrid
+        m_unitPositionIndex.InvalidateAll();
         return true;
     }
 
@@ -523,6 +534,8 @@ bool Map::loaded(const GridPair& p) const
 void Map::Update(const uint32& t_diff)
 {
     m_dyn_tree.update(t_diff);
+    m_collisionCache.Update(t_diff);
+    m_unitPositionIndex.Reset();
 
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -537,6 +550,9 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
+    /// send client movement received from sessions
+    m_movementBroadcaster.Update(t_diff);
+
     /// update players at tick
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
@@ -559,7 +575,26 @@ void Map::Update(const uint32& t_diff)
         m_messageVector.clear();
     }
 
-    MaNGOS::ObjectUpdater obj_updater(t_diff);
+    bool creatureLod = sWorld.getConfig(CONFIG_BOOL_CREATURE_LOD);
+    if (creatureLod)
+    {
+        // cells near any player are updated at full rate, whatever player visits them first
+        near_cells.reset();
+        float nearDistance = sWorld.getConfig(CONFIG_FLOAT_CREATURE_LOD_NEAR_DISTANCE);
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (!plr->IsInWorld() || !plr->IsPositionValid())
+                continue;
+
+            CellArea area = Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), nearDistance);
+            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                    near_cells.set((y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x);
+        }
+    }
+
+    MaNGOS::ObjectUpdater obj_updater(t_diff, creatureLod ? &m_creatureLodStats : nullptr);
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
@@ -588,6 +623,7 @@ void Map::Update(const uint32& t_diff)
                     CellPair pair(x, y);
                     Cell cell(pair);
                     cell.SetNoCreate();
+                    obj_updater.i_lod = near_cells.test(cell_id) ? CREATURE_LOD_NEAR : CREATURE_LOD_FAR;
                     Visit(cell, grid_object_update);
                     Visit(cell, world_object_update);
                 }
@@ -626,6 +662,7 @@ void Map::Update(const uint32& t_diff)
                         CellPair pair(x, y);
                         Cell cell(pair);
                         cell.SetNoCreate();
+                        obj_updater.i_lod = CREATURE_LOD_UNOBSERVED;
                         Visit(cell, grid_object_update);
                         Visit(cell, world_object_update);
                     }
@@ -634,6 +671,16 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
+    m_creatureLodStatsTimer += t_diff;
+    if (m_creatureLodStatsTimer >= CREATURE_LOD_STATS_INTERVAL)
+    {
+        m_creatureLodStatsTimer = 0;
+        if (m_creatureLodStats.ThrottledUpdates || m_creatureLodStats.DeferredUpdates)
+            sLog.outDetail("Map %u (instance %u) creature updates: %u full rate, %u throttled, %u deferred",
+                           GetId(), GetInstanceId(), m_creatureLodStats.FullUpdates, m_creatureLodStats.ThrottledUpdates, m_creatureLodStats.DeferredUpdates);
+        m_creatureLodStats = CreatureUpdateLodStats();
+    }
+
     // Send world objects and item update field changes
     SendObjectUpdates();
 
@@ -889,6 +936,8 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
         unloader.UnloadN();
         delete getNGrid(x, y);
         setNGrid(nullptr, x, y);
+
+        m_unitPositionIndex.InvalidateAll();
     }
 
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
@@ -2075,8 +2124,62 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    bool result;
+    if (m_collisionCache.FindLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+
+    // recorded queries can be replayed by vmap_los_bench
+    DEBUG_FILTER_LOG(LOG_FILTER_LINE_OF_SIGHT, "LOS query: map %u %f %f %f %f %f %f %u", GetId(), srcX, srcY, srcZ, destX, destY, destZ, uint32(result));
+
+    m_collisionCache.AddLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, result);
+    return result;
+}
+
+/**
+ * Line of sight from one point to several targets, static vmaps trace rays to all not cached targets together
+ */
+uint32 Map::GetLineOfSightMask(float srcX, float srcY, float srcZ, float const* targets, uint32 count) const
+{
+    MANGOS_ASSERT(count <= VMAP_MAX_LOS_BATCH);
+
+    uint32 result = 0;
+    float misses[VMAP_MAX_LOS_BATCH * 3];
+    uint32 missIndex[VMAP_MAX_LOS_BATCH];
+    uint32 missCount = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        bool visible;
+        if (m_collisionCache.FindLineOfSight(srcX, srcY, srcZ, targets[3 * i], targets[3 * i + 1], targets[3 * i + 2], visible))
+        {
+            if (visible)
+                result |= 1u << i;
+            continue;
+        }
+
+        std::copy(targets + 3 * i, targets + 3 * i + 3, misses + 3 * missCount);
+        missIndex[missCount++] = i;
+    }
+
+    if (!missCount)
+        return result;
+
+    uint32 visibleMask = VMAP::VMapFactory::createOrGetVMapManager()->getLineOfSightMask(GetId(), srcX, srcY, srcZ, misses, missCount);
+    visibleMask = m_dyn_tree.getLineOfSightMask(srcX, srcY, srcZ, misses, missCount, visibleMask);
+
+    for (uint32 i = 0; i < missCount; ++i)
+    {
+        float const* target = misses + 3 * i;
+        bool visible = (visibleMask & (1u << i)) != 0;
+        DEBUG_FILTER_LOG(LOG_FILTER_LINE_OF_SIGHT, "LOS query: map %u %f %f %f %f %f %f %u", GetId(), srcX, srcY, srcZ, target[0], target[1], target[2], uint32(visible));
+        m_collisionCache.AddLineOfSight(srcX, srcY, srcZ, target[0], target[1], target[2], visible);
+        if (visible)
+            result |= 1u << missIndex[i];
+    }
+
+    return result;
 }
 
 /**
@@ -2164,21 +2267,30 @@ bool Map::GetHeightInRange(float x, float y, float& z, float maxSearchDist /*= 4
 
 float Map::GetHeight(float x, float y, float z) const
 {
+    float height;
+    if (m_collisionCache.FindHeight(x, y, z, height))
+        return height;
+
     float staticHeight = m_TerrainData->GetHeightStatic(x, y, z);
 
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
-    return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
+    height = std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight));
+
+    m_collisionCache.AddHeight(x, y, z, height);
+    return height;
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    m_collisionCache.Invalidate();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    m_collisionCache.Invalidate();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -2186,6 +2298,15 @@ bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
     return m_dyn_tree.contains(mdl);
 }
 
+void Map::EnableGameObjectModel(GameObjectModel& mdl, bool enabled)
+{
+    if (mdl.isEnabled() == enabled)
+        return;
+
+    mdl.enable(enabled);
+    m_collisionCache.Invalidate();
+}
+
 // This will generate a random point to all directions in water for the provided point in radius range.
 bool Map::GetRandomPointUnderWater(float& x, float& y, float& z, float radius, GridMapLiquidData& liquid_status) const
 {
@@ -29,6 +29,9 @@
 #include "Entities/Object.h"
 #include "Globals/SharedDefines.h"
 #include "Maps/GridMap.h"
+#include "Maps/UnitPositionIndex.h"
+#include "Maps/MovementBroadcaster.h"
+#include "Maps/CollisionCache.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
 #include "DBScripts/ScriptMgr.h"
@@ -36,6 +39,7 @@
 #include "vmap/DynamicTree.h"
 
 #include <bitset>
+#include <functional>
 
 struct CreatureInfo;
 class Creature;
@@ -285,16 +289,26 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(float x, float y, float z) const;
         bool GetHeightInRange(float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        // targets are x, y, z triplets, up to VMAP_MAX_LOS_BATCH of them, bit i of result is set when target i is visible
+        uint32 GetLineOfSightMask(float srcX, float srcY, float srcZ, float const* targets, uint32 count) const;
+        bool IsCollisionCacheEnabled() const { return m_collisionCache.IsEnabled(); }
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        void EnableGameObjectModel(GameObjectModel& mdl, bool enabled);
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
 
+        // Broad phase for area target searches
+        UnitPositionIndex& GetUnitPositionIndex() { return m_unitPositionIndex; }
+
+        // Forwarding of client movement to observers
+        MovementBroadcaster& GetMovementBroadcaster() { return m_movementBroadcaster; }
+
         // Teleport all players in that map to choosed location
         void TeleportAllPlayersTo(TeleportLocation loc);
 
@@ -391,6 +405,10 @@ class Map : public GridRefManager<NGridType>
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> near_cells;     // cells updated at full rate in current tick
+
+        CreatureUpdateLodStats m_creatureLodStats;
+        uint32 m_creatureLodStatsTimer;
 
         std::set<WorldObject*> i_objectsToRemove;
 
@@ -418,6 +436,15 @@ class Map : public GridRefManager<NGridType>
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
 
+        // Per tick unit position snapshots
+        UnitPositionIndex m_unitPositionIndex;
+
+        // Client movement queued in map tick
+        MovementBroadcaster m_movementBroadcaster;
+
+        // Line of sight and height results of static and dynamic vmaps
+        mutable CollisionCache m_collisionCache;
+
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
 
@@ -24,6 +24,7 @@
 #include "Entities/Transports.h"
 #include "Maps/GridDefines.h"
 #include "World/World.h"
+#include "World/TickProfiler.h"
 #include "Grids/CellImpl.h"
 #include "Globals/ObjectMgr.h"
 
@@ -173,7 +174,10 @@ void MapManager::Update(uint32 diff)
         return;
 
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    {
+        PROFILE_ZONE(PROFILE_MAP, (uint64(iter->second->GetId()) << 32) | iter->second->GetInstanceId(), iter->second->GetMapName());
         iter->second->Update((uint32)i_timer.GetCurrent());
+    }
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
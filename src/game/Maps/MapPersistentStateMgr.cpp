@@ -35,9 +35,12 @@
 
 #include <list>
 #include <cstdarg>
+#include <sstream>
 
 INSTANTIATE_SINGLETON_1(MapPersistentStateManager);
 
+#define RESPAWN_SAVE_MAX_ROWS   500                         // respawn times per multi-row query
+
 static uint32 resetEventTypeDelay[MAX_RESET_EVENT_TYPE] = { 0,                      // not used
                                                             3600, 900, 300, 60,     // (seconds) normal and official timer delay to inform player about instance reset
                                                             60, 30, 10, 5           // (seconds) fast reset by gm command inform timer
@@ -73,11 +76,22 @@ bool MapPersistentState::UnloadIfEmpty()
 
 void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 {
-    SetCreatureRespawnTime(loguid, t);
-
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
     if (GetMapEntry()->IsBattleGroundOrArena())
+    {
+        SetCreatureRespawnTime(loguid, t);
+        return;
+    }
+
+    // stored in DB at next MapPersistentStateManager::SaveRespawnTimes call
+    if (sWorld.getConfig(CONFIG_UINT32_RESPAWN_SAVE_INTERVAL))
+    {
+        m_pendingCreatureRespawnTimes[loguid] = t;
+        SetCreatureRespawnTime(loguid, t);
         return;
+    }
+
+    SetCreatureRespawnTime(loguid, t);
 
     CharacterDatabase.BeginTransaction();
 
@@ -98,11 +112,22 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
 
 void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
 {
-    SetGORespawnTime(loguid, t);
-
     // BGs/Arenas always reset at server restart/unload, so no reason store in DB
     if (GetMapEntry()->IsBattleGroundOrArena())
+    {
+        SetGORespawnTime(loguid, t);
         return;
+    }
+
+    // stored in DB at next MapPersistentStateManager::SaveRespawnTimes call
+    if (sWorld.getConfig(CONFIG_UINT32_RESPAWN_SAVE_INTERVAL))
+    {
+        m_pendingGORespawnTimes[loguid] = t;
+        SetGORespawnTime(loguid, t);
+        return;
+    }
+
+    SetGORespawnTime(loguid, t);
 
     CharacterDatabase.BeginTransaction();
 
@@ -121,6 +146,53 @@ void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
     CharacterDatabase.CommitTransaction();
 }
 
+/* must be called inside transaction, returns amount of stored respawn times */
+uint32 MapPersistentState::SavePendingRespawnTimes()
+{
+    uint32 count = SavePendingRespawnTimes("creature_respawn", m_pendingCreatureRespawnTimes);
+    count += SavePendingRespawnTimes("gameobject_respawn", m_pendingGORespawnTimes);
+    return count;
+}
+
+uint32 MapPersistentState::SavePendingRespawnTimes(char const* table, RespawnTimes& pending)
+{
+    if (pending.empty())
+        return 0;
+
+    uint32 count = pending.size();
+    time_t now = sWorld.GetGameTime();
+
+    // one multi-row DELETE and INSERT per chunk instead of statement pair per respawn time
+    RespawnTimes::const_iterator itr = pending.begin();
+    while (itr != pending.end())
+    {
+        std::ostringstream delQuery;
+        std::ostringstream insQuery;
+        delQuery << "DELETE FROM " << table << " WHERE instance = '" << m_instanceid << "' AND guid IN (";
+        insQuery << "INSERT INTO " << table << " VALUES ";
+
+        bool hasInserts = false;
+        for (uint32 rows = 0; itr != pending.end() && rows < RESPAWN_SAVE_MAX_ROWS; ++itr, ++rows)
+        {
+            delQuery << (rows ? "," : "") << itr->first;
+
+            if (itr->second > now)
+            {
+                insQuery << (hasInserts ? "," : "") << "(" << itr->first << "," << uint64(itr->second) << "," << m_instanceid << ")";
+                hasInserts = true;
+            }
+        }
+        delQuery << ")";
+
+        CharacterDatabase.Execute(delQuery.str().c_str());
+        if (hasInserts)
+            CharacterDatabase.Execute(insQuery.str().c_str());
+    }
+
+    pending.clear();
+    return count;
+}
+
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
@@ -147,6 +219,7 @@ void MapPersistentState::ClearRespawnTimes()
 {
     m_goRespawnTimes.clear();
     m_creatureRespawnTimes.clear();
+    ClearPendingRespawnTimes();
 
     UnloadIfEmpty();
 }
@@ -263,6 +336,9 @@ void DungeonPersistentState::SaveToDB()
 
 void DungeonPersistentState::DeleteRespawnTimes()
 {
+    // not stored changes must not be saved after delete, or reset instance get old respawn times at server restart
+    ClearPendingRespawnTimes();
+
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", GetInstanceId());
     CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", GetInstanceId());
@@ -271,8 +347,11 @@ void DungeonPersistentState::DeleteRespawnTimes()
     ClearRespawnTimes();                                    // state can be deleted at call if only respawn data prevent unload
 }
 
-void DungeonPersistentState::DeleteFromDB() const
+void DungeonPersistentState::DeleteFromDB()
 {
+    // not stored respawn times of deleted instance must not be written back by periodic save
+    ClearPendingRespawnTimes();
+
     MapPersistentStateManager::DeleteInstanceFromDB(GetInstanceId());
 }
 
@@ -614,7 +693,7 @@ void DungeonResetScheduler::ResetAllRaid()
 
 //== MapPersistentStateManager functions =========================
 
-MapPersistentStateManager::MapPersistentStateManager() : lock_instLists(false), m_Scheduler(*this)
+MapPersistentStateManager::MapPersistentStateManager() : lock_instLists(false), m_Scheduler(*this), m_respawnSaveTimer(0)
 {
 }
 
@@ -720,6 +799,13 @@ void MapPersistentStateManager::RemovePersistentState(uint32 mapId, uint32 insta
         PersistentStateMap::iterator itr = m_instanceSaveByInstanceId.find(instanceId);
         if (itr != m_instanceSaveByInstanceId.end())
         {
+            if (itr->second->HasPendingRespawnTimes())
+            {
+                CharacterDatabase.BeginTransaction();
+                itr->second->SavePendingRespawnTimes();
+                CharacterDatabase.CommitTransaction();
+            }
+
             // state the resettime for normal instances only when they get unloaded
             if (itr->second->GetMapEntry()->IsDungeon())
                 if (time_t resettime = ((DungeonPersistentState*)itr->second)->GetResetTimeForDB())
@@ -732,8 +818,59 @@ void MapPersistentStateManager::RemovePersistentState(uint32 mapId, uint32 insta
     {
         PersistentStateMap::iterator itr = m_instanceSaveByMapId.find(mapId);
         if (itr != m_instanceSaveByMapId.end())
+        {
+            if (itr->second->HasPendingRespawnTimes())
+            {
+                CharacterDatabase.BeginTransaction();
+                itr->second->SavePendingRespawnTimes();
+                CharacterDatabase.CommitTransaction();
+            }
+
             _ResetSave(m_instanceSaveByMapId, itr);
+        }
+    }
+}
+
+void MapPersistentStateManager::Update(uint32 diff)
+{
+    m_Scheduler.Update();
+
+    m_respawnSaveTimer += diff;
+    if (m_respawnSaveTimer >= sWorld.getConfig(CONFIG_UINT32_RESPAWN_SAVE_INTERVAL))
+    {
+        m_respawnSaveTimer = 0;
+        SaveRespawnTimes();
+    }
+}
+
+void MapPersistentStateManager::SaveRespawnTimes()
+{
+    uint32 count = 0;
+    uint32 states = 0;
+
+    // one transaction for all states, called from world update when maps are not updated
+    PersistentStateMap* holders[] = { &m_instanceSaveByMapId, &m_instanceSaveByInstanceId };
+    for (PersistentStateMap* holder : holders)
+    {
+        for (PersistentStateMap::iterator itr = holder->begin(); itr != holder->end(); ++itr)
+        {
+            if (!itr->second->HasPendingRespawnTimes())
+                continue;
+
+            if (!states)
+                CharacterDatabase.BeginTransaction();
+
+            count += itr->second->SavePendingRespawnTimes();
+            ++states;
+        }
     }
+
+    if (!states)
+        return;
+
+    CharacterDatabase.CommitTransaction();
+
+    DEBUG_LOG("MapPersistentStateManager::SaveRespawnTimes: stored %u respawn times of %u map states", count, states);
 }
 
 void MapPersistentStateManager::_DelHelper(DatabaseType& db, const char* fields, const char* table, const char* queryTail, ...) const
@@ -27,9 +27,11 @@
 #include "Entities/ObjectGuid.h"
 #include "Pools/PoolManager.h"
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <mutex>
+#include <vector>
 
 struct InstanceTemplate;
 struct MapEntry;
@@ -42,7 +44,36 @@ class Map;
 
 #define NORMAL_INSTANCE_RESET_TIME 30 * MINUTE
 
-typedef std::set<uint32> CellGuidSet;
+// sorted guids of objects spawned in a cell, contiguous for fast grid loading
+class CellGuidSet
+{
+    public:
+        typedef std::vector<uint32>::const_iterator const_iterator;
+
+        void insert(uint32 guid)
+        {
+            std::vector<uint32>::iterator itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr == m_guids.end() || *itr != guid)
+                m_guids.insert(itr, guid);
+        }
+
+        void erase(uint32 guid)
+        {
+            std::vector<uint32>::iterator itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr != m_guids.end() && *itr == guid)
+                m_guids.erase(itr);
+        }
+
+        const_iterator begin() const { return m_guids.begin(); }
+        const_iterator end() const { return m_guids.end(); }
+        size_t size() const { return m_guids.size(); }
+        bool empty() const { return m_guids.empty(); }
+        size_t capacity() const { return m_guids.capacity(); }
+        void shrink_to_fit() { m_guids.shrink_to_fit(); }
+
+    private:
+        std::vector<uint32> m_guids;
+};
 
 struct MapCellObjectGuids
 {
@@ -120,12 +151,19 @@ class MapPersistentState
         void ClearRespawnTimes();
         bool HasRespawnTimes() const { return !m_creatureRespawnTimes.empty() || !m_goRespawnTimes.empty(); }
 
+        bool HasPendingRespawnTimes() const { return !m_pendingCreatureRespawnTimes.empty() || !m_pendingGORespawnTimes.empty(); }
+        void ClearPendingRespawnTimes() { m_pendingCreatureRespawnTimes.clear(); m_pendingGORespawnTimes.clear(); }
+
     private:
+        typedef std::unordered_map<uint32, time_t> RespawnTimes;
+
         void SetCreatureRespawnTime(uint32 loguid, time_t t);
         void SetGORespawnTime(uint32 loguid, time_t t);
 
+        uint32 SavePendingRespawnTimes();
+        uint32 SavePendingRespawnTimes(char const* table, RespawnTimes& pending);
+
     private:
-        typedef std::unordered_map<uint32, time_t> RespawnTimes;
 
         uint32 m_instanceid;
         uint32 m_mapid;
@@ -135,6 +173,8 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
+        RespawnTimes m_pendingCreatureRespawnTimes;         // changed since last save to DB, expired time only deletes
+        RespawnTimes m_pendingGORespawnTimes;
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 };
 
@@ -219,7 +259,7 @@ class DungeonPersistentState : public MapPersistentState
         /* Saved when the instance is generated for the first time */
         void SaveToDB();
         /* When the instance is being reset (permanently deleted) */
-        void DeleteFromDB() const;
+        void DeleteFromDB();
         /* Delete respawn data at dungeon reset */
         void DeleteRespawnTimes();
         /* Remove players bind to this state */
@@ -365,7 +405,10 @@ class MapPersistentStateManager : public MaNGOS::Singleton<MapPersistentStateMan
 
         void GetStatistics(uint32& numStates, uint32& numBoundPlayers, uint32& numBoundGroups);
 
-        void Update() { m_Scheduler.Update(); }
+        void Update(uint32 diff);
+
+        // store respawn times changed since last call, done periodically and at shutdown
+        void SaveRespawnTimes();
     private:
         typedef std::unordered_map < uint32 /*InstanceId or MapId*/, MapPersistentState* > PersistentStateMap;
 
@@ -385,6 +428,8 @@ class MapPersistentStateManager : public MaNGOS::Singleton<MapPersistentStateMan
         PersistentStateMap m_instanceSaveByMapId;
 
         DungeonResetScheduler m_Scheduler;
+
+        uint32 m_respawnSaveTimer;
 };
 
 template<typename Do>
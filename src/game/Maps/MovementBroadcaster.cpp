@@ -0,0 +1,251 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MovementBroadcaster.h"
+#include "Maps/Map.h"
+#include "Grids/CellImpl.h"
+#include "Entities/Player.h"
+#include "Entities/UpdateData.h"
+#include "Server/WorldSession.h"
+#include "World/World.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <zlib.h>
+
+// server packet header: uint16 size and uint16 opcode
+#define MOVEMENT_PACKET_HEADER_SIZE     4
+#define MOVEMENT_STATS_INTERVAL         (10 * MINUTE * IN_MILLISECONDS)
+// far heartbeat times of movers not seen for this long are dropped
+#define MOVEMENT_HEARTBEAT_EXPIRE       (MINUTE * IN_MILLISECONDS)
+
+namespace
+{
+    struct MovementObserverCollector
+    {
+        Unit const& i_mover;
+        ObjectGuid i_skippedGuid;
+        float i_farDistSq;
+        std::vector<std::pair<Player*, bool> >& i_observers;
+
+        MovementObserverCollector(Unit const& mover, ObjectGuid skippedGuid, float farDist, std::vector<std::pair<Player*, bool> >& observers)
+            : i_mover(mover), i_skippedGuid(skippedGuid), i_farDistSq(farDist * farDist), i_observers(observers) {}
+
+        void Visit(CameraMapType& m)
+        {
+            for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+            {
+                Camera* camera = iter->getSource();
+                Player* owner = camera->GetOwner();
+                if (owner->GetObjectGuid() == i_skippedGuid || !owner->GetSession())
+                    continue;
+
+                WorldObject const* body = camera->GetBody();
+                float dx = body->GetPositionX() - i_mover.GetPositionX();
+                float dy = body->GetPositionY() - i_mover.GetPositionY();
+                i_observers.push_back(std::make_pair(owner, dx * dx + dy * dy > i_farDistSq));
+            }
+        }
+
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+}
+
+MovementBroadcaster::MovementBroadcaster(Map& map) : m_map(map), m_bucketCount(0), m_statsTimer(0)
+{
+}
+
+void MovementBroadcaster::QueueMovement(Unit const* mover, Player const* skipped, WorldPacket const& data)
+{
+    std::pair<std::unordered_map<ObjectGuid, uint32>::iterator, bool> result = m_moverIndex.insert(std::make_pair(mover->GetObjectGuid(), uint32(m_movers.size())));
+    if (result.second)
+    {
+        m_movers.push_back(MoverPackets());
+        m_movers.back().moverGuid = mover->GetObjectGuid();
+    }
+
+    MoverPackets& moverPackets = m_movers[result.first->second];
+    moverPackets.skippedGuid = skipped ? skipped->GetObjectGuid() : ObjectGuid();
+
+    moverPackets.packets.emplace_back(data, data.GetOpcode() == MSG_MOVE_HEARTBEAT);
+
+    ++m_stats.QueuedPackets;
+}
+
+void MovementBroadcaster::Update(uint32 diff)
+{
+    if (!m_movers.empty())
+        Flush();
+
+    m_statsTimer += diff;
+    if (m_statsTimer >= MOVEMENT_STATS_INTERVAL)
+    {
+        m_statsTimer = 0;
+        LogStats();
+    }
+}
+
+void MovementBroadcaster::Flush()
+{
+    uint32 now = WorldTimer::getMSTime();
+    float visibilityDistance = m_map.GetVisibilityDistance();
+    float farDistance = visibilityDistance * sWorld.getConfig(CONFIG_FLOAT_MOVEMENT_FAR_OBSERVER_DISTANCE);
+    uint32 farHeartbeatInterval = sWorld.getConfig(CONFIG_UINT32_MOVEMENT_FAR_HEARTBEAT_INTERVAL);
+
+    for (std::vector<MoverPackets>::const_iterator itr = m_movers.begin(); itr != m_movers.end(); ++itr)
+    {
+        // mover could leave map after its packets were queued
+        Unit* mover = m_map.GetUnit(itr->moverGuid);
+        if (!mover || !mover->IsInWorld())
+            continue;
+
+        bool farHeartbeat = true;
+        if (farHeartbeatInterval)
+        {
+            uint32& lastFarHeartbeat = m_lastFarHeartbeat[itr->moverGuid];
+            farHeartbeat = !lastFarHeartbeat || WorldTimer::getMSTimeDiff(lastFarHeartbeat, now) >= farHeartbeatInterval;
+        }
+
+        m_observers.clear();
+        MovementObserverCollector collector(*mover, itr->skippedGuid, farDistance, m_observers);
+        Cell::VisitWorldObjects(mover, collector, visibilityDistance);
+        ++m_stats.GridVisits;
+
+        bool farHeartbeatSent = false;
+        for (std::vector<std::pair<Player*, bool> >::const_iterator oItr = m_observers.begin(); oItr != m_observers.end(); ++oItr)
+        {
+            std::pair<std::unordered_map<Player*, uint32>::iterator, bool> result = m_bucketIndex.insert(std::make_pair(oItr->first, m_bucketCount));
+            if (result.second)
+            {
+                if (m_bucketCount == m_buckets.size())
+                    m_buckets.push_back(ObserverBucket());
+                m_buckets[m_bucketCount].observer = oItr->first;
+                m_buckets[m_bucketCount].packets.clear();
+                ++m_bucketCount;
+            }
+
+            ObserverBucket& bucket = m_buckets[result.first->second];
+            for (std::vector<QueuedPacket>::const_iterator pItr = itr->packets.begin(); pItr != itr->packets.end(); ++pItr)
+            {
+                m_stats.UncoalescedBytes += pItr->data.size() + MOVEMENT_PACKET_HEADER_SIZE;
+
+                if (pItr->heartbeat && oItr->second)
+                {
+                    if (!farHeartbeat)
+                    {
+                        ++m_stats.ShapedPackets;
+                        continue;
+                    }
+                    farHeartbeatSent = true;
+                }
+
+                bucket.packets.push_back(&pItr->data);
+            }
+        }
+
+        if (farHeartbeatSent)
+            m_lastFarHeartbeat[itr->moverGuid] = now;
+    }
+
+    bool coalesce = sWorld.getConfig(CONFIG_BOOL_MOVEMENT_COALESCE);
+    for (uint32 i = 0; i < m_bucketCount; ++i)
+        SendBucket(m_buckets[i], coalesce);
+
+    m_bucketCount = 0;
+    m_bucketIndex.clear();
+    m_movers.clear();
+    m_moverIndex.clear();
+}
+
+void MovementBroadcaster::SendBucket(ObserverBucket const& bucket, bool coalesce)
+{
+    if (bucket.packets.empty())
+        return;
+
+    WorldSession* session = bucket.observer->GetSession();
+    m_stats.DeliveredPackets += bucket.packets.size();
+
+    if (coalesce && bucket.packets.size() > 1)
+    {
+        WorldPacket data;
+        if (BuildCoalescedPacket(bucket.packets, data))
+        {
+            session->SendPacket(data);
+            ++m_stats.CoalescedPackets;
+            ++m_stats.SentPackets;
+            m_stats.SentBytes += data.size() + MOVEMENT_PACKET_HEADER_SIZE;
+            return;
+        }
+    }
+
+    for (std::vector<WorldPacket const*>::const_iterator itr = bucket.packets.begin(); itr != bucket.packets.end(); ++itr)
+    {
+        session->SendPacket(**itr);
+        ++m_stats.SentPackets;
+        m_stats.SentBytes += (*itr)->size() + MOVEMENT_PACKET_HEADER_SIZE;
+    }
+}
+
+// SMSG_COMPRESSED_MOVES holds zlib compressed list of uint8 size, uint16 opcode and packet data
+bool MovementBroadcaster::BuildCoalescedPacket(std::vector<WorldPacket const*> const& packets, WorldPacket& data)
+{
+    ByteBuffer buf;
+    for (std::vector<WorldPacket const*>::const_iterator itr = packets.begin(); itr != packets.end(); ++itr)
+    {
+        WorldPacket const& packet = **itr;
+        if (packet.size() + sizeof(uint16) > 0xFF)
+            return false;
+
+        buf << uint8(packet.size() + sizeof(uint16));
+        buf << uint16(packet.GetOpcode());
+        buf.append(packet.contents(), packet.size());
+    }
+
+    uint32 destsize = compressBound(buf.size());
+    data.Initialize(SMSG_COMPRESSED_MOVES, destsize + sizeof(uint32));
+    data.resize(destsize + sizeof(uint32));
+    data.put<uint32>(0, buf.size());
+
+    UpdateData::Compress(const_cast<uint8*>(data.contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), buf.size());
+    if (destsize == 0)
+        return false;
+
+    data.resize(destsize + sizeof(uint32));
+    return true;
+}
+
+void MovementBroadcaster::LogStats()
+{
+    uint32 now = WorldTimer::getMSTime();
+    for (std::unordered_map<ObjectGuid, uint32>::iterator itr = m_lastFarHeartbeat.begin(); itr != m_lastFarHeartbeat.end();)
+    {
+        if (WorldTimer::getMSTimeDiff(itr->second, now) >= MOVEMENT_HEARTBEAT_EXPIRE)
+            itr = m_lastFarHeartbeat.erase(itr);
+        else
+            ++itr;
+    }
+
+    if (!m_stats.QueuedPackets)
+        return;
+
+    sLog.outDetail("Map %u (instance %u) movement: %u packets queued, %u grid visits, %u delivered, %u heartbeats shaped, %u sent (%u coalesced), " UI64FMTD " KB sent instead of " UI64FMTD " KB",
+                   m_map.GetId(), m_map.GetInstanceId(), m_stats.QueuedPackets, m_stats.GridVisits, m_stats.DeliveredPackets, m_stats.ShapedPackets,
+                   m_stats.SentPackets, m_stats.CoalescedPackets, m_stats.SentBytes / 1024, m_stats.UncoalescedBytes / 1024);
+
+    m_stats = MovementBroadcastStats();
+}
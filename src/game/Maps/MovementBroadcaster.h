@@ -0,0 +1,110 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MOVEMENT_BROADCASTER_H
+#define MANGOS_MOVEMENT_BROADCASTER_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "WorldPacket.h"
+
+#include <vector>
+#include <unordered_map>
+
+class Map;
+class Unit;
+class Player;
+
+struct MovementBroadcastStats
+{
+    MovementBroadcastStats() : QueuedPackets(0), GridVisits(0), DeliveredPackets(0), ShapedPackets(0), CoalescedPackets(0), SentPackets(0), SentBytes(0), UncoalescedBytes(0) {}
+
+    uint32 QueuedPackets;                                   // client movement packets to forward
+    uint32 GridVisits;                                      // observer searches, one per mover and tick
+    uint32 DeliveredPackets;                                // movement packets delivered to observers
+    uint32 ShapedPackets;                                   // heartbeats not sent to far observers
+    uint32 CoalescedPackets;                                // SMSG_COMPRESSED_MOVES sent
+    uint32 SentPackets;                                     // all packets sent to observers
+    uint64 SentBytes;
+    uint64 UncoalescedBytes;                                // bytes of every movement packet sent alone to every observer
+};
+
+/**
+ * Per map aggregation of client movement packets forwarded to observers.
+ *
+ * Movement packets received in map tick are queued by mover and sent at end of session updates:
+ * observers of each mover are searched once per tick, packets are bucketed by observer and
+ * observer with several packets receives them in one SMSG_COMPRESSED_MOVES packet.
+ * Heartbeats are sent to observers at the visibility edge at reduced rate.
+ */
+class MovementBroadcaster
+{
+    public:
+        explicit MovementBroadcaster(Map& map);
+
+        // forwards movement packet of mover to all players around except skipped one
+        void QueueMovement(Unit const* mover, Player const* skipped, WorldPacket const& data);
+
+        // called after session updates of map tick
+        void Update(uint32 diff);
+
+    private:
+        struct QueuedPacket
+        {
+            QueuedPacket(WorldPacket const& packet, bool isHeartbeat) : data(packet), heartbeat(isHeartbeat) {}
+
+            WorldPacket data;
+            bool heartbeat;
+        };
+
+        struct MoverPackets
+        {
+            ObjectGuid moverGuid;
+            ObjectGuid skippedGuid;
+            std::vector<QueuedPacket> packets;
+        };
+
+        struct ObserverBucket
+        {
+            Player* observer;
+            std::vector<WorldPacket const*> packets;
+        };
+
+        void Flush();
+        void SendBucket(ObserverBucket const& bucket, bool coalesce);
+        static bool BuildCoalescedPacket(std::vector<WorldPacket const*> const& packets, WorldPacket& data);
+        void LogStats();
+
+        Map& m_map;
+
+        std::vector<MoverPackets> m_movers;
+        std::unordered_map<ObjectGuid, uint32> m_moverIndex;
+
+        // reused between flushes
+        std::vector<ObserverBucket> m_buckets;
+        uint32 m_bucketCount;
+        std::unordered_map<Player*, uint32> m_bucketIndex;
+        std::vector<std::pair<Player*, bool /*far*/> > m_observers;
+
+        std::unordered_map<ObjectGuid, uint32> m_lastFarHeartbeat;   // ms time of last heartbeat sent to far observers
+
+        MovementBroadcastStats m_stats;
+        uint32 m_statsTimer;
+};
+
+#endif
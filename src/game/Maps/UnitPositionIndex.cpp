@@ -0,0 +1,185 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/UnitPositionIndex.h"
+#include "Maps/Map.h"
+#include "Grids/CellImpl.h"
+#include "Entities/Player.h"
+#include "Entities/Creature.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define UNIT_POSITION_INDEX_SSE
+#endif
+
+// cell snapshots not used for this many ticks are freed
+#define CELL_SNAPSHOT_PRUNE_TICKS 1000
+
+namespace
+{
+    template<class Data>
+    struct UnitPositionCollector
+    {
+        Data& i_data;
+
+        explicit UnitPositionCollector(Data& data) : i_data(data) {}
+
+        // only reads cells, so dense arrays can be used
+        template<class T> void Add(GridRefManager<T>& m)
+        {
+            uint32 count = m.GetDenseSize();
+            T* const* objects = m.GetDenseObjects();
+            GridObjectHotData const* hotData = m.GetDenseHotData();
+            for (uint32 i = 0; i < count; ++i)
+            {
+                i_data.posX.push_back(hotData[i].x);
+                i_data.posY.push_back(hotData[i].y);
+                i_data.posZ.push_back(hotData[i].z);
+                i_data.units.push_back(objects[i]);
+
+                float boundingRadius = objects[i]->GetObjectBoundingRadius();
+                if (boundingRadius > i_data.maxBoundingRadius)
+                    i_data.maxBoundingRadius = boundingRadius;
+            }
+        }
+
+        void Visit(PlayerMapType& m) { Add(m); }
+        void Visit(CreatureMapType& m) { Add(m); }
+        template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
+    };
+}
+
+UnitPositionIndex::UnitPositionIndex(Map& map) : m_map(map), m_stamp(1), m_lastBuildStamp(0), m_tick(0)
+{
+}
+
+void UnitPositionIndex::Reset()
+{
+    if (++m_stamp == 0)                                     // 0 is reserved for never built cells
+        ++m_stamp;
+
+    if (++m_tick % CELL_SNAPSHOT_PRUNE_TICKS != 0)
+        return;
+
+    for (CellUnitsMap::iterator itr = m_cells.begin(); itr != m_cells.end();)
+    {
+        if (m_tick - itr->second.lastUsedTick >= CELL_SNAPSHOT_PRUNE_TICKS)
+            itr = m_cells.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void UnitPositionIndex::InvalidateCell(CellPair const& cellPair)
+{
+    CellUnitsMap::iterator itr = m_cells.find(GetCellId(cellPair));
+    if (itr != m_cells.end())
+        itr->second.stamp = 0;
+}
+
+UnitPositionIndex::CellUnits const& UnitPositionIndex::GetCellUnits(CellPair const& cellPair)
+{
+    CellUnits& cellUnits = m_cells[GetCellId(cellPair)];
+    cellUnits.lastUsedTick = m_tick;
+    if (cellUnits.stamp == m_stamp)
+        return cellUnits;
+
+    cellUnits.Clear();
+
+    Cell cell(cellPair);
+    cell.SetNoCreate();
+
+    UnitPositionCollector<CellUnits> collector(cellUnits);
+    TypeContainerVisitor<UnitPositionCollector<CellUnits>, GridTypeMapContainer> gridVisitor(collector);
+    TypeContainerVisitor<UnitPositionCollector<CellUnits>, WorldTypeMapContainer> worldVisitor(collector);
+    m_map.Visit(cell, gridVisitor);
+    m_map.Visit(cell, worldVisitor);
+
+    cellUnits.stamp = m_stamp;
+    m_lastBuildStamp = m_stamp;
+    return cellUnits;
+}
+
+void UnitPositionIndex::CollectUnits(float x, float y, float z, float radius, bool is3d, std::vector<Unit*>& result)
+{
+    // same limits as Cell::Visit
+    CellPair standingCell = MaNGOS::ComputeCellPair(x, y);
+    if (standingCell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standingCell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+        return;
+
+    if (radius < 0.0f)
+        radius = 0.0f;
+    else if (radius > 333.0f)
+        radius = 333.0f;
+
+    CellArea area = Cell::CalculateCellArea(x, y, radius);
+    for (uint32 cellX = area.low_bound.x_coord; cellX <= area.high_bound.x_coord; ++cellX)
+    {
+        for (uint32 cellY = area.low_bound.y_coord; cellY <= area.high_bound.y_coord; ++cellY)
+        {
+            CellUnits const& cellUnits = GetCellUnits(CellPair(cellX, cellY));
+            if (!cellUnits.units.empty())
+                FilterCellUnits(cellUnits, x, y, z, radius + cellUnits.maxBoundingRadius, is3d, result);
+        }
+    }
+}
+
+void UnitPositionIndex::FilterCellUnits(CellUnits const& cellUnits, float x, float y, float z, float radius, bool is3d, std::vector<Unit*>& result)
+{
+    float const radiusSq = radius * radius;
+    size_t const count = cellUnits.units.size();
+    size_t i = 0;
+
+#ifdef UNIT_POSITION_INDEX_SSE
+    __m128 const centerX = _mm_set1_ps(x);
+    __m128 const centerY = _mm_set1_ps(y);
+    __m128 const centerZ = _mm_set1_ps(is3d ? z : 0.0f);
+    __m128 const zMask = _mm_set1_ps(is3d ? 1.0f : 0.0f);
+    __m128 const maxDistSq = _mm_set1_ps(radiusSq);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&cellUnits.posX[i]), centerX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&cellUnits.posY[i]), centerY);
+        __m128 dz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&cellUnits.posZ[i]), centerZ), zMask);
+        __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, maxDistSq));
+        for (; mask; mask &= mask - 1)
+        {
+            int lane = mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3;
+            result.push_back(cellUnits.units[i + lane]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        float dx = cellUnits.posX[i] - x;
+        float dy = cellUnits.posY[i] - y;
+        float distSq = dx * dx + dy * dy;
+        if (is3d)
+        {
+            float dz = cellUnits.posZ[i] - z;
+            distSq += dz * dz;
+        }
+
+        if (distSq <= radiusSq)
+            result.push_back(cellUnits.units[i]);
+    }
+}
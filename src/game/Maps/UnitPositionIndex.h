@@ -0,0 +1,101 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_UNIT_POSITION_INDEX_H
+#define MANGOS_UNIT_POSITION_INDEX_H
+
+#include "Common.h"
+#include "Maps/GridDefines.h"
+
+#include <vector>
+#include <unordered_map>
+
+class Map;
+class Unit;
+
+/**
+ * Per map snapshot of unit positions of grid cells, stored as structure of arrays.
+ *
+ * Used as broad phase by area target collection: cells are snapshotted on first query in a map tick
+ * and reused by later queries in the same tick. Any unit relocation, grid add/remove and grid (un)load
+ * invalidates the affected cells, so a snapshot never holds stale positions or deleted units.
+ * Results are conservative (bounding radius included), callers must do exact checks on candidates.
+ */
+class UnitPositionIndex
+{
+    public:
+        explicit UnitPositionIndex(Map& map);
+
+        // Called at start of every map tick, drops all cell snapshots
+        void Reset();
+        // Drops all cell snapshots at once, used when whole grids are (un)loaded
+        void InvalidateAll() { ++m_stamp; }
+        // Drops snapshot of the cell containing given position
+        void Invalidate(float x, float y)
+        {
+            if (m_lastBuildStamp == m_stamp)
+                InvalidateCell(MaNGOS::ComputeCellPair(x, y));
+        }
+        void InvalidateCell(CellPair const& cellPair);
+
+        // Appends to result all units which bounding circle (or sphere for is3d) may intersect radius around given point
+        void CollectUnits(float x, float y, float z, float radius, bool is3d, std::vector<Unit*>& result);
+
+        // Scratch list with kept capacity, must be given back with ReleaseScratchList
+        void AcquireScratchList(std::vector<Unit*>& list) { list.swap(m_scratchList); list.clear(); }
+        void ReleaseScratchList(std::vector<Unit*>& list) { m_scratchList.swap(list); }
+
+    private:
+        struct CellUnits
+        {
+            CellUnits() : stamp(0), lastUsedTick(0), maxBoundingRadius(0.0f) {}
+
+            void Clear()
+            {
+                posX.clear();
+                posY.clear();
+                posZ.clear();
+                units.clear();
+                maxBoundingRadius = 0.0f;
+            }
+
+            std::vector<float> posX;
+            std::vector<float> posY;
+            std::vector<float> posZ;
+            std::vector<Unit*> units;
+            uint32 stamp;                                   // valid while equal to owner m_stamp
+            uint32 lastUsedTick;
+            float maxBoundingRadius;
+        };
+
+        typedef std::unordered_map<uint32 /*cell id*/, CellUnits> CellUnitsMap;
+
+        static uint32 GetCellId(CellPair const& cellPair) { return cellPair.x_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cellPair.y_coord; }
+
+        CellUnits const& GetCellUnits(CellPair const& cellPair);
+        static void FilterCellUnits(CellUnits const& cellUnits, float x, float y, float z, float radius, bool is3d, std::vector<Unit*>& result);
+
+        Map& m_map;
+        CellUnitsMap m_cells;
+        std::vector<Unit*> m_scratchList;
+        uint32 m_stamp;
+        uint32 m_lastBuildStamp;                            // m_stamp at last cell snapshot build, used to skip invalidation lookups
+        uint32 m_tick;
+};
+
+#endif
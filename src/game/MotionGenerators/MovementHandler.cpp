@@ -28,6 +28,7 @@
 #include "MotionGenerators/WaypointMovementGenerator.h"
 #include "Maps/MapPersistentStateMgr.h"
 #include "Globals/ObjectMgr.h"
+#include "World/World.h"
 
 #define MOVEMENT_PACKET_TIME_DELAY 0
 
@@ -289,7 +290,11 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     WorldPacket data(opcode, recv_data.size());
     data << mover->GetPackGUID();                           // write guid
     movementInfo.Write(data);                               // write data
-    mover->SendMessageToSetExcept(data, _player);
+
+    if (sWorld.getConfig(CONFIG_BOOL_MOVEMENT_AGGREGATION) && mover->IsInWorld())
+        mover->GetMap()->GetMovementBroadcaster().QueueMovement(mover, _player, data);
+    else
+        mover->SendMessageToSetExcept(data, _player);
 }
 
 void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
@@ -17,12 +17,14 @@
  */
 
 #include <stdarg.h>
+#include <chrono>
 #include "Common.h"
 #include "Log.h"
 #include "WorldPacket.h"
 #include "Database/DatabaseEnv.h"
 #include "PlayerbotAI.h"
 #include "PlayerbotMgr.h"
+#include "PlayerbotScheduler.h"
 #include "ProgressBar.h"
 
 #include "../../AuctionHouse/AuctionHouseMgr.h"
@@ -88,6 +90,7 @@ class PlayerbotChatHandler : protected ChatHandler
 
 PlayerbotAI::PlayerbotAI(PlayerbotMgr* const mgr, Player* const bot) :
     m_mgr(mgr), m_bot(bot), m_classAI(0), m_ignoreAIUpdatesUntilTime(CurrentTime()),
+    m_nextDecisionTime(WorldTimer::getMSTime() + sPlayerbotScheduler.GetInitialDelay(bot->GetGUIDLow())), m_deferredTicks(0), m_inDecision(false),
     m_combatOrder(ORDERS_NONE), m_ScenarioType(SCENARIO_PVE),
     m_TimeDoneEating(0), m_TimeDoneDrinking(0),
     m_CurrentlyCastingSpellId(0), m_CraftSpellId(0), m_spellIdCommand(0),
@@ -2620,12 +2623,14 @@ bool PlayerbotAI::HasAura(uint32 spellId, const Unit& player) const
     if (spellId <= 0)
         return false;
 
-    for (Unit::SpellAuraHolderMap::const_iterator iter = player.GetSpellAuraHolderMap().begin(); iter != player.GetSpellAuraHolderMap().end(); ++iter)
-    {
-        if (iter->second->GetId() == spellId)
-            return true;
-    }
-    return false;
+    // whisper and command handlers run between decisions, cached result could be old
+    if (!m_inDecision)
+        return player.GetSpellAuraHolderMap().find(spellId) != player.GetSpellAuraHolderMap().end();
+
+    std::pair<std::map<std::pair<ObjectGuid, uint32>, bool>::iterator, bool> cached = m_auraCache.insert(std::make_pair(std::make_pair(player.GetObjectGuid(), spellId), false));
+    if (cached.second)
+        cached.first->second = player.GetSpellAuraHolderMap().find(spellId) != player.GetSpellAuraHolderMap().end();
+    return cached.first->second;
 }
 
 bool PlayerbotAI::HasAura(const char* spellName) const
@@ -4829,9 +4834,27 @@ void PlayerbotAI::UpdateAI(const uint32 /*p_time*/)
     if (m_bot->IsBeingTeleported() || m_bot->GetTrader())
         return;
 
-    if (CurrentTime() < m_ignoreAIUpdatesUntilTime)
+    if (int32(m_nextDecisionTime - WorldTimer::getMSTime()) > 0)
         return;
 
+    if (!sPlayerbotScheduler.CanDecide(m_deferredTicks))
+        return;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    m_inDecision = true;
+    DoDecision();
+    m_inDecision = false;
+
+    // caches are valid only for one decision
+    m_auraCache.clear();
+    m_unavailableSpells.clear();
+
+    sPlayerbotScheduler.AddDecisionTime(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void PlayerbotAI::DoDecision()
+{
     // default updates occur every two seconds
     SetIgnoreUpdateTime(2);
     if (m_FollowAutoGo == FOLLOWAUTOGO_INIT)
@@ -5245,16 +5268,28 @@ bool PlayerbotAI::CastSpell(uint32 spellId)
         return false;
     }
 
+    // cooldown and power can only change by cast in same decision
+    if (m_unavailableSpells.find(spellId) != m_unavailableSpells.end())
+        return false;
+
     // check spell cooldown
     if (!m_bot->IsSpellReady(*pSpellInfo))
+    {
+        if (m_inDecision)
+            m_unavailableSpells.insert(spellId);
         return false;
+    }
 
     // for AI debug purpose: uncomment the following line and bot will tell Master of every spell they attempt to cast
     // TellMaster("I'm trying to cast %s (spellID %u)", pSpellInfo->SpellName[0], spellId);
 
     // Power check (stolen from: CreatureAI.cpp - CreatureAI::CanCastSpell)
     if (m_bot->GetPower((Powers)pSpellInfo->powerType) < Spell::CalculatePowerCost(pSpellInfo, m_bot))
+    {
+        if (m_inDecision)
+            m_unavailableSpells.insert(spellId);
         return false;
+    }
 
     // set target
     ObjectGuid targetGUID = m_bot->GetSelectionGuid();
@@ -5360,6 +5395,9 @@ bool PlayerbotAI::CastSpell(uint32 spellId)
             m_bot->CastSpell(pTarget, pSpellInfo, TRIGGERED_OLD_TRIGGERED); // cast triggered spell
         else
             m_bot->CastSpell(pTarget, pSpellInfo, TRIGGERED_NONE);          // uni-cast spell
+
+        // cast could apply auras
+        m_auraCache.clear();
     }
 
     // Some casting times are negative so set ignore update time to 1 sec to avoid stucking the bot AI
@@ -5485,8 +5523,8 @@ bool PlayerbotAI::CanReceiveSpecificSpell(uint8 spec, Unit* target) const
 {
     if (IsSpellSpecificUniquePerCaster(SpellSpecific(spec)))
     {
-        Unit::SpellAuraHolderMap holders = target->GetSpellAuraHolderMap();
-        Unit::SpellAuraHolderMap::iterator it;
+        Unit::SpellAuraHolderMap const& holders = target->GetSpellAuraHolderMap();
+        Unit::SpellAuraHolderMap::const_iterator it;
         for (it = holders.begin(); it != holders.end(); ++it)
             if ((*it).second->GetCasterGuid() == m_bot->GetObjectGuid() && GetSpellSpecific((*it).second->GetId()) == SpellSpecific(spec))
                 return false;
@@ -7017,7 +7055,7 @@ bool PlayerbotAI::DoTeleport(WorldObject& /*obj*/)
     PlayerbotChatHandler ch(GetMaster());
     if (!ch.teleport(*m_bot))
     {
-        m_ignoreAIUpdatesUntilTime = time(0) + 6;
+        SetIgnoreUpdateTime(6);
         PlayerbotChatHandler ch(GetMaster());
         if (!ch.teleport(*m_bot))
         {
@@ -20,6 +20,7 @@
 #define _PLAYERBOTAI_H
 
 #include "Common.h"
+#include "Timer.h"
 #include "../../Entities/Creature.h"
 #include "../../Entities/ObjectGuid.h"
 #include "../../Entities/Unit.h"
@@ -574,7 +575,7 @@ class PlayerbotAI
         Unit* GetCurrentTarget() { return m_targetCombat; };
         void DoNextCombatManeuver();
         void DoCombatMovement();
-        void SetIgnoreUpdateTime(uint8 t = 0) { m_ignoreAIUpdatesUntilTime = time(nullptr) + t; };
+        void SetIgnoreUpdateTime(uint8 t = 0) { m_ignoreAIUpdatesUntilTime = time(nullptr) + t; m_nextDecisionTime = WorldTimer::getMSTime() + t * IN_MILLISECONDS; };
         time_t CurrentTime() { return time(nullptr); };
 
         Player* GetPlayerBot() const { return m_bot; }
@@ -663,6 +664,9 @@ class PlayerbotAI
         std::string AuctionResult(std::string subject, std::string body);
 
     private:
+        // AI decision, made when bot is due and scheduler budget allows
+        void DoDecision();
+
         bool ExtractCommand(const std::string sLookingFor, std::string& text, bool bUseShort = false);
         // outsource commands for code clarity
         void _HandleCommandReset(std::string& text, Player& fromPlayer);
@@ -725,6 +729,13 @@ class PlayerbotAI
         // ignores AI updates until time specified
         // no need to waste CPU cycles during casting etc
         time_t m_ignoreAIUpdatesUntilTime;
+        uint32 m_nextDecisionTime;                          // ms time, same as above with initial per bot phase
+        uint32 m_deferredTicks;                             // ticks due decision waited for scheduler budget
+
+        // availability checks cached for one decision, class AIs repeat them in every branch
+        mutable std::map<std::pair<ObjectGuid, uint32>, bool> m_auraCache;
+        std::set<uint32> m_unavailableSpells;               // on cooldown or not enough power
+        bool m_inDecision;                                  // caches above are used only while set
 
         CombatStyle m_combatStyle;
         CombatOrderType m_combatOrder;
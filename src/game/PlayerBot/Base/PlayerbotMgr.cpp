@@ -20,6 +20,7 @@
 #include "WorldPacket.h"
 #include "PlayerbotAI.h"
 #include "PlayerbotMgr.h"
+#include "PlayerbotScheduler.h"
 #include "../config.h"
 #include "../../Chat/Chat.h"
 #include "../../Entities/GossipDef.h"
@@ -47,6 +48,8 @@ void PlayerbotMgr::SetInitialWorldSettings()
     //Check playerbot config file version
     if (botConfig.GetIntDefault("ConfVersion", 0) != PLAYERBOT_CONF_VERSION)
         sLog.outError("Playerbot: Configuration file version doesn't match expected version. Some config variables may be wrong or missing.");
+
+    sPlayerbotScheduler.LoadConfig();
 }
 
 PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master)
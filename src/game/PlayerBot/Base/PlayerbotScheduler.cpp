@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PlayerbotScheduler.h"
+#include "Config/Config.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(PlayerbotScheduler);
+
+#define PLAYERBOT_STATS_INTERVAL        (10 * MINUTE * IN_MILLISECONDS)
+// decisions of bots created at same time are spread over this time
+#define PLAYERBOT_DECISION_SPREAD       1000
+
+extern Config botConfig;
+
+PlayerbotScheduler::PlayerbotScheduler() : m_tickBudget(0), m_maxDeferredTicks(0), m_tickTime(0),
+    m_decisions(0), m_deferredDecisions(0), m_statsTimer(0)
+{
+}
+
+void PlayerbotScheduler::LoadConfig()
+{
+    m_tickBudget = botConfig.GetIntDefault("PlayerbotAI.TickBudget", 10) * IN_MILLISECONDS;
+    m_maxDeferredTicks = botConfig.GetIntDefault("PlayerbotAI.MaxDeferredTicks", 4);
+}
+
+void PlayerbotScheduler::BeginTick(uint32 diff)
+{
+    uint32 lastTickTime = m_tickTime.exchange(0);
+
+    ++m_stats.Ticks;
+    m_stats.DecisionTime += lastTickTime;
+    if (lastTickTime > m_stats.MaxTickTime)
+        m_stats.MaxTickTime = lastTickTime;
+
+    m_statsTimer += diff;
+    if (m_statsTimer >= PLAYERBOT_STATS_INTERVAL)
+    {
+        m_statsTimer = 0;
+        LogStats();
+    }
+}
+
+bool PlayerbotScheduler::CanDecide(uint32& deferredTicks)
+{
+    if (m_tickBudget && m_tickTime.load() >= m_tickBudget && deferredTicks < m_maxDeferredTicks)
+    {
+        ++deferredTicks;
+        ++m_deferredDecisions;
+        return false;
+    }
+
+    deferredTicks = 0;
+    ++m_decisions;
+    return true;
+}
+
+void PlayerbotScheduler::AddDecisionTime(uint32 microseconds)
+{
+    m_tickTime += microseconds;
+}
+
+uint32 PlayerbotScheduler::GetInitialDelay(uint32 botLowGuid) const
+{
+    // multiplicative hash, consecutive guids get distant delays
+    return (botLowGuid * 2654435761u) % PLAYERBOT_DECISION_SPREAD;
+}
+
+void PlayerbotScheduler::LogStats()
+{
+    m_stats.Decisions = m_decisions.exchange(0);
+    m_stats.DeferredDecisions = m_deferredDecisions.exchange(0);
+
+    if (m_stats.Decisions)
+        sLog.outDetail("Playerbot AI: %u decisions, %u deferred by tick budget, %.2f ms per tick average, %.2f ms in slowest tick",
+                       m_stats.Decisions, m_stats.DeferredDecisions, m_stats.DecisionTime / 1000.0 / m_stats.Ticks, m_stats.MaxTickTime / 1000.0);
+
+    m_stats = PlayerbotSchedulerStats();
+}
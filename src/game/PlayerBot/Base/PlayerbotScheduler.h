@@ -0,0 +1,79 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _PLAYERBOTSCHEDULER_H
+#define _PLAYERBOTSCHEDULER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+
+struct PlayerbotSchedulerStats
+{
+    PlayerbotSchedulerStats() : Ticks(0), Decisions(0), DeferredDecisions(0), DecisionTime(0), MaxTickTime(0) {}
+
+    uint32 Ticks;
+    uint32 Decisions;                                       // bot AI decisions made
+    uint32 DeferredDecisions;                               // due decisions moved to next tick by budget
+    uint64 DecisionTime;                                    // microseconds
+    uint32 MaxTickTime;                                     // microseconds of bot AI in slowest tick
+};
+
+/**
+ * Limits time spent in bot AI decisions per world tick.
+ *
+ * Bots ask for permission before each decision. When decisions of current tick used the budget
+ * remaining due bots wait for next tick, bot is never deferred more than few ticks in row.
+ */
+class PlayerbotScheduler
+{
+    public:
+        PlayerbotScheduler();
+
+        void LoadConfig();
+
+        // called at start of world tick, before map updates
+        void BeginTick(uint32 diff);
+
+        // deferredTicks is kept by bot, counts ticks its due decision waited for budget
+        bool CanDecide(uint32& deferredTicks);
+        void AddDecisionTime(uint32 microseconds);
+
+        // first decision delay of new bot, spreads bots added at same time over decision interval
+        uint32 GetInitialDelay(uint32 botLowGuid) const;
+
+        uint32 GetTickTime() const { return m_tickTime.load(); }    // microseconds of bot AI in current tick
+
+    private:
+        void LogStats();
+
+        uint32 m_tickBudget;                                // microseconds, 0 for unlimited
+        uint32 m_maxDeferredTicks;
+
+        std::atomic<uint32> m_tickTime;                     // microseconds used in current tick
+
+        PlayerbotSchedulerStats m_stats;
+        std::atomic<uint32> m_decisions;
+        std::atomic<uint32> m_deferredDecisions;
+        uint32 m_statsTimer;
+};
+
+#define sPlayerbotScheduler MaNGOS::Singleton<PlayerbotScheduler>::Instance()
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeCost.h"
+#include "Chat/Chat.h"
+#include "World/World.h"
+#include "Log.h"
+#include "Policies/Singleton.h"
+
+#include <algorithm>
+#include <vector>
+
+INSTANTIATE_SINGLETON_1(OpcodeCostMgr);
+
+#define OPCODE_COST_STATS_INTERVAL  (10 * MINUTE * IN_MILLISECONDS)
+
+namespace
+{
+    struct OpcodeThrottleEntry
+    {
+        uint16 opcode;
+        OpcodeThrottleClass throttleClass;
+    };
+
+    OpcodeThrottleEntry const opcodeThrottleEntries[] =
+    {
+        { CMSG_WHO,                         OPCODE_THROTTLE_WHO     },
+        { CMSG_WHOIS,                       OPCODE_THROTTLE_WHO     },
+        { CMSG_AUCTION_LIST_ITEMS,          OPCODE_THROTTLE_AUCTION },
+        { CMSG_AUCTION_LIST_OWNER_ITEMS,    OPCODE_THROTTLE_AUCTION },
+        { CMSG_AUCTION_LIST_BIDDER_ITEMS,   OPCODE_THROTTLE_AUCTION },
+        { CMSG_NAME_QUERY,                  OPCODE_THROTTLE_QUERY   },
+        { CMSG_PET_NAME_QUERY,              OPCODE_THROTTLE_QUERY   },
+        { CMSG_GUILD_QUERY,                 OPCODE_THROTTLE_QUERY   },
+        { CMSG_ITEM_QUERY_SINGLE,           OPCODE_THROTTLE_QUERY   },
+        { CMSG_ITEM_NAME_QUERY,             OPCODE_THROTTLE_QUERY   },
+        { CMSG_ITEM_TEXT_QUERY,             OPCODE_THROTTLE_QUERY   },
+        { CMSG_PAGE_TEXT_QUERY,             OPCODE_THROTTLE_QUERY   },
+        { CMSG_QUEST_QUERY,                 OPCODE_THROTTLE_QUERY   },
+        { CMSG_GAMEOBJECT_QUERY,            OPCODE_THROTTLE_QUERY   },
+        { CMSG_CREATURE_QUERY,              OPCODE_THROTTLE_QUERY   },
+        { CMSG_NPC_TEXT_QUERY,              OPCODE_THROTTLE_QUERY   },
+        { CMSG_PETITION_QUERY,              OPCODE_THROTTLE_QUERY   },
+        { CMSG_ARENA_TEAM_QUERY,            OPCODE_THROTTLE_QUERY   },
+    };
+
+    char const* opcodeThrottleNames[MAX_OPCODE_THROTTLE] = { "none", "who", "auction", "query" };
+}
+
+OpcodeCostMgr::OpcodeCostMgr() : m_sessionBudget(0), m_maxDeferredPackets(0), m_budgetDeferrals(0),
+    m_intervalCalls(0), m_intervalTime(0), m_intervalThrottled(0), m_intervalDropped(0), m_intervalBudgetDeferrals(0), m_statsTimer(0)
+{
+    memset(m_throttleClass, OPCODE_THROTTLE_NONE, sizeof(m_throttleClass));
+    for (OpcodeThrottleEntry const& entry : opcodeThrottleEntries)
+        m_throttleClass[entry.opcode] = entry.throttleClass;
+
+    for (uint32 i = 0; i < MAX_OPCODE_THROTTLE; ++i)
+    {
+        m_throttleRate[i] = 0.0f;
+        m_throttleBurst[i] = 0.0f;
+    }
+}
+
+void OpcodeCostMgr::LoadConfig()
+{
+    m_sessionBudget = sWorld.getConfig(CONFIG_UINT32_SESSION_PACKET_BUDGET);
+    m_maxDeferredPackets = sWorld.getConfig(CONFIG_UINT32_SESSION_MAX_DEFERRED_PACKETS);
+
+    // rates are configured per minute
+    m_throttleRate[OPCODE_THROTTLE_WHO] = sWorld.getConfig(CONFIG_UINT32_THROTTLE_WHO_RATE) / float(MINUTE * IN_MILLISECONDS);
+    m_throttleBurst[OPCODE_THROTTLE_WHO] = float(sWorld.getConfig(CONFIG_UINT32_THROTTLE_WHO_BURST));
+    m_throttleRate[OPCODE_THROTTLE_AUCTION] = sWorld.getConfig(CONFIG_UINT32_THROTTLE_AUCTION_RATE) / float(MINUTE * IN_MILLISECONDS);
+    m_throttleBurst[OPCODE_THROTTLE_AUCTION] = float(sWorld.getConfig(CONFIG_UINT32_THROTTLE_AUCTION_BURST));
+    m_throttleRate[OPCODE_THROTTLE_QUERY] = sWorld.getConfig(CONFIG_UINT32_THROTTLE_QUERY_RATE) / float(MINUTE * IN_MILLISECONDS);
+    m_throttleBurst[OPCODE_THROTTLE_QUERY] = float(sWorld.getConfig(CONFIG_UINT32_THROTTLE_QUERY_BURST));
+}
+
+void OpcodeCostMgr::AddCall(uint16 opcode, uint32 time)
+{
+    OpcodeCost& cost = m_costs[opcode];
+    cost.Calls.fetch_add(1, std::memory_order_relaxed);
+    cost.TotalTime.fetch_add(time, std::memory_order_relaxed);
+
+    uint32 maxTime = cost.MaxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !cost.MaxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed)) {}
+
+    m_intervalCalls.fetch_add(1, std::memory_order_relaxed);
+    m_intervalTime.fetch_add(time, std::memory_order_relaxed);
+}
+
+void OpcodeCostMgr::AddThrottled(uint16 opcode)
+{
+    m_costs[opcode].Throttled.fetch_add(1, std::memory_order_relaxed);
+    m_intervalThrottled.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OpcodeCostMgr::AddDropped(uint16 opcode)
+{
+    m_costs[opcode].Dropped.fetch_add(1, std::memory_order_relaxed);
+    m_intervalDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OpcodeCostMgr::Update(uint32 diff)
+{
+    m_statsTimer += diff;
+    if (m_statsTimer >= OPCODE_COST_STATS_INTERVAL)
+    {
+        m_statsTimer = 0;
+        LogStats();
+    }
+}
+
+void OpcodeCostMgr::LogStats()
+{
+    uint32 calls = m_intervalCalls.exchange(0);
+    uint64 time = m_intervalTime.exchange(0);
+    uint32 throttled = m_intervalThrottled.exchange(0);
+    uint32 dropped = m_intervalDropped.exchange(0);
+    uint32 budgetDeferrals = m_intervalBudgetDeferrals.exchange(0);
+
+    if (!calls)
+        return;
+
+    sLog.outDetail("Opcode handlers: %u packets in " UI64FMTD " ms, %u throttled, %u dropped, %u session updates stopped by packet budget",
+                   calls, time / 1000, throttled, dropped, budgetDeferrals);
+}
+
+void OpcodeCostMgr::ShowStats(ChatHandler* handler, uint32 count) const
+{
+    std::vector<uint16> sorted;
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+        if (m_costs[i].Calls || m_costs[i].Throttled || m_costs[i].Dropped)
+            sorted.push_back(uint16(i));
+
+    if (sorted.empty())
+    {
+        handler->SendSysMessage("No packets handled yet.");
+        return;
+    }
+
+    count = std::min(count, uint32(sorted.size()));
+    std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(),
+                      [this](uint16 a, uint16 b) { return m_costs[a].TotalTime > m_costs[b].TotalTime; });
+
+    handler->PSendSysMessage("Session updates stopped by packet budget: %u", m_budgetDeferrals.load());
+    handler->PSendSysMessage("Top %u of %u opcodes by total time:", count, uint32(sorted.size()));
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint16 opcode = sorted[i];
+        OpcodeCost const& cost = m_costs[opcode];
+        uint32 calls = cost.Calls;
+        uint64 totalTime = cost.TotalTime;
+
+        handler->PSendSysMessage("%s (0x%.4X, %s): %u calls, " UI64FMTD " ms, avg %u us, max %u us, %u throttled, %u dropped",
+                                 LookupOpcodeName(opcode), opcode, opcodeThrottleNames[m_throttleClass[opcode]], calls, totalTime / 1000,
+                                 calls ? uint32(totalTime / calls) : 0, cost.MaxTime.load(), cost.Throttled.load(), cost.Dropped.load());
+    }
+}
+
+void OpcodeCostMgr::Reset()
+{
+    for (OpcodeCost& cost : m_costs)
+    {
+        cost.Calls = 0;
+        cost.TotalTime = 0;
+        cost.MaxTime = 0;
+        cost.Throttled = 0;
+        cost.Dropped = 0;
+    }
+
+    m_budgetDeferrals = 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODE_COST_H
+#define MANGOS_OPCODE_COST_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Server/Opcodes.h"
+
+#include <atomic>
+
+class ChatHandler;
+
+struct OpcodeCost
+{
+    OpcodeCost() : Calls(0), TotalTime(0), MaxTime(0), Throttled(0), Dropped(0) {}
+
+    std::atomic<uint32> Calls;
+    std::atomic<uint64> TotalTime;                          // microseconds
+    std::atomic<uint32> MaxTime;
+    std::atomic<uint32> Throttled;                          // packets which waited for token of their class
+    std::atomic<uint32> Dropped;                            // packets dropped with too long receive queue
+};
+
+/**
+ * Cost accounting of opcode handlers and limits of session packet processing.
+ *
+ * Every executed handler adds its time to statistics of its opcode, shown by .server opcodes command.
+ * WorldSession::Update stops processing received packets after Network.SessionPacketBudget per tick,
+ * remaining packets are processed in next ticks. Packets of throttled opcode classes without a token
+ * of session bucket are moved to per class queue of session and wait there, other packets are not
+ * held back, so one client spamming expensive requests only delays its own requests of same class.
+ */
+class OpcodeCostMgr
+{
+    public:
+        OpcodeCostMgr();
+
+        void LoadConfig();
+
+        OpcodeThrottleClass GetThrottleClass(uint16 opcode) const { return OpcodeThrottleClass(m_throttleClass[opcode]); }
+        float GetThrottleRate(OpcodeThrottleClass throttleClass) const { return m_throttleRate[throttleClass]; }
+        float GetThrottleBurst(OpcodeThrottleClass throttleClass) const { return m_throttleBurst[throttleClass]; }
+        uint32 GetSessionBudget() const { return m_sessionBudget; }
+        uint32 GetMaxDeferredPackets() const { return m_maxDeferredPackets; }
+
+        void AddCall(uint16 opcode, uint32 time);
+        void AddThrottled(uint16 opcode);
+        void AddDropped(uint16 opcode);
+        void AddBudgetDeferral() { ++m_budgetDeferrals; ++m_intervalBudgetDeferrals; }
+
+        void Update(uint32 diff);
+
+        void ShowStats(ChatHandler* handler, uint32 count) const;
+        void Reset();
+
+    private:
+        void LogStats();
+
+        OpcodeCost m_costs[NUM_MSG_TYPES];
+        uint8 m_throttleClass[NUM_MSG_TYPES];
+
+        float m_throttleRate[MAX_OPCODE_THROTTLE];          // tokens per millisecond, 0 is unlimited
+        float m_throttleBurst[MAX_OPCODE_THROTTLE];
+        uint32 m_sessionBudget;                             // microseconds, 0 is unlimited
+        uint32 m_maxDeferredPackets;
+
+        std::atomic<uint32> m_budgetDeferrals;              // session updates stopped by budget
+
+        // since last stats log
+        std::atomic<uint32> m_intervalCalls;
+        std::atomic<uint64> m_intervalTime;
+        std::atomic<uint32> m_intervalThrottled;
+        std::atomic<uint32> m_intervalDropped;
+        std::atomic<uint32> m_intervalBudgetDeferrals;
+        uint32 m_statsTimer;
+};
+
+#define sOpcodeCostMgr MaNGOS::Singleton<OpcodeCostMgr>::Instance()
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/SessionUpdater.h"
+#include "Server/WorldSession.h"
+#include "Log.h"
+#include "Threading.h"
+
+#include <chrono>
+
+#define SESSION_UPDATE_STATS_INTERVAL  (10 * MINUTE * IN_MILLISECONDS)
+
+namespace
+{
+    class SessionUpdateWorker : public MaNGOS::Runnable
+    {
+        public:
+            explicit SessionUpdateWorker(SessionUpdatePool& pool) : m_pool(pool) {}
+
+            void run() override { m_pool.RunWorker(); }
+
+        private:
+            SessionUpdatePool& m_pool;
+    };
+
+    char const* sessionUpdateCategoryNames[MAX_SESSION_UPDATE_CATEGORY] = { "world", "transfer", "character screen", "queue" };
+}
+
+SessionUpdatePool::SessionUpdatePool() : m_sessions(nullptr), m_nextSession(0), m_generation(0), m_busyWorkers(0), m_running(false), m_statsTimer(0)
+{
+}
+
+SessionUpdatePool::~SessionUpdatePool()
+{
+    Stop();
+}
+
+void SessionUpdatePool::Start(uint32 threads)
+{
+    if (IsEnabled() || !threads)
+        return;
+
+    m_running = true;
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.push_back(new MaNGOS::Thread(new SessionUpdateWorker(*this)));
+
+    sLog.outString("Session updates of character screen and login queue use %u worker threads", threads);
+}
+
+void SessionUpdatePool::Stop()
+{
+    if (!IsEnabled())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_running = false;
+    }
+    m_workCondition.notify_all();
+
+    for (MaNGOS::Thread* thread : m_threads)
+    {
+        thread->wait();
+        delete thread;                                      // This also deletes worker
+    }
+    m_threads.clear();
+}
+
+void SessionUpdatePool::RunWorker()
+{
+    uint32 generation = 0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_workCondition.wait(lock, [&] { return !m_running || m_generation != generation; });
+        if (!m_running)
+            return;
+
+        generation = m_generation;
+        lock.unlock();
+
+        UpdateSessions();
+
+        lock.lock();
+        if (--m_busyWorkers == 0)
+            m_doneCondition.notify_all();
+    }
+}
+
+void SessionUpdatePool::Update(std::vector<WorldSession*> const& sessions)
+{
+    if (sessions.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_sessions = &sessions;
+        m_nextSession = 0;
+        m_busyWorkers = m_threads.size();
+        ++m_generation;
+    }
+    m_workCondition.notify_all();
+
+    // world thread takes part instead of idle wait
+    UpdateSessions();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_sessions = nullptr;
+}
+
+void SessionUpdatePool::UpdateSessions()
+{
+    std::vector<WorldSession*> const& sessions = *m_sessions;
+    for (uint32 i = m_nextSession++; i < sessions.size(); i = m_nextSession++)
+    {
+        WorldSession* session = sessions[i];
+        SessionUpdateCategory category = session->GetUpdateCategory();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        session->UpdateOnWorker();
+
+        SessionUpdateStats& stats = m_stats[category];
+        stats.Updates.fetch_add(1, std::memory_order_relaxed);
+        stats.WorkerTime.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+    }
+}
+
+void SessionUpdatePool::AddWorldTime(SessionUpdateCategory category, uint32 time)
+{
+    SessionUpdateStats& stats = m_stats[category];
+    stats.Updates.fetch_add(1, std::memory_order_relaxed);
+    stats.WorldTime.fetch_add(time, std::memory_order_relaxed);
+}
+
+void SessionUpdatePool::UpdateStats(uint32 diff)
+{
+    m_statsTimer += diff;
+    if (m_statsTimer >= SESSION_UPDATE_STATS_INTERVAL)
+    {
+        m_statsTimer = 0;
+        LogStats();
+    }
+}
+
+void SessionUpdatePool::LogStats()
+{
+    for (uint32 i = 0; i < MAX_SESSION_UPDATE_CATEGORY; ++i)
+    {
+        SessionUpdateStats& stats = m_stats[i];
+        uint32 updates = stats.Updates.exchange(0);
+        uint64 worldTime = stats.WorldTime.exchange(0);
+        uint64 workerTime = stats.WorkerTime.exchange(0);
+
+        if (!updates)
+            continue;
+
+        sLog.outDetail("Session updates (%s): %u updates, world thread " UI64FMTD " ms, workers " UI64FMTD " ms",
+                       sessionUpdateCategoryNames[i], updates, worldTime / 1000, workerTime / 1000);
+    }
+}
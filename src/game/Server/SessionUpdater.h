@@ -0,0 +1,107 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SESSION_UPDATER_H
+#define MANGOS_SESSION_UPDATER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+class WorldSession;
+
+namespace MaNGOS
+{
+    class Thread;
+}
+
+// session state deciding which thread updates it in World::UpdateSessions()
+enum SessionUpdateCategory
+{
+    SESSION_UPDATE_WORLD            = 0,                    // player in world, world thread
+    SESSION_UPDATE_TRANSFER         = 1,                    // player loading, out of world or logging out, world thread
+    SESSION_UPDATE_CHARACTER_SCREEN = 2,                    // no player, worker threads
+    SESSION_UPDATE_QUEUE            = 3,                    // waiting in login queue, worker threads
+};
+
+#define MAX_SESSION_UPDATE_CATEGORY 4
+
+inline bool IsWorkerSessionUpdateCategory(SessionUpdateCategory category)
+{
+    return category == SESSION_UPDATE_CHARACTER_SCREEN || category == SESSION_UPDATE_QUEUE;
+}
+
+struct SessionUpdateStats
+{
+    SessionUpdateStats() : Updates(0), WorldTime(0), WorkerTime(0) {}
+
+    std::atomic<uint32> Updates;                            // session updates, world thread or worker
+    std::atomic<uint64> WorldTime;                          // microseconds
+    std::atomic<uint64> WorkerTime;
+};
+
+/**
+ * Worker threads updating sessions not bound to a map in World::UpdateSessions().
+ *
+ * Sessions on character screen or in login queue run thread-safe handlers (like CMSG_CHAR_ENUM, which only
+ * queues async query) and drop and throttle packets on workers. Thread-unsafe handlers are deferred by
+ * SessionWorkerFilter and run in following world thread pass together with logout and disconnect. World thread updates only sessions which workers left work for.
+ * Time spent per session category is logged every 10 minutes.
+ */
+class SessionUpdatePool
+{
+    public:
+        SessionUpdatePool();
+        ~SessionUpdatePool();
+
+        void Start(uint32 threads);
+        void Stop();
+        bool IsEnabled() const { return !m_threads.empty(); }
+
+        // world thread, returns after all sessions are updated
+        void Update(std::vector<WorldSession*> const& sessions);
+
+        void AddWorldTime(SessionUpdateCategory category, uint32 time);
+        void UpdateStats(uint32 diff);
+
+        // worker thread loop
+        void RunWorker();
+
+    private:
+        void UpdateSessions();
+        void LogStats();
+
+        std::vector<MaNGOS::Thread*> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_workCondition;            // workers wait for next batch
+        std::condition_variable m_doneCondition;            // world thread waits for end of batch
+        std::vector<WorldSession*> const* m_sessions;
+        std::atomic<uint32> m_nextSession;
+        uint32 m_generation;                                // batch counter, workers compare with last seen
+        uint32 m_busyWorkers;
+        bool m_running;
+
+        SessionUpdateStats m_stats[MAX_SESSION_UPDATE_CATEGORY];
+        uint32 m_statsTimer;
+};
+
+#endif
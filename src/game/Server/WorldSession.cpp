@@ -33,6 +33,8 @@
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
 #include "World/World.h"
+#include "World/TickProfiler.h"
+#include "Server/OpcodeCost.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "Social/SocialMgr.h"
 #include "Loot/LootMgr.h"
@@ -41,6 +43,7 @@
 #include <deque>
 #include <algorithm>
 #include <cstdarg>
+#include <chrono>
 
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotMgr.h"
@@ -87,14 +90,39 @@ bool WorldSessionFilter::Process(WorldPacket const& packet) const
     return !MapSessionFilterHelper(m_pSession, opHandle);
 }
 
+// worker thread runs only handlers safe outside of world thread, packets which would just be
+// logged as unexpected are dropped here as well
+bool SessionWorkerFilter::Defer(WorldPacket const& packet) const
+{
+    OpcodeHandler const& opHandle = opcodeTable[packet.GetOpcode()];
+    if (opHandle.packetProcessing != PROCESS_THREADUNSAFE)
+        return false;
+
+    switch (opHandle.status)
+    {
+        case STATUS_LOGGEDIN:
+        case STATUS_TRANSFER:
+            return m_pSession->GetPlayer() != nullptr;
+        case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
+            return m_pSession->GetPlayer() || m_pSession->PlayerRecentlyLogout();
+        case STATUS_AUTHED:
+            return !m_pSession->IsInQueue();
+        default:
+            return false;
+    }
+}
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8 expansion, time_t mute_time, LocaleConstant locale) :
     LookingForGroup_auto_join(false), LookingForGroup_auto_add(false), m_muteTime(mute_time),
-    _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr), _security(sec), _accountId(id), m_expansion(expansion), _logoutTime(0),
+    _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr), m_headless(false), _security(sec), _accountId(id), m_expansion(expansion), _logoutTime(0),
     m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED)
-{}
+    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_throttleRefillTime(0), m_worldUpdateNeeded(true)
+{
+    for (uint32 i = 0; i < MAX_OPCODE_THROTTLE; ++i)
+        m_throttleTokens[i] = sOpcodeCostMgr.GetThrottleBurst(OpcodeThrottleClass(i));
+}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -209,12 +237,68 @@ bool WorldSession::Update(PacketFilter& updater)
 {
     std::lock_guard<std::mutex> guard(m_recvQueueLock);
 
+    RefillThrottleTokens();
+
+    uint32 budget = sOpcodeCostMgr.GetSessionBudget();
+    uint32 processed = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
+    while (m_Socket && !m_Socket->IsClosed())
     {
-        auto const packet = std::move(m_recvQueue.front());
-        m_recvQueue.pop_front();
+        // throttled packets which got token since were received before rest of queue
+        std::deque<std::unique_ptr<WorldPacket>>* queue = &m_recvQueue;
+        for (uint32 i = OPCODE_THROTTLE_NONE + 1; i < MAX_OPCODE_THROTTLE; ++i)
+        {
+            if (!m_throttledQueue[i].empty() && HasThrottleToken(OpcodeThrottleClass(i)))
+            {
+                queue = &m_throttledQueue[i];
+                break;
+            }
+        }
+
+        if (queue->empty())
+            break;
+
+        // rest of queue waits for next tick if session used its time, at least one packet is processed
+        if (budget && processed && std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() >= budget)
+        {
+            sOpcodeCostMgr.AddBudgetDeferral();
+            break;
+        }
+
+        if (updater.Defer(*queue->front()))
+            break;
+
+        // throttled packet waits in queue of its class, so it holds back only later packets of same class
+        uint16 opcode = queue->front()->GetOpcode();
+        OpcodeThrottleClass throttleClass = sOpcodeCostMgr.GetThrottleClass(opcode);
+        if (throttleClass != OPCODE_THROTTLE_NONE && ((queue == &m_recvQueue && !m_throttledQueue[throttleClass].empty()) || !HasThrottleToken(throttleClass)))
+        {
+            uint32 maxDeferred = sOpcodeCostMgr.GetMaxDeferredPackets();
+            if (maxDeferred && m_throttledQueue[throttleClass].size() >= maxDeferred)
+            {
+                // client keeps sending faster than allowed, drop throttled requests instead of queueing them
+                DEBUG_LOG("SESSION: dropped throttled opcode %s (0x%.4X) of account %u", LookupOpcodeName(opcode), opcode, GetAccountId());
+                sOpcodeCostMgr.AddDropped(opcode);
+            }
+            else
+            {
+                sOpcodeCostMgr.AddThrottled(opcode);
+                m_throttledQueue[throttleClass].push_back(std::move(m_recvQueue.front()));
+            }
+
+            m_recvQueue.pop_front();
+            continue;
+        }
+
+        if (throttleClass != OPCODE_THROTTLE_NONE)
+            ConsumeThrottleToken(throttleClass);
+
+        auto const packet = std::move(queue->front());
+        queue->pop_front();
+        ++processed;
 
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -349,18 +433,46 @@ bool WorldSession::Update(PacketFilter& updater)
     {
         ///- If necessary, log the player out
         const time_t currTime = time(nullptr);
+        const bool disconnected = m_Socket ? m_Socket->IsClosed() : !m_headless;
 
-        if (!m_Socket || m_Socket->IsClosed() || (ShouldLogOut(currTime) && !m_playerLoading))
+        if (disconnected || (ShouldLogOut(currTime) && !m_playerLoading))
             LogoutPlayer(true);
 
         // finalize the session if disconnected.
-        if (!m_Socket || m_Socket->IsClosed())
+        if (disconnected)
             return false;
     }
 
     return true;
 }
 
+SessionUpdateCategory WorldSession::GetUpdateCategory() const
+{
+    if (m_inQueue)
+        return SESSION_UPDATE_QUEUE;
+
+    // login in progress waits for query holder callback
+    if (!_player)
+        return m_playerLoading ? SESSION_UPDATE_TRANSFER : SESSION_UPDATE_CHARACTER_SCREEN;
+
+    if (_player->IsInWorld() && !m_playerLogout)
+        return SESSION_UPDATE_WORLD;
+
+    return SESSION_UPDATE_TRANSFER;
+}
+
+void WorldSession::UpdateOnWorker()
+{
+    SessionWorkerFilter updater(this);
+    Update(updater);
+
+    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    bool const disconnected = m_Socket ? m_Socket->IsClosed() : !m_headless;
+    m_worldUpdateNeeded = disconnected || !m_recvQueue.empty() || _logoutTime;
+    for (uint32 i = OPCODE_THROTTLE_NONE + 1; i < MAX_OPCODE_THROTTLE; ++i)
+        m_worldUpdateNeeded |= !m_throttledQueue[i].empty();
+}
+
 /// %Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
@@ -801,6 +913,31 @@ void WorldSession::SendTransferAborted(uint32 mapid, uint8 reason, uint8 arg) co
     SendPacket(data);
 }
 
+void WorldSession::RefillThrottleTokens()
+{
+    uint32 now = WorldTimer::getMSTime();
+    uint32 diff = m_throttleRefillTime ? WorldTimer::getMSTimeDiff(m_throttleRefillTime, now) : 0;
+    m_throttleRefillTime = now;
+
+    for (uint32 i = OPCODE_THROTTLE_NONE + 1; i < MAX_OPCODE_THROTTLE; ++i)
+    {
+        OpcodeThrottleClass throttleClass = OpcodeThrottleClass(i);
+        m_throttleTokens[i] = std::min(m_throttleTokens[i] + diff * sOpcodeCostMgr.GetThrottleRate(throttleClass), sOpcodeCostMgr.GetThrottleBurst(throttleClass));
+    }
+}
+
+bool WorldSession::HasThrottleToken(OpcodeThrottleClass throttleClass) const
+{
+    // rate 0 disables limit of class
+    return sOpcodeCostMgr.GetThrottleRate(throttleClass) == 0.0f || m_throttleTokens[throttleClass] >= 1.0f;
+}
+
+void WorldSession::ConsumeThrottleToken(OpcodeThrottleClass throttleClass)
+{
+    if (sOpcodeCostMgr.GetThrottleRate(throttleClass) != 0.0f)
+        m_throttleTokens[throttleClass] -= 1.0f;
+}
+
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
 {
     // need prevent do internal far teleports in handlers because some handlers do lot steps
@@ -808,7 +945,12 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
-    (this->*opHandle.handler)(packet);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        PROFILE_ZONE(PROFILE_OPCODE, packet.GetOpcode(), packet.GetOpcodeName());
+        (this->*opHandle.handler)(packet);
+    }
+    sOpcodeCostMgr.AddCall(packet.GetOpcode(), uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
 
     if (_player)
     {
@@ -29,6 +29,7 @@
 #include "AuctionHouse/AuctionHouseMgr.h"
 #include "Entities/Item.h"
 #include "WorldSocket.h"
+#include "Server/SessionUpdater.h"
 
 #include <deque>
 #include <mutex>
@@ -108,6 +109,16 @@ enum TutorialDataState
     TUTORIALDATA_NEW       = 2
 };
 
+// opcodes with expensive handlers limited per session by token bucket, see OpcodeCostMgr
+enum OpcodeThrottleClass
+{
+    OPCODE_THROTTLE_NONE    = 0,
+    OPCODE_THROTTLE_WHO     = 1,                            // who list searches
+    OPCODE_THROTTLE_AUCTION = 2,                            // auction house searches
+    OPCODE_THROTTLE_QUERY   = 3,                            // item, creature, quest and other template queries
+    MAX_OPCODE_THROTTLE
+};
+
 // class to deal with packet processing
 // allows to determine if next packet is safe to be processed
 class PacketFilter
@@ -118,6 +129,8 @@ class PacketFilter
 
         virtual bool Process(WorldPacket const& /*packet*/) const { return true; }
         virtual bool ProcessLogout() const { return true; }
+        // packet and rest of receive queue wait for next update in World::UpdateSessions()
+        virtual bool Defer(WorldPacket const& /*packet*/) const { return false; }
 
     protected:
         WorldSession* const m_pSession;
@@ -146,6 +159,18 @@ class WorldSessionFilter : public PacketFilter
         virtual bool Process(WorldPacket const& packet) const override;
 };
 
+// update of session without player in world by SessionUpdatePool worker thread
+// thread-unsafe handlers and logout are left to World::UpdateSessions()
+class SessionWorkerFilter : public PacketFilter
+{
+    public:
+        explicit SessionWorkerFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+        ~SessionWorkerFilter() {}
+
+        virtual bool ProcessLogout() const override { return false; }
+        virtual bool Defer(WorldPacket const& packet) const override;
+};
+
 /// Player session in the World
 class WorldSession
 {
@@ -158,6 +183,7 @@ class WorldSession
         bool PlayerLoading() const { return m_playerLoading; }
         bool PlayerLogout() const { return m_playerLogout; }
         bool PlayerLogoutWithSave() const { return m_playerLogout && m_playerSave; }
+        bool PlayerRecentlyLogout() const { return m_playerRecentlyLogout; }
 
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
@@ -189,6 +215,14 @@ class WorldSession
 
         /// Session in auth.queue currently
         void SetInQueue(bool state) { m_inQueue = state; }
+        bool IsInQueue() const { return m_inQueue; }
+
+        SessionUpdateCategory GetUpdateCategory() const;
+
+        /// Update by SessionUpdatePool worker, remembers if World::UpdateSessions() still has work for session
+        void UpdateOnWorker();
+        bool IsWorldUpdateNeeded() const { return m_worldUpdateNeeded; }
+        void SetWorldUpdateNeeded() { m_worldUpdateNeeded = true; }
 
         /// Is the user engaged in a log out process?
         bool isLogingOut() const { return _logoutTime || m_playerLogout; }
@@ -208,6 +242,10 @@ class WorldSession
         void LogoutPlayer(bool Save);
         void KickPlayer();
 
+        // session without client connection driven by server side code, not finalized for missing socket
+        void SetHeadless() { m_headless = true; }
+        bool IsHeadless() const { return m_headless; }
+
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
 
         bool Update(PacketFilter& updater);
@@ -273,8 +311,8 @@ class WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction) const;
         static void SendAuctionOutbiddedMail(AuctionEntry* auction);
         static void SendAuctionCancelledToBidderMail(AuctionEntry* auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
-                                   uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const;
+        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, uint32 listfrom, uint32 usable,
+                                   uint32& count, uint32& totalcount, bool isFull) const;
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid) const;
 
@@ -756,12 +794,18 @@ class WorldSession
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
 
+        // token buckets of throttled opcode classes
+        void RefillThrottleTokens();
+        bool HasThrottleToken(OpcodeThrottleClass throttleClass) const;
+        void ConsumeThrottleToken(OpcodeThrottleClass throttleClass);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
         void LogUnprocessedTail(WorldPacket const& packet) const;
 
         Player* _player;
         std::shared_ptr<WorldSocket> m_Socket;              // socket pointer is owned by the network thread which created it
+        bool m_headless;
 
         AccountTypes _security;
         uint32 _accountId;
@@ -782,6 +826,11 @@ class WorldSession
 
         std::mutex m_recvQueueLock;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
+        std::deque<std::unique_ptr<WorldPacket>> m_throttledQueue[MAX_OPCODE_THROTTLE];   // packets waiting for token of their class, guarded by m_recvQueueLock
+
+        float m_throttleTokens[MAX_OPCODE_THROTTLE];
+        uint32 m_throttleRefillTime;                        // ms time of last token refill
+        bool m_worldUpdateNeeded;                           // false only after worker update left nothing for world thread
 };
 #endif
 /// @}
@@ -22,6 +22,9 @@
 #include "Database/DatabaseEnv.h"
 #include "Entities/ObjectGuid.h"
 
+#include <set>
+#include <unordered_map>
+
 class SocialMgr;
 class PlayerSocial;
 class Player;
@@ -72,6 +75,7 @@ struct FriendInfo
 
 typedef std::map<uint32, FriendInfo> PlayerSocialMap;
 typedef std::map<uint32, PlayerSocial> SocialMap;
+typedef std::unordered_map<uint32 /*friend*/, std::set<uint32> /*players with him in friend list*/> FriendListersMap;
 
 /// Results of friend related commands
 enum FriendsResult
@@ -136,7 +140,7 @@ class SocialMgr
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid) { m_socialMap.erase(guid); }
+        void RemovePlayerSocial(uint32 guid);
 
         void GetFriendInfo(Player* player, uint32 friendGUID, FriendInfo& friendInfo) const;
         // Packet management
@@ -146,7 +150,14 @@ class SocialMgr
         // Loading
         PlayerSocial* LoadFromDB(QueryResult* result, ObjectGuid guid);
     private:
+        friend class PlayerSocial;
+
+        // reverse index of loaded friend lists, kept in sync by PlayerSocial changes
+        void AddFriendLister(uint32 friendGuid, uint32 listerGuid) { m_friendListers[friendGuid].insert(listerGuid); }
+        void RemoveFriendLister(uint32 friendGuid, uint32 listerGuid);
+
         SocialMap m_socialMap;
+        FriendListersMap m_friendListers;
 };
 
 #define sSocialMgr MaNGOS::Singleton<SocialMgr>::Instance()
@@ -801,6 +801,8 @@ void Spell::FillTargetMap()
             }
         }
 
+        PrefetchTargetsLineOfSight(tmpUnitLists[effToIndex[i]], SpellEffectIndex(i));
+
         for (UnitList::iterator itr = tmpUnitLists[effToIndex[i]].begin(); itr != tmpUnitLists[effToIndex[i]].end();)
         {
             if (!CheckTarget(*itr, SpellEffectIndex(i)))
@@ -1826,7 +1828,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 case TARGET_RANDOM_ENEMY_CHAIN_IN_AREA:
                 {
                     MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(m_caster, m_spellInfo, max_range);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(tempTargetUnitMap, u_check);
+                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck, UnitList> searcher(tempTargetUnitMap, u_check);
                     Cell::VisitAllObjects(m_caster, searcher, max_range);
                     break;
                 }
@@ -1834,7 +1836,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 case TARGET_RANDOM_FRIEND_CHAIN_IN_AREA:
                 {
                     MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(m_caster, m_spellInfo, max_range);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> searcher(tempTargetUnitMap, u_check);
+                    MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck, UnitList> searcher(tempTargetUnitMap, u_check);
                     Cell::VisitAllObjects(m_caster, searcher, max_range);
                     break;
                 }
@@ -1843,7 +1845,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
             if (tempTargetUnitMap.empty())
                 break;
 
-            tempTargetUnitMap.sort(TargetDistanceOrderNear(m_caster));
+            std::stable_sort(tempTargetUnitMap.begin(), tempTargetUnitMap.end(), TargetDistanceOrderNear(m_caster));
 
             // Now to get us a random target that's in the initial range of the spell
             uint32 t = 0;
@@ -1861,7 +1863,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
 
             tempTargetUnitMap.erase(itr);
 
-            tempTargetUnitMap.sort(TargetDistanceOrderNear(pUnitTarget));
+            std::stable_sort(tempTargetUnitMap.begin(), tempTargetUnitMap.end(), TargetDistanceOrderNear(pUnitTarget));
 
             t = unMaxTargets - 1;
             Unit* prev = pUnitTarget;
@@ -1880,7 +1882,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 prev = *next;
                 targetUnitMap.push_back(prev);
                 tempTargetUnitMap.erase(next);
-                tempTargetUnitMap.sort(TargetDistanceOrderNear(prev));
+                std::stable_sort(tempTargetUnitMap.begin(), tempTargetUnitMap.end(), TargetDistanceOrderNear(prev));
                 next = tempTargetUnitMap.begin();
                 --t;
             }
@@ -1946,10 +1948,10 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 UnitList unsteadyTargetMap;
                 {
                     MaNGOS::AnyUnitInObjectRangeCheck u_check(newUnitTarget, maxRadiusTarget);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(unsteadyTargetMap, u_check);
+                    MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck, UnitList> searcher(unsteadyTargetMap, u_check);
                     Cell::VisitAllObjects(newUnitTarget, searcher, maxRadiusTarget);
-                    unsteadyTargetMap.remove(m_caster);
-                    unsteadyTargetMap.remove(newUnitTarget);
+                    unsteadyTargetMap.erase(std::remove(unsteadyTargetMap.begin(), unsteadyTargetMap.end(), m_caster), unsteadyTargetMap.end());
+                    unsteadyTargetMap.erase(std::remove(unsteadyTargetMap.begin(), unsteadyTargetMap.end(), newUnitTarget), unsteadyTargetMap.end());
                 }
 
                 // No targets. No need to process.
@@ -1961,7 +1963,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                     for (auto iter = unsteadyTargetMap.begin(); iter != unsteadyTargetMap.end();)
                     {
                         if ((*iter)->IsWithinDist(m_caster, minRadiusCaster))
-                            unsteadyTargetMap.erase(iter++);
+                            iter = unsteadyTargetMap.erase(iter);
                         else
                             ++iter;
                     }
@@ -1974,28 +1976,28 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 {
                     if (!m_caster->CanAttackSpell((*activeUnit), m_spellInfo, true))
                     {
-                        unsteadyTargetMap.erase(activeUnit++);
+                        activeUnit = unsteadyTargetMap.erase(activeUnit);
                         continue;
                     }
 
                     // Remove not LOS(Line of Sight) targets
                     if (!ignoreLos && !originalCaster->IsWithinLOSInMap(static_cast<WorldObject*>(*activeUnit)))
                     {
-                        unsteadyTargetMap.erase(activeUnit++);
+                        activeUnit = unsteadyTargetMap.erase(activeUnit);
                         continue;
                     }
 
                     // If spell targets only players
                     if ((m_spellInfo->AttributesEx3 & SPELL_ATTR_EX3_TARGET_ONLY_PLAYER) && ((*activeUnit)->GetTypeId() != TYPEID_PLAYER))
                     {
-                        unsteadyTargetMap.erase(activeUnit++);
+                        activeUnit = unsteadyTargetMap.erase(activeUnit);
                         continue;
                     }
 
                     // Mother Shahraz beams can target totems. Workadound for a while...
                     if (!(m_spellInfo->AttributesEx3 & SPELL_ATTR_EX3_UNK31) && ((Creature const*)(*activeUnit))->IsTotem())
                     {
-                        unsteadyTargetMap.erase(activeUnit++);
+                        activeUnit = unsteadyTargetMap.erase(activeUnit);
                         continue;
                     }
 
@@ -2003,14 +2005,14 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                     if (((m_spellInfo->AttributesEx5 & SPELL_ATTR_EX5_CLEAVE_FRONT_TARGET || GetSpellSchoolMask(m_spellInfo) == SPELL_SCHOOL_MASK_NORMAL))
                         && !originalCaster->HasInArc(static_cast<WorldObject*>(*activeUnit)))
                     {
-                        unsteadyTargetMap.erase(activeUnit++);
+                        activeUnit = unsteadyTargetMap.erase(activeUnit);
                         continue;
                     }
 
                     // If spell have ingore CC attr & unit is CC
                     if (m_spellInfo->AttributesEx6 & SPELL_ATTR_EX6_IGNORE_CC_TARGETS && !(*activeUnit)->CanFreeMove())
                     {
-                        unsteadyTargetMap.erase(activeUnit++);
+                        activeUnit = unsteadyTargetMap.erase(activeUnit);
                         continue;
                     }
 
@@ -2018,7 +2020,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 }
 
                 uint32 t = m_spellInfo->EffectChainTarget[effIndex] - 1;
-                unsteadyTargetMap.sort(TargetDistanceOrderNear(newUnitTarget));
+                std::stable_sort(unsteadyTargetMap.begin(), unsteadyTargetMap.end(), TargetDistanceOrderNear(newUnitTarget));
 
                 if (IsChainAOESpell(m_spellInfo)) // Spell like Multi-Shot
                 {
@@ -2050,7 +2052,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                         if (!CheckAndAddMagnetTarget(prev, effIndex, targetUnitMap))
                             targetUnitMap.push_back(prev);
                         unsteadyTargetMap.erase(next);
-                        unsteadyTargetMap.sort(TargetDistanceOrderNear(prev));
+                        std::stable_sort(unsteadyTargetMap.begin(), unsteadyTargetMap.end(), TargetDistanceOrderNear(prev));
                         next = unsteadyTargetMap.begin();
 
                         --t;
@@ -2066,7 +2068,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
             {
                 if (targetUnitMap.size() > unMaxTargets)
                 {
-                    targetUnitMap.sort(TargetDistanceOrderFarAway(m_caster));
+                    std::stable_sort(targetUnitMap.begin(), targetUnitMap.end(), TargetDistanceOrderFarAway(m_caster));
                     targetUnitMap.resize(unMaxTargets);
                 }
             }
@@ -2083,7 +2085,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                     case 40618:                             // Insignificance
                     case 41376:                             // Spite
                         if (Unit* pVictim = m_caster->getVictim())
-                            targetUnitMap.remove(pVictim);
+                            targetUnitMap.erase(std::remove(targetUnitMap.begin(), targetUnitMap.end(), pVictim), targetUnitMap.end());
                         break;
                 }
             }
@@ -2527,9 +2529,9 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                 FillAreaTargets(tempTargetUnitMap, max_range, PUSH_SELF_CENTER, SPELL_TARGETS_ASSISTABLE);
 
                 if (m_caster != pUnitTarget && std::find(tempTargetUnitMap.begin(), tempTargetUnitMap.end(), m_caster) == tempTargetUnitMap.end())
-                    tempTargetUnitMap.push_front(m_caster);
+                    tempTargetUnitMap.insert(tempTargetUnitMap.begin(), m_caster);
 
-                tempTargetUnitMap.sort(LowestHPNearestOrder(pUnitTarget));
+                std::stable_sort(tempTargetUnitMap.begin(), tempTargetUnitMap.end(), LowestHPNearestOrder(pUnitTarget));
 
                 if (tempTargetUnitMap.empty())
                     break;
@@ -2565,7 +2567,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
                     prev = *next;
                     targetUnitMap.push_back(prev);
                     tempTargetUnitMap.erase(next);
-                    tempTargetUnitMap.sort(LowestHPNearestOrder(prev));
+                    std::stable_sort(tempTargetUnitMap.begin(), tempTargetUnitMap.end(), LowestHPNearestOrder(prev));
                     next = tempTargetUnitMap.begin();
 
                     --t;
@@ -2931,7 +2933,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
     if (m_spellInfo->HasAttribute(SPELL_ATTR_EX_CANT_TARGET_SELF))
     {
         if (targetMode != TARGET_SELF && targetMode != TARGET_SELF2 && m_spellInfo->Effect[effIndex] != SPELL_EFFECT_SUMMON)
-            targetUnitMap.remove(m_caster);
+            targetUnitMap.erase(std::remove(targetUnitMap.begin(), targetUnitMap.end(), m_caster), targetUnitMap.end());
     }
 
     if (!tempTargetGOList.empty())                          // GO CASE
@@ -6966,20 +6968,12 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff) const
             // all ok by some way or another, skip normal check
             break;
         default:                                            // normal case
-            if (!IsIgnoreLosSpellEffect(m_spellInfo, eff))
+            if (!IsIgnoreLosSpellEffect(m_spellInfo, eff) && target != m_caster)
             {
-                if (target != m_caster)
-                {
-                    if (m_spellInfo->EffectImplicitTargetA[eff] == TARGET_DYNAMIC_OBJECT_COORDINATES)
-                    {
-                        if (DynamicObject* dynObj = m_caster->GetDynObject(m_triggeredByAuraSpell ? m_triggeredByAuraSpell->Id : m_spellInfo->Id))
-                            if (!target->IsWithinLOSInMap(dynObj))
-                                return false;
-                    }
-                    else if (WorldObject* caster = GetCastingObject())
-                        if (!target->IsWithinLOSInMap(caster))
-                            return false;
-                }
+                // traced from source, same as PrefetchTargetsLineOfSight so its results are found in collision cache
+                if (WorldObject* source = GetLineOfSightSource(eff))
+                    if (!source->IsWithinLOSInMap(target))
+                        return false;
             }
             break;
     }
@@ -7220,7 +7214,85 @@ SpellCastResult Spell::CanOpenLock(SpellEffectIndex effIndex, uint32 lockId, Ski
 void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster /*=nullptr*/)
 {
     MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, targetUnitMap, radius, pushType, spellTargets, originalCaster);
-    Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+
+    float searchRadius;
+    if (!notifier.GetSearchRadius(searchRadius))
+        return;
+
+    // broad phase over per tick position snapshots, exact checks are done by notifier
+    UnitPositionIndex& positionIndex = m_caster->GetMap()->GetUnitPositionIndex();
+    UnitList candidates;
+    positionIndex.AcquireScratchList(candidates);
+    positionIndex.CollectUnits(notifier.GetCenterX(), notifier.GetCenterY(), notifier.GetCenterZ(), searchRadius, pushType == PUSH_DEST_CENTER, candidates);
+
+    for (UnitList::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+        notifier.Notify(*itr);
+
+    positionIndex.ReleaseScratchList(candidates);
+}
+
+WorldObject* Spell::GetLineOfSightSource(SpellEffectIndex eff) const
+{
+    if (m_spellInfo->EffectImplicitTargetA[eff] == TARGET_DYNAMIC_OBJECT_COORDINATES)
+        return m_caster->GetDynObject(m_triggeredByAuraSpell ? m_triggeredByAuraSpell->Id : m_spellInfo->Id);
+
+    return GetCastingObject();
+}
+
+/**
+ * Area effects check line of sight from one source to every target, trace them in batches of
+ * VMAP_MAX_LOS_BATCH rays through map trees ahead of CheckTarget, which then finds them in collision cache.
+ */
+void Spell::PrefetchTargetsLineOfSight(UnitList const& targetUnitMap, SpellEffectIndex eff) const
+{
+    if (targetUnitMap.size() < 2 || !m_caster->GetMap()->IsCollisionCacheEnabled())
+        return;
+
+    // only normal case of CheckTarget line of sight check
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return;
+        case SPELL_EFFECT_DUMMY:
+            if (m_spellInfo->Id == 20577)                   // Cannibalize
+                return;
+            break;
+        default:
+            break;
+    }
+
+    if (IsIgnoreLosSpellEffect(m_spellInfo, eff))
+        return;
+
+    WorldObject* source = GetLineOfSightSource(eff);
+    if (!source)
+        return;
+
+    // same points as WorldObject::IsWithinLOS
+    float srcX, srcY, srcZ;
+    source->GetPosition(srcX, srcY, srcZ);
+    srcZ += 2.0f;
+
+    float targets[VMAP_MAX_LOS_BATCH * 3];
+    uint32 count = 0;
+    for (UnitList::const_iterator itr = targetUnitMap.begin(); itr != targetUnitMap.end(); ++itr)
+    {
+        Unit* target = *itr;
+        if (target == m_caster || !source->IsInMap(target))
+            continue;
+
+        target->GetPosition(targets[3 * count], targets[3 * count + 1], targets[3 * count + 2]);
+        targets[3 * count + 2] += 2.0f;
+        if (++count == VMAP_MAX_LOS_BATCH)
+        {
+            source->GetMap()->GetLineOfSightMask(srcX, srcY, srcZ, targets, count);
+            count = 0;
+        }
+    }
+
+    if (count > 1)
+        source->GetMap()->GetLineOfSightMask(srcX, srcY, srcZ, targets, count);
 }
 
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster) const
@@ -538,7 +538,7 @@ class Spell
 
         bool CanBeInterrupted() { return m_spellState <= SPELL_STATE_DELAYED || m_spellState == SPELL_STATE_CHANNELING; }
 
-        typedef std::list<Unit*> UnitList;
+        typedef std::vector<Unit*> UnitList;
 
     protected:
         void SendLoot(ObjectGuid guid, LootType loottype, LockType lockType);
@@ -616,6 +616,8 @@ class Spell
 
         void FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster = nullptr);
         void FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster) const;
+        WorldObject* GetLineOfSightSource(SpellEffectIndex eff) const;
+        void PrefetchTargetsLineOfSight(UnitList const& targetUnitMap, SpellEffectIndex eff) const;
 
         // Returns a target that was filled by SPELL_SCRIPT_TARGET (or selected victim) Can return nullptr
         Unit* GetPrefilledUnitTargetOrUnitTarget(SpellEffectIndex effIndex) const;
@@ -767,11 +769,13 @@ namespace MaNGOS
 
         float GetCenterX() const { return i_centerX; }
         float GetCenterY() const { return i_centerY; }
+        float GetCenterZ() const { return i_centerZ; }
 
         SpellNotifierCreatureAndPlayer(Spell& spell, Spell::UnitList& data, float radius, SpellNotifyPushType type,
                                        SpellTargets TargetType = SPELL_TARGETS_AOE_ATTACKABLE, WorldObject* originalCaster = nullptr)
             : i_data(&data), i_spell(spell), i_push_type(type), i_radius(radius), i_TargetType(TargetType),
-              i_originalCaster(originalCaster), i_castingObject(i_spell.GetCastingObject())
+              i_originalCaster(originalCaster), i_castingObject(i_spell.GetCastingObject()),
+              i_centerX(0.0f), i_centerY(0.0f), i_centerZ(0.0f)
         {
             if (!i_originalCaster)
                 i_originalCaster = i_spell.GetAffectiveCasterObject();
@@ -786,10 +790,7 @@ namespace MaNGOS
                 case PUSH_IN_BACK_90:
                 case PUSH_SELF_CENTER:
                     if (i_castingObject)
-                    {
-                        i_centerX = i_castingObject->GetPositionX();
-                        i_centerY = i_castingObject->GetPositionY();
-                    }
+                        i_castingObject->GetPosition(i_centerX, i_centerY, i_centerZ);
                     break;
                 case PUSH_DEST_CENTER:
                     if (i_spell.m_targets.m_targetMask & TARGET_FLAG_SOURCE_LOCATION)
@@ -799,16 +800,30 @@ namespace MaNGOS
                     break;
                 case PUSH_TARGET_CENTER:
                     if (Unit* target = i_spell.m_targets.getUnitTarget())
-                    {
-                        i_centerX = target->GetPositionX();
-                        i_centerY = target->GetPositionY();
-                    }
+                        target->GetPosition(i_centerX, i_centerY, i_centerZ);
                     break;
                 default:
                     sLog.outError("SpellNotifierCreatureAndPlayer: unsupported PUSH_* case %u.", i_push_type);
             }
         }
 
+        // Radius around center that contains every possible target, not counting target bounding radius
+        bool GetSearchRadius(float& radius) const
+        {
+            if (!i_originalCaster || !i_castingObject)
+                return false;
+
+            radius = i_radius;
+            if (i_push_type == PUSH_TARGET_CENTER)
+            {
+                Unit* target = i_spell.m_targets.getUnitTarget();
+                if (!target)
+                    return false;
+                radius += target->GetObjectBoundingRadius();
+            }
+            return true;
+        }
+
         template<class T> inline void Visit(GridRefManager<T>&  m)
         {
             MANGOS_ASSERT(i_data);
@@ -817,73 +832,81 @@ namespace MaNGOS
                 return;
 
             for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
-            {
-                // there are still more spells which can be casted on dead, but
-                // they are no AOE and don't have such a nice SPELL_ATTR flag
-                // mostly phase check
-                if (!itr->getSource()->IsInMap(i_originalCaster) || itr->getSource()->IsTaxiFlying())
-                    continue;
+                Notify(itr->getSource());
+        }
 
-                switch (i_TargetType)
-                {
-                    case SPELL_TARGETS_ASSISTABLE:
-                        if (itr->getSource()->GetTypeId() == TYPEID_UNIT && ((Creature*)itr->getSource())->IsTotem())
-                            continue;
-
-                        if (!i_originalCaster->CanAssistSpell(itr->getSource(), i_spell.m_spellInfo))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_AOE_ATTACKABLE:
-                    {
-                        if (itr->getSource()->GetTypeId() == TYPEID_UNIT && ((Creature*)itr->getSource())->IsTotem())
-                            continue;
-
-                        if (!i_originalCaster->CanAttackSpell(itr->getSource(), i_spell.m_spellInfo, true))
-                            continue;
-                    }
+        void Notify(Unit* unit)
+        {
+            // there are still more spells which can be casted on dead, but
+            // they are no AOE and don't have such a nice SPELL_ATTR flag
+            // mostly phase check
+            if (!unit->IsInMap(i_originalCaster) || unit->IsTaxiFlying())
+                return;
+
+            // geometry first, it is far cheaper than the faction checks below
+            // we don't need to check InMap here, it's already done some lines above
+            switch (i_push_type)
+            {
+                case PUSH_IN_FRONT:
+                    if (!i_castingObject->isInFront(unit, i_radius, M_PI_F)) //should only be 180 degrees NOT 120 degrees
+                        return;
                     break;
-                    case SPELL_TARGETS_ALL:
-                        break;
-                    default: continue;
-                }
+                case PUSH_IN_FRONT_90:
+                    if (!i_castingObject->isInFront(unit, i_radius, M_PI_F / 2))
+                        return;
+                    break;
+                case PUSH_IN_FRONT_60:
+                    if (!i_castingObject->isInFront(unit, i_radius, M_PI_F / 3))
+                        return;
+                    break;
+                case PUSH_IN_FRONT_15:
+                    if (!i_castingObject->isInFront(unit, i_radius, M_PI_F / 12))
+                        return;
+                    break;
+                case PUSH_IN_BACK_90:
+                    if (!i_castingObject->isInBack(unit, i_radius, M_PI_F / 2))  //only used for tail swipe in TBC afaik, and that should be 90 degrees in the back
+                        return;
+                    break;
+                case PUSH_SELF_CENTER:
+                    if (!unit->IsWithinDist2d(i_centerX, i_centerY, i_radius))
+                        return;
+                    break;
+                case PUSH_DEST_CENTER:
+                    if (!unit->IsWithinDist3d(i_centerX, i_centerY, i_centerZ, i_radius))
+                        return;
+                    break;
+                case PUSH_TARGET_CENTER:
+                    if (!i_spell.m_targets.getUnitTarget() || !i_spell.m_targets.getUnitTarget()->IsWithinDist(unit, i_radius))
+                        return;
+                    break;
+                default:
+                    return;
+            }
+
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_ASSISTABLE:
+                    if (unit->GetTypeId() == TYPEID_UNIT && ((Creature*)unit)->IsTotem())
+                        return;
 
-                // we don't need to check InMap here, it's already done some lines above
-                switch (i_push_type)
+                    if (!i_originalCaster->CanAssistSpell(unit, i_spell.m_spellInfo))
+                        return;
+                    break;
+                case SPELL_TARGETS_AOE_ATTACKABLE:
                 {
-                    case PUSH_IN_FRONT:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, M_PI_F)) //should only be 180 degrees NOT 120 degrees
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_FRONT_90:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, M_PI_F / 2))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_FRONT_60:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, M_PI_F / 3))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_FRONT_15:
-                        if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, M_PI_F / 12))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_IN_BACK_90:
-                        if (i_castingObject->isInBack((Unit*)(itr->getSource()), i_radius, M_PI_F / 2))  //only used for tail swipe in TBC afaik, and that should be 90 degrees in the back
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_SELF_CENTER:
-                        if (itr->getSource()->IsWithinDist2d(i_centerX, i_centerY, i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_DEST_CENTER:
-                        if (itr->getSource()->IsWithinDist3d(i_centerX, i_centerY, i_centerZ, i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
-                    case PUSH_TARGET_CENTER:
-                        if (i_spell.m_targets.getUnitTarget() && i_spell.m_targets.getUnitTarget()->IsWithinDist((Unit*)(itr->getSource()), i_radius))
-                            i_data->push_back(itr->getSource());
-                        break;
+                    if (unit->GetTypeId() == TYPEID_UNIT && ((Creature*)unit)->IsTotem())
+                        return;
+
+                    if (!i_originalCaster->CanAttackSpell(unit, i_spell.m_spellInfo, true))
+                        return;
                 }
+                break;
+                case SPELL_TARGETS_ALL:
+                    break;
+                default: return;
             }
+
+            i_data->push_back(unit);
         }
 
 #ifdef _MSC_VER
@@ -517,6 +517,7 @@ SpellCastResult GetErrorAtShapeshiftedCast(SpellEntry const* spellInfo, uint32 f
 void SpellMgr::LoadSpellTargetPositions()
 {
     mSpellTargetPositions.clear();                          // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     uint32 count = 0;
 
@@ -778,6 +779,7 @@ struct DoSpellProcEvent
 void SpellMgr::LoadSpellProcEvents()
 {
     mSpellProcEventMap.clear();                             // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     //                                                0      1           2                3                 4                 5                 6          7       8        9             10
     QueryResult* result = WorldDatabase.Query("SELECT entry, SchoolMask, SpellFamilyName, SpellFamilyMask0, SpellFamilyMask1, SpellFamilyMask2, procFlags, procEx, ppmRate, CustomChance, Cooldown FROM spell_proc_event");
@@ -839,6 +841,7 @@ struct DoSpellProcItemEnchant
 void SpellMgr::LoadSpellProcItemEnchant()
 {
     mSpellProcItemEnchantMap.clear();                       // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     uint32 count = 0;
 
@@ -909,6 +912,7 @@ struct DoSpellBonuses
 void SpellMgr::LoadSpellBonuses()
 {
     mSpellBonusMap.clear();                             // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
     uint32 count = 0;
     //                                                0      1             2          3
     QueryResult* result = WorldDatabase.Query("SELECT entry, direct_bonus, dot_bonus, ap_bonus, ap_dot_bonus FROM spell_bonus_data");
@@ -1138,6 +1142,7 @@ bool SpellMgr::IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellPr
 void SpellMgr::LoadSpellElixirs()
 {
     mSpellElixirs.clear();                                  // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     uint32 count = 0;
 
@@ -1241,6 +1246,7 @@ struct DoSpellThreat
 void SpellMgr::LoadSpellThreats()
 {
     mSpellThreatMap.clear();                                // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     //                                                0      1       2           3
     QueryResult* result = WorldDatabase.Query("SELECT entry, Threat, multiplier, ap_bonus FROM spell_threat");
@@ -1535,6 +1541,7 @@ void SpellMgr::LoadSpellChains()
 {
     mSpellChains.clear();                                   // need for reload case
     mSpellChainsNext.clear();                               // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     // load known data for talents
     for (unsigned int i = 0; i < sTalentStore.GetNumRows(); ++i)
@@ -2306,6 +2313,7 @@ bool SpellMgr::IsSpellValid(SpellEntry const* spellInfo, Player* pl, bool msg)
 void SpellMgr::LoadSpellAreas()
 {
     mSpellAreaMap.clear();                                  // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
     mSpellAreaForAuraMap.clear();
 
     uint32 count = 0;
@@ -3152,6 +3160,7 @@ struct DoSpellAffectMasks
 void SpellMgr::LoadSpellAffects()
 {
     mSpellAffectMap.clear();                                // need for reload case
+    mSpellCompiledInfo.clear();                             // points into reloaded data
 
     uint32 count = 0;
 
@@ -3264,3 +3273,53 @@ void SpellMgr::LoadSpellAffects()
         }
     }
 }
+
+void SpellMgr::BuildSpellCompiledInfo()
+{
+    mSpellCompiledInfo.clear();                             // lookups below must use side tables
+
+    SpellCompiledInfoVector compiled(sSpellTemplate.GetMaxEntry());
+
+    BarGoLink bar(compiled.size());
+
+    uint32 count = 0;
+    for (uint32 spellId = 1; spellId < compiled.size(); ++spellId)
+    {
+        bar.step();
+
+        SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
+        if (!spellInfo)
+            continue;
+
+        SpellCompiledInfo& info = compiled[spellId];
+        info.entry = spellInfo;
+        info.chain = GetSpellChainNode(spellId);
+        info.bonus = GetSpellBonusData(spellId);
+        info.threat = GetSpellThreatEntry(spellId);
+        info.procEvent = GetSpellProcEvent(spellId);
+        info.targetPosition = GetSpellTargetPosition(spellId);
+        info.itemEnchantProcChance = GetItemEnchantProcChance(spellId);
+        info.elixirMask = uint8(GetSpellElixirMask(spellId));
+        info.hasNextRank = mSpellChainsNext.find(spellId) != mSpellChainsNext.end();
+        info.hasSpellArea = mSpellAreaMap.find(spellId) != mSpellAreaMap.end();
+
+        for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+        {
+            info.affectMask[i] = GetSpellAffectMask(spellId, SpellEffectIndex(i));
+
+            if (!spellInfo->Effect[i])
+                continue;
+
+            info.effectMask |= (1 << i);
+            if (IsPositiveEffect(spellInfo, SpellEffectIndex(i)))
+                info.positiveEffectMask |= (1 << i);
+        }
+
+        ++count;
+    }
+
+    mSpellCompiledInfo.swap(compiled);
+
+    sLog.outString(">> Compiled side table data for %u spells (%u KB)", count, uint32(mSpellCompiledInfo.capacity() * sizeof(SpellCompiledInfo) / 1024));
+    sLog.outString();
+}
@@ -1055,17 +1055,8 @@ inline bool IsPositiveSpellTargetMode(uint32 spellId, const WorldObject* caster,
     return IsPositiveSpellTargetMode(sSpellTemplate.LookupEntry<SpellEntry>(spellId), caster, target);
 }
 
-inline bool IsPositiveSpell(const SpellEntry* entry, const WorldObject* caster = nullptr, const WorldObject* target = nullptr)
-{
-    if (!entry)
-        return false;
-    // spells with at least one negative effect are considered negative
-    // some self-applied spells have negative effects but in self casting case negative check ignored.
-    for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
-        if (entry->Effect[i] && !IsPositiveEffect(entry, SpellEffectIndex(i), caster, target))
-            return false;
-    return true;
-}
+// defined after SpellMgr: context free calls use the precomputed SpellCompiledInfo
+inline bool IsPositiveSpell(const SpellEntry* entry, const WorldObject* caster = nullptr, const WorldObject* target = nullptr);
 
 // this is propably the correct check for most positivity/negativity decisions
 inline bool IsPositiveEffectMask(const SpellEntry* entry, uint8 effectMask, const WorldObject* caster = nullptr, const WorldObject* target = nullptr)
@@ -1080,12 +1071,7 @@ inline bool IsPositiveEffectMask(const SpellEntry* entry, uint8 effectMask, cons
     return true;
 }
 
-inline bool IsPositiveSpell(uint32 spellId, const WorldObject* caster = nullptr, const WorldObject* target = nullptr)
-{
-    if (!spellId)
-        return false;
-    return IsPositiveSpell(sSpellTemplate.LookupEntry<SpellEntry>(spellId), caster, target);
-}
+inline bool IsPositiveSpell(uint32 spellId, const WorldObject* caster = nullptr, const WorldObject* target = nullptr);
 
 inline bool IsSpellDoNotReportFailure(SpellEntry const* spellInfo)
 {
@@ -2087,6 +2073,32 @@ inline bool IsProfessionOrRidingSkill(uint32 skill)
     return  IsProfessionSkill(skill) || skill == SKILL_RIDING;
 }
 
+// Per spell id view of the SpellMgr side tables, rebuilt by SpellMgr::BuildSpellCompiledInfo() after (re)load
+// Pointers reference the owning SpellMgr maps, so one indexed access replaces several map lookups in hot paths
+struct SpellCompiledInfo
+{
+    SpellCompiledInfo() : entry(nullptr), chain(nullptr), bonus(nullptr), threat(nullptr), procEvent(nullptr), targetPosition(nullptr),
+        itemEnchantProcChance(0.0f), elixirMask(0), effectMask(0), positiveEffectMask(0), hasNextRank(false), hasSpellArea(false) {}
+
+    SpellEntry const* entry;                                // nullptr for unused spell ids
+    SpellChainNode const* chain;
+    SpellBonusEntry const* bonus;
+    SpellThreatEntry const* threat;
+    SpellProcEventEntry const* procEvent;
+    SpellTargetPosition const* targetPosition;
+    ClassFamilyMask affectMask[MAX_EFFECT_INDEX];           // spell_affect data or EffectItemType
+    float itemEnchantProcChance;
+    uint8 elixirMask;
+    uint8 effectMask;                                       // effect indexes with non zero Effect
+    uint8 positiveEffectMask;                               // IsPositiveEffect() result without caster/target context
+    bool hasNextRank;                                       // spell has entries in SpellChainMapNext
+    bool hasSpellArea;                                      // spell has entries in SpellAreaMap
+
+    bool IsPositive() const { return (positiveEffectMask & effectMask) == effectMask; }
+};
+
+typedef std::vector<SpellCompiledInfo> SpellCompiledInfoVector;
+
 class SpellMgr
 {
         friend struct DoSpellBonuses;
@@ -2100,9 +2112,18 @@ class SpellMgr
 
         // Accessors (const or static functions)
     public:
+        // Precomputed side table data, nullptr while not built (loading/reloading) or for ids above max spell entry
+        SpellCompiledInfo const* GetSpellCompiledInfo(uint32 spellId) const
+        {
+            return spellId < mSpellCompiledInfo.size() ? &mSpellCompiledInfo[spellId] : nullptr;
+        }
+
         // Spell affects
         ClassFamilyMask GetSpellAffectMask(uint32 spellId, SpellEffectIndex effectId) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellId))
+                return info->affectMask[effectId];
+
             SpellAffectMap::const_iterator itr = mSpellAffectMap.find((spellId << 8) + effectId);
             if (itr != mSpellAffectMap.end())
                 return ClassFamilyMask(itr->second);
@@ -2115,6 +2136,9 @@ class SpellMgr
 
         uint32 GetSpellElixirMask(uint32 spellid) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellid))
+                return info->elixirMask;
+
             SpellElixirMap::const_iterator itr = mSpellElixirs.find(spellid);
             if (itr == mSpellElixirs.end())
                 return 0x0;
@@ -2214,6 +2238,9 @@ class SpellMgr
 
         SpellThreatEntry const* GetSpellThreatEntry(uint32 spellid) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellid))
+                return info->threat;
+
             SpellThreatMap::const_iterator itr = mSpellThreatMap.find(spellid);
             if (itr != mSpellThreatMap.end())
                 return &itr->second;
@@ -2235,6 +2262,9 @@ class SpellMgr
         // Spell proc events
         SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellId))
+                return info->procEvent;
+
             SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(spellId);
             if (itr != mSpellProcEventMap.end())
                 return &itr->second;
@@ -2244,6 +2274,9 @@ class SpellMgr
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellid))
+                return info->itemEnchantProcChance;
+
             SpellProcItemEnchantMap::const_iterator itr = mSpellProcItemEnchantMap.find(spellid);
             if (itr == mSpellProcItemEnchantMap.end())
                 return 0.0f;
@@ -2256,6 +2289,9 @@ class SpellMgr
         // Spell bonus data
         SpellBonusEntry const* GetSpellBonusData(uint32 spellId) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellId))
+                return info->bonus;
+
             // Lookup data
             SpellBonusMap::const_iterator itr = mSpellBonusMap.find(spellId);
             if (itr != mSpellBonusMap.end())
@@ -2267,6 +2303,9 @@ class SpellMgr
         // Spell target coordinates
         SpellTargetPosition const* GetSpellTargetPosition(uint32 spell_id) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spell_id))
+                return info->targetPosition;
+
             SpellTargetPositionMap::const_iterator itr = mSpellTargetPositions.find(spell_id);
             if (itr != mSpellTargetPositions.end())
                 return &itr->second;
@@ -2276,6 +2315,9 @@ class SpellMgr
         // Spell ranks chains
         SpellChainNode const* GetSpellChainNode(uint32 spell_id) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spell_id))
+                return info->chain;
+
             SpellChainMap::const_iterator itr = mSpellChains.find(spell_id);
             if (itr == mSpellChains.end())
                 return nullptr;
@@ -2304,6 +2346,10 @@ class SpellMgr
         template<typename Worker>
         void doForHighRanks(uint32 spellid, Worker& worker)
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spellid))
+                if (!info->hasNextRank)
+                    return;
+
             SpellChainMapNext const& nextMap = GetSpellChainNext();
             for (SpellChainMapNext::const_iterator itr = nextMap.lower_bound(spellid); itr != nextMap.upper_bound(spellid); ++itr)
             {
@@ -2324,17 +2370,17 @@ class SpellMgr
 
         bool IsHighRankOfSpell(uint32 spell1, uint32 spell2) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell1);
+            SpellChainNode const* node = GetSpellChainNode(spell1);
 
             uint32 rank2 = GetSpellRank(spell2);
 
             // not ordered correctly by rank value
-            if (itr == mSpellChains.end() || !rank2 || itr->second.rank <= rank2)
+            if (!node || !rank2 || node->rank <= rank2)
                 return false;
 
             // check present in same rank chain
-            for (; itr != mSpellChains.end(); itr = mSpellChains.find(itr->second.prev))
-                if (itr->second.prev == spell2)
+            for (; node; node = GetSpellChainNode(node->prev))
+                if (node->prev == spell2)
                     return true;
 
             return false;
@@ -2444,6 +2490,10 @@ class SpellMgr
 
         SpellAreaMapBounds GetSpellAreaMapBounds(uint32 spell_id) const
         {
+            if (SpellCompiledInfo const* info = GetSpellCompiledInfo(spell_id))
+                if (!info->hasSpellArea)
+                    return SpellAreaMapBounds(mSpellAreaMap.end(), mSpellAreaMap.end());
+
             return mSpellAreaMap.equal_range(spell_id);
         }
 
@@ -2480,6 +2530,9 @@ class SpellMgr
         void LoadSpellPetAuras();
         void LoadSpellAreas();
 
+        // Must be called after all spell side tables above are (re)loaded
+        void BuildSpellCompiledInfo();
+
     private:
         SpellChainMap      mSpellChains;
         SpellChainMapNext  mSpellChainsNext;
@@ -2498,7 +2551,34 @@ class SpellMgr
         SpellAreaMap         mSpellAreaMap;
         SpellAreaForAuraMap  mSpellAreaForAuraMap;
         SpellAreaForAreaMap  mSpellAreaForAreaMap;
+
+        SpellCompiledInfoVector mSpellCompiledInfo;
 };
 
 #define sSpellMgr SpellMgr::Instance()
+
+inline bool IsPositiveSpell(const SpellEntry* entry, const WorldObject* caster, const WorldObject* target)
+{
+    if (!entry)
+        return false;
+    // without caster/target context result depends only at spell data
+    if (!caster && !target)
+        if (SpellCompiledInfo const* info = sSpellMgr.GetSpellCompiledInfo(entry->Id))
+            return info->IsPositive();
+    // spells with at least one negative effect are considered negative
+    // some self-applied spells have negative effects but in self casting case negative check ignored.
+    for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
+        if (entry->Effect[i] && !IsPositiveEffect(entry, SpellEffectIndex(i), caster, target))
+            return false;
+    return true;
+}
+
+inline bool IsPositiveSpell(uint32 spellId, const WorldObject* caster, const WorldObject* target)
+{
+    if (!spellId)
+        return false;
+    if (SpellCompiledInfo const* info = sSpellMgr.GetSpellCompiledInfo(spellId))
+        return IsPositiveSpell(info->entry, caster, target);
+    return IsPositiveSpell(sSpellTemplate.LookupEntry<SpellEntry>(spellId), caster, target);
+}
 #endif
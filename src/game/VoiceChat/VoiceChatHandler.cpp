@@ -21,6 +21,7 @@
 #include "Server/WorldSession.h"
 #include "Log.h"
 
+// thread-safe: only read
 void WorldSession::HandleVoiceSessionEnableOpcode(WorldPacket& recv_data)
 {
     DEBUG_LOG("WORLD: CMSG_VOICE_SESSION_ENABLE");
@@ -37,6 +38,7 @@ void WorldSession::HandleChannelVoiceOnOpcode(WorldPacket& recv_data)
     recv_data.hexlike();
 }
 
+// thread-safe: only read
 void WorldSession::HandleSetActiveVoiceChannel(WorldPacket& recv_data)
 {
     DEBUG_LOG("WORLD: CMSG_SET_ACTIVE_VOICE_CHANNEL");
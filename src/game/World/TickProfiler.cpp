@@ -0,0 +1,298 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "World/TickProfiler.h"
+#include "World/World.h"
+#include "Chat/Chat.h"
+#include "Config/Config.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(TickProfiler);
+
+static char const* const profileCategoryNames[MAX_PROFILE_CATEGORY] = { "subsystem", "map", "opcode", "script" };
+
+void ProfileStats::Add(uint32 duration)
+{
+    ++Count;
+    TotalTime += duration;
+    if (duration > MaxTime)
+        MaxTime = duration;
+
+    uint32 bucket = 0;
+    while (bucket < PROFILE_HISTOGRAM_BUCKETS - 1 && duration >= (2u << bucket))
+        ++bucket;
+    ++Histogram[bucket];
+}
+
+uint32 ProfileStats::GetPercentile(uint32 percent) const
+{
+    uint32 needed = uint32(uint64(Count) * percent / 100);
+    uint32 counted = 0;
+    for (uint32 i = 0; i < PROFILE_HISTOGRAM_BUCKETS - 1; ++i)
+    {
+        counted += Histogram[i];
+        if (counted > needed)
+            return 2u << i;
+    }
+    return MaxTime;
+}
+
+TickProfiler::TickProfiler() : m_enabled(false), m_windowLength(0), m_dumpInterval(0), m_maxTraceEvents(0),
+    m_startTime(std::chrono::steady_clock::now()), m_traceNext(0), m_overwrittenTraceEvents(0), m_dumpTimer(0), m_dumpWriting(false)
+{
+}
+
+TickProfiler::~TickProfiler()
+{
+    if (m_dumpThread.joinable())
+        m_dumpThread.join();
+}
+
+void TickProfiler::LoadConfig()
+{
+#ifdef BUILD_PROFILER
+    m_enabled = sWorld.getConfig(CONFIG_BOOL_PROFILER_ENABLE);
+#else
+    if (sWorld.getConfig(CONFIG_BOOL_PROFILER_ENABLE))
+        sLog.outError("Profiler.Enable is set but server is built without BUILD_PROFILER, profiler disabled.");
+#endif
+
+    m_windowLength = sWorld.getConfig(CONFIG_UINT32_PROFILER_WINDOW) * IN_MILLISECONDS;
+    m_dumpInterval = sWorld.getConfig(CONFIG_UINT32_PROFILER_DUMP_INTERVAL) * IN_MILLISECONDS;
+    m_maxTraceEvents = sWorld.getConfig(CONFIG_UINT32_PROFILER_TRACE_EVENTS);
+    m_dumpDir = sConfig.GetStringDefault("Profiler.DumpDir");
+    if (m_dumpDir.empty())
+        m_dumpDir = sConfig.GetStringDefault("LogsDir");
+    if (!m_dumpDir.empty() && m_dumpDir.back() != '/' && m_dumpDir.back() != '\\')
+        m_dumpDir.push_back('/');
+
+    // trace buffer is allocated only for enabled profiler, events kept so far are dropped at size change
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (!m_enabled || m_traceEvents.capacity() != m_maxTraceEvents)
+    {
+        std::vector<TraceEvent>().swap(m_traceEvents);
+        m_traceNext = 0;
+        if (m_enabled)
+            m_traceEvents.reserve(m_maxTraceEvents);
+    }
+}
+
+void TickProfiler::BeginTick()
+{
+    if (m_enabled)
+        m_tickStart = std::chrono::steady_clock::now();
+}
+
+void TickProfiler::EndTick(uint32 diff)
+{
+    if (!m_enabled)
+        return;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        m_current.Tick.Add(uint32(std::chrono::duration_cast<std::chrono::microseconds>(now - m_tickStart).count()));
+        m_current.Length += diff;
+        if (m_current.Length >= m_windowLength)
+        {
+            std::swap(m_last, m_current);
+            m_current = Window();
+        }
+    }
+
+    if (m_dumpInterval)
+    {
+        m_dumpTimer += diff;
+        if (m_dumpTimer >= m_dumpInterval)
+        {
+            m_dumpTimer = 0;
+            Dump();
+        }
+    }
+}
+
+void TickProfiler::AddZone(ProfileCategory category, uint64 id, char const* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    uint32 duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    ProfileStats& stats = m_current.Stats[category][id];
+    stats.Name = name;
+    stats.Add(duration);
+
+    if (!m_maxTraceEvents)
+        return;
+
+    TraceEvent event;
+    event.Name = name;
+    event.Id = id;
+    event.Start = GetTimestamp(start);
+    event.Duration = duration;
+    event.Category = category;
+    event.Thread = GetThreadIndex();
+
+    if (m_traceEvents.size() < m_maxTraceEvents)
+        m_traceEvents.push_back(event);
+    else
+    {
+        // keep most recent zones
+        m_traceEvents[m_traceNext] = event;
+        m_traceNext = (m_traceNext + 1) % m_maxTraceEvents;
+        ++m_overwrittenTraceEvents;
+    }
+}
+
+void TickProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    m_current = Window();
+    m_last = Window();
+    m_traceEvents.clear();
+    m_traceNext = 0;
+    m_overwrittenTraceEvents = 0;
+}
+
+void TickProfiler::ShowStats(ChatHandler* handler, ProfileCategory category, uint32 count)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    // last complete window, current one before first is complete
+    Window const& window = m_last.Tick.Count ? m_last : m_current;
+    if (!window.Tick.Count)
+    {
+        handler->SendSysMessage("No ticks profiled yet.");
+        return;
+    }
+
+    handler->PSendSysMessage("Ticks: %u, avg %.2f ms, p50 <= %.2f ms, p99 <= %.2f ms, max %.2f ms", window.Tick.Count,
+                             window.Tick.TotalTime / 1000.0 / window.Tick.Count, window.Tick.GetPercentile(50) / 1000.0,
+                             window.Tick.GetPercentile(99) / 1000.0, window.Tick.MaxTime / 1000.0);
+
+    std::vector<std::pair<uint64, ProfileStats const*> > sorted;
+    sorted.reserve(window.Stats[category].size());
+    for (ProfileStatsMap::const_iterator itr = window.Stats[category].begin(); itr != window.Stats[category].end(); ++itr)
+        sorted.push_back(std::make_pair(itr->first, &itr->second));
+
+    count = std::min(count, uint32(sorted.size()));
+    std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(),
+                      [](std::pair<uint64, ProfileStats const*> const& a, std::pair<uint64, ProfileStats const*> const& b) { return a.second->TotalTime > b.second->TotalTime; });
+
+    handler->PSendSysMessage("Top %u of %u by total time per %s:", count, uint32(sorted.size()), profileCategoryNames[category]);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ProfileStats const& stats = *sorted[i].second;
+        uint64 id = sorted[i].first;
+        char const* name = stats.Name ? stats.Name : "";
+
+        std::string label;
+        char buf[64];
+        if (category == PROFILE_MAP)
+            snprintf(buf, sizeof(buf), " (map %u, instance %u)", uint32(id >> 32), uint32(id));
+        else
+            snprintf(buf, sizeof(buf), " (%u)", uint32(id));
+        label = std::string(name) + buf;
+
+        handler->PSendSysMessage("%s: %u calls, %.2f ms/tick, avg %u us, p99 <= %u us, max %u us", label.c_str(), stats.Count,
+                                 stats.TotalTime / 1000.0 / window.Tick.Count, uint32(stats.TotalTime / stats.Count), stats.GetPercentile(99), stats.MaxTime);
+    }
+}
+
+bool TickProfiler::Dump()
+{
+    // world thread never waits for file write, events keep collecting until next dump
+    if (m_dumpWriting)
+        return false;
+
+    // writer thread already finished
+    if (m_dumpThread.joinable())
+        m_dumpThread.join();
+
+    // new buffer is only reserved, pages are touched while zones are added
+    std::vector<TraceEvent> events;
+    events.reserve(m_maxTraceEvents);
+    uint32 first;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_traceEvents.empty())
+            return false;
+
+        events.swap(m_traceEvents);
+        first = m_traceNext;
+        m_traceNext = 0;
+
+        if (m_overwrittenTraceEvents)
+        {
+            sLog.outDetail("Profiler: trace buffer full, %u oldest zones not written to trace", m_overwrittenTraceEvents);
+            m_overwrittenTraceEvents = 0;
+        }
+    }
+
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "profile_" UI64FMTD ".json", uint64(time(nullptr)));
+
+    m_dumpWriting = true;
+    m_dumpThread = std::thread(&TickProfiler::WriteTrace, this, m_dumpDir + fileName, std::move(events), first);
+    return true;
+}
+
+void TickProfiler::WriteTrace(std::string const& fileName, std::vector<TraceEvent> events, uint32 first)
+{
+    // oldest event of full ring buffer first
+    std::rotate(events.begin(), events.begin() + first, events.end());
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("Profiler: can't open %s for trace dump", fileName.c_str());
+        m_dumpWriting = false;
+        return;
+    }
+
+    fputs("{\"traceEvents\":[\n", file);
+    for (std::vector<TraceEvent>::const_iterator itr = events.begin(); itr != events.end(); ++itr)
+    {
+        // opcode, map and script names live until shutdown and have no characters needing escape
+        fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":" UI64FMTD ",\"dur\":%u,\"pid\":1,\"tid\":%u,\"args\":{\"id\":" UI64FMTD "}}",
+                itr == events.begin() ? "" : ",\n", itr->Name ? itr->Name : "", profileCategoryNames[itr->Category], itr->Start, itr->Duration, uint32(itr->Thread), itr->Id);
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+
+    sLog.outDetail("Profiler: %u zones written to %s", uint32(events.size()), fileName.c_str());
+    m_dumpWriting = false;
+}
+
+uint8 TickProfiler::GetThreadIndex()
+{
+    static std::atomic<uint8> threadCount(0);
+    thread_local uint8 index = threadCount++;
+    return index;
+}
+
+uint64 TickProfiler::GetTimestamp(std::chrono::steady_clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - m_startTime).count();
+}
@@ -0,0 +1,186 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef MANGOS_TICK_PROFILER_H
+#define MANGOS_TICK_PROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ChatHandler;
+
+enum ProfileCategory
+{
+    PROFILE_SUBSYSTEM   = 0,                                // id is ProfileSubsystem
+    PROFILE_MAP         = 1,                                // id is map id << 32 | instance id
+    PROFILE_OPCODE      = 2,                                // id is opcode
+    PROFILE_SCRIPT      = 3,                                // id is script id
+    MAX_PROFILE_CATEGORY
+};
+
+enum ProfileSubsystem
+{
+    PROFILE_SUBSYSTEM_MAILS,
+    PROFILE_SUBSYSTEM_AUCTIONS,
+    PROFILE_SUBSYSTEM_AUCTIONBOT,
+    PROFILE_SUBSYSTEM_SESSIONS,
+    PROFILE_SUBSYSTEM_MAPS,
+    PROFILE_SUBSYSTEM_BATTLEGROUNDS,
+    PROFILE_SUBSYSTEM_OUTDOORPVP,
+    PROFILE_SUBSYSTEM_WORLDSTATE,
+    PROFILE_SUBSYSTEM_GROUPS,
+    PROFILE_SUBSYSTEM_RESULT_QUEUE,
+    PROFILE_SUBSYSTEM_GAME_EVENTS,
+    PROFILE_SUBSYSTEM_REMOVE_LIST,
+    PROFILE_SUBSYSTEM_INSTANCE_RESETS,
+    PROFILE_SUBSYSTEM_CLI_COMMANDS,
+    PROFILE_SUBSYSTEM_TERRAIN,
+};
+
+// bucket i counts zones shorter than 2^(i+1) microseconds, last one all longer
+#define PROFILE_HISTOGRAM_BUCKETS 18
+
+struct ProfileStats
+{
+    ProfileStats() : Name(nullptr), Count(0), TotalTime(0), MaxTime(0), Histogram() {}
+
+    void Add(uint32 duration);
+    uint32 GetPercentile(uint32 percent) const;             // upper bound of bucket, microseconds
+
+    char const* Name;
+    uint32 Count;
+    uint64 TotalTime;                                       // microseconds
+    uint32 MaxTime;
+    uint32 Histogram[PROFILE_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * Scoped timing of world tick parts.
+ *
+ * Zones aggregate time per subsystem, map instance, opcode handler and script into windows of
+ * Profiler.Window seconds, last complete window is shown by .server profile command. Last
+ * Profiler.TraceEvents zones are kept in ring buffer and written periodically or by command to file
+ * in Chrome trace format.
+ * Zone macros are compiled only with BUILD_PROFILER.
+ */
+class TickProfiler
+{
+    public:
+        typedef std::unordered_map<uint64, ProfileStats> ProfileStatsMap;
+
+        TickProfiler();
+        ~TickProfiler();
+
+        void LoadConfig();
+        bool IsEnabled() const { return m_enabled; }
+
+        void BeginTick();
+        void EndTick(uint32 diff);
+
+        void AddZone(ProfileCategory category, uint64 id, char const* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+        void Reset();
+        void ShowStats(ChatHandler* handler, ProfileCategory category, uint32 count);
+        // false if there is nothing to dump or previous file is still written
+        bool Dump();
+
+    private:
+        struct Window
+        {
+            Window() : Length(0) {}
+
+            ProfileStats Tick;
+            ProfileStatsMap Stats[MAX_PROFILE_CATEGORY];
+            uint32 Length;                                  // milliseconds
+        };
+
+        struct TraceEvent
+        {
+            char const* Name;
+            uint64 Id;
+            uint64 Start;                                   // microseconds since profiler start
+            uint32 Duration;
+            uint8 Category;
+            uint8 Thread;
+        };
+
+        static uint8 GetThreadIndex();
+        uint64 GetTimestamp(std::chrono::steady_clock::time_point time) const;
+        void WriteTrace(std::string const& fileName, std::vector<TraceEvent> events, uint32 first);
+
+        bool m_enabled;
+        uint32 m_windowLength;
+        uint32 m_dumpInterval;
+        uint32 m_maxTraceEvents;
+        std::string m_dumpDir;
+
+        std::chrono::steady_clock::time_point m_startTime;
+        std::chrono::steady_clock::time_point m_tickStart;
+
+        std::mutex m_lock;                                  // zones of other threads
+        Window m_current;
+        Window m_last;
+
+        std::vector<TraceEvent> m_traceEvents;              // ring buffer when full
+        uint32 m_traceNext;                                 // oldest event of full buffer, overwritten next
+        uint32 m_overwrittenTraceEvents;
+        uint32 m_dumpTimer;
+        std::thread m_dumpThread;
+        std::atomic<bool> m_dumpWriting;
+};
+
+#define sTickProfiler MaNGOS::Singleton<TickProfiler>::Instance()
+
+class ProfileZone
+{
+    public:
+        ProfileZone(ProfileCategory category, uint64 id, char const* name) : m_category(category), m_id(id), m_name(name), m_active(sTickProfiler.IsEnabled())
+        {
+            if (m_active)
+                m_start = std::chrono::steady_clock::now();
+        }
+
+        ~ProfileZone()
+        {
+            if (m_active)
+                sTickProfiler.AddZone(m_category, m_id, m_name, m_start, std::chrono::steady_clock::now());
+        }
+
+    private:
+        ProfileCategory m_category;
+        uint64 m_id;
+        char const* m_name;
+        bool m_active;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#ifdef BUILD_PROFILER
+#define PROFILE_ZONE(category, id, name) ProfileZone profileZone(category, id, name)
+#else
+#define PROFILE_ZONE(category, id, name)
+#endif
+
+#endif
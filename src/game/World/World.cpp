@@ -41,6 +41,7 @@
 #include "Chat/Chat.h"
 #include "Server/DBCStores.h"
 #include "Mails/MassMailMgr.h"
+#include "Mails/MailExpiryMgr.h"
 #include "Loot/LootMgr.h"
 #include "Entities/ItemEnchantmentMgr.h"
 #include "Maps/MapManager.h"
@@ -65,11 +66,18 @@
 #include "Entities/CreatureLinkingMgr.h"
 #include "Weather/Weather.h"
 #include "World/WorldState.h"
+#include "World/TickProfiler.h"
+#include "Server/OpcodeCost.h"
+
+#ifdef BUILD_PLAYERBOT
+#include "PlayerBot/Base/PlayerbotScheduler.h"
+#endif
 
 #include <algorithm>
 #include <mutex>
 #include <cstdarg>
 #include <memory>
+#include <chrono>
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -147,6 +155,7 @@ void World::CleanupsBeforeStop()
     UpdateSessions(1);                               // real players unload required UpdateSessions call
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
     sMapMgr.UnloadAll();                             // unload all grids (including locked in memory)
+    sMapPersistentStateMgr.SaveRespawnTimes();       // respawn times not stored yet by periodic save
 }
 
 /// Find a session by its id
@@ -576,6 +585,9 @@ void World::LoadConfigSettings(bool reload)
 
     setConfigMin(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK, "MassMailer.SendPerTick", 10, 1);
 
+    setConfigMin(CONFIG_UINT32_MAIL_EXPIRY_BATCH_SIZE, "MailExpiry.BatchSize", 1000, 1);
+    setConfigMin(CONFIG_UINT32_MAIL_EXPIRY_APPLY_PER_TICK, "MailExpiry.ApplyPerTick", 200, 1);
+
     setConfig(CONFIG_UINT32_UPTIME_UPDATE, "UpdateUptimeInterval", 10);
     if (reload)
     {
@@ -610,6 +622,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY, "SaveRespawnTimeImmediately", true);
+    setConfig(CONFIG_UINT32_RESPAWN_SAVE_INTERVAL, "SaveRespawnTimeInterval", 10 * IN_MILLISECONDS);
     setConfig(CONFIG_BOOL_WEATHER, "ActivateWeather", true);
 
     setConfig(CONFIG_BOOL_ALWAYS_MAX_SKILL_FOR_LEVEL, "AlwaysMaxSkillForLevel", false);
@@ -700,12 +713,24 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_UINT32_SESSION_PACKET_BUDGET, "Network.SessionPacketBudget", 5000);
+    setConfig(CONFIG_UINT32_SESSION_MAX_DEFERRED_PACKETS, "Network.MaxDeferredPackets", 500);
+    if (configNoReload(reload, CONFIG_UINT32_SESSION_UPDATE_THREADS, "Network.SessionUpdateThreads", 0))
+        setConfig(CONFIG_UINT32_SESSION_UPDATE_THREADS, "Network.SessionUpdateThreads", 0);
+    setConfig(CONFIG_UINT32_THROTTLE_WHO_RATE, "Network.Throttle.Who.Rate", 30);
+    setConfigMin(CONFIG_UINT32_THROTTLE_WHO_BURST, "Network.Throttle.Who.Burst", 5, 1);
+    setConfig(CONFIG_UINT32_THROTTLE_AUCTION_RATE, "Network.Throttle.Auction.Rate", 120);
+    setConfigMin(CONFIG_UINT32_THROTTLE_AUCTION_BURST, "Network.Throttle.Auction.Burst", 10, 1);
+    setConfig(CONFIG_UINT32_THROTTLE_QUERY_RATE, "Network.Throttle.Query.Rate", 3000);
+    setConfigMin(CONFIG_UINT32_THROTTLE_QUERY_BURST, "Network.Throttle.Query.Burst", 300, 1);
+    sOpcodeCostMgr.LoadConfig();
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
     setConfig(CONFIG_UINT32_INSTANT_LOGOUT, "InstantLogout", SEC_MODERATOR);
 
     setConfigMin(CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY, "Group.OfflineLeaderDelay", 300, 0);
+    setConfig(CONFIG_UINT32_GROUP_OUT_OF_RANGE_UPDATE_INTERVAL, "Group.OutOfRangeUpdateInterval", IN_MILLISECONDS);
 
     setConfigMin(CONFIG_UINT32_GUILD_EVENT_LOG_COUNT, "Guild.EventLogRecordsCount", GUILD_EVENTLOG_MAX_RECORDS, GUILD_EVENTLOG_MAX_RECORDS);
     setConfigMin(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT, "Guild.BankEventLogRecordsCount", GUILD_BANK_MAX_LOGS, GUILD_BANK_MAX_LOGS);
@@ -719,6 +744,22 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,      "PetUnsummonAtMount", false);
 
+    setConfig(CONFIG_BOOL_MOVEMENT_AGGREGATION,                    "Movement.Aggregation", true);
+    setConfig(CONFIG_BOOL_MOVEMENT_COALESCE,                       "Movement.Aggregation.Coalesce", true);
+    setConfigMinMax(CONFIG_FLOAT_MOVEMENT_FAR_OBSERVER_DISTANCE,   "Movement.FarObserverDistance", 0.6f, 0.0f, 1.0f);
+    setConfig(CONFIG_UINT32_MOVEMENT_FAR_HEARTBEAT_INTERVAL,       "Movement.FarHeartbeatInterval", 1000);
+
+    setConfig(CONFIG_BOOL_CREATURE_LOD,                            "CreatureLOD.Enable", true);
+    setConfigMin(CONFIG_FLOAT_CREATURE_LOD_NEAR_DISTANCE,          "CreatureLOD.NearDistance", 50.0f, 0.0f);
+    setConfig(CONFIG_UINT32_CREATURE_LOD_FAR_INTERVAL,             "CreatureLOD.FarInterval", 400);
+    setConfig(CONFIG_UINT32_CREATURE_LOD_UNOBSERVED_INTERVAL,      "CreatureLOD.UnobservedInterval", 2000);
+
+    setConfig(CONFIG_BOOL_PROFILER_ENABLE,                         "Profiler.Enable", false);
+    setConfigMin(CONFIG_UINT32_PROFILER_WINDOW,                    "Profiler.Window", 60, 1);
+    setConfig(CONFIG_UINT32_PROFILER_DUMP_INTERVAL,                "Profiler.DumpInterval", 0);
+    setConfig(CONFIG_UINT32_PROFILER_TRACE_EVENTS,                 "Profiler.TraceEvents", 200000);
+    sTickProfiler.LoadConfig();
+
     m_relocation_ai_notify_delay = sConfig.GetIntDefault("Visibility.AIRelocationNotifyDelay", 1000u);
     m_relocation_lower_limit_sq  = pow(sConfig.GetFloatDefault("Visibility.RelocationLowerLimit", 10), 2);
 
@@ -813,6 +854,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfigMin(CONFIG_FLOAT_COLLISION_CACHE_PRECISION, "vmap.CachePrecision", 0.25f, 0.0f);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds");
@@ -1091,6 +1133,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading spell pet auras...");
     sSpellMgr.LoadSpellPetAuras();
 
+    sLog.outString("Compiling spell side tables...");
+    sSpellMgr.BuildSpellCompiledInfo();                     // must be after all sSpellMgr.LoadSpell* calls
+
     sLog.outString("Loading Player Create Info & Level Stats...");
     sObjectMgr.LoadPlayerInfo();
     sLog.outString(">>> Player Create Info & Level Stats loaded");
@@ -1223,7 +1268,7 @@ void World::SetInitialWorldSettings()
     sObjectMgr.LoadGroups();
 
     sLog.outString("Returning old mails...");
-    sObjectMgr.ReturnOrDeleteOldMails(false);
+    sMailExpiryMgr.ReturnOrDeleteOldMails(false);
 
     sLog.outString("Loading GM tickets...");
     sTicketMgr.LoadGMTickets();
@@ -1288,6 +1333,8 @@ void World::SetInitialWorldSettings()
     sMapMgr.Initialize();
     sLog.outString();
 
+    m_sessionUpdatePool.Start(getConfig(CONFIG_UINT32_SESSION_UPDATE_THREADS));
+
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
@@ -1406,6 +1453,8 @@ void World::Update(uint32 diff)
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
 
+    sTickProfiler.BeginTick();
+
     ///- Update the different timers
     for (int i = 0; i < WUPDATE_COUNT; ++i)
     {
@@ -1418,8 +1467,15 @@ void World::Update(uint32 diff)
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
 
-    ///-Update mass mailer tasks if any
-    sMassMailMgr.Update();
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_MAILS, "Mails");
+
+        ///-Update mass mailer tasks if any
+        sMassMailMgr.Update();
+
+        ///- Apply loaded expired mails if any
+        sMailExpiryMgr.Update();
+    }
 
     /// Handle daily quests reset time
     if (m_gameTime > m_NextDailyQuestReset)
@@ -1436,6 +1492,7 @@ void World::Update(uint32 diff)
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_AUCTIONS, "Auctions");
         m_timers[WUPDATE_AUCTIONS].Reset();
 
         ///- Update mails (return old mails with item, or delete them)
@@ -1443,7 +1500,7 @@ void World::Update(uint32 diff)
         if (++mail_timer > mail_timer_expires)
         {
             mail_timer = 0;
-            sObjectMgr.ReturnOrDeleteOldMails(true);
+            sMailExpiryMgr.ReturnOrDeleteOldMails(true);
         }
 
         ///- Handle expired auctions
@@ -1451,14 +1508,21 @@ void World::Update(uint32 diff)
     }
 
     /// <li> Handle AHBot operations
-    if (m_timers[WUPDATE_AHBOT].Passed())
     {
-        sAuctionBot.Update();
-        m_timers[WUPDATE_AHBOT].Reset();
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_AUCTIONBOT, "AuctionHouseBot");
+        if (m_timers[WUPDATE_AHBOT].Passed())
+        {
+            sAuctionBot.Update();
+            m_timers[WUPDATE_AHBOT].Reset();
+        }
+        sAuctionBot.ApplyPlannedActions();
     }
 
     /// <li> Handle session updates
-    UpdateSessions(diff);
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_SESSIONS, "Sessions");
+        UpdateSessions(diff);
+    }
 
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
@@ -1472,20 +1536,37 @@ void World::Update(uint32 diff)
 
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
-    sMapMgr.Update(diff);
-    sBattleGroundMgr.Update(diff);
-    sOutdoorPvPMgr.Update(diff);
-    sWorldState.Update(diff);
+#ifdef BUILD_PLAYERBOT
+    sPlayerbotScheduler.BeginTick(diff);
+#endif
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_MAPS, "Maps");
+        sMapMgr.Update(diff);
+    }
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_BATTLEGROUNDS, "BattleGrounds");
+        sBattleGroundMgr.Update(diff);
+    }
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_OUTDOORPVP, "OutdoorPvP");
+        sOutdoorPvPMgr.Update(diff);
+    }
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_WORLDSTATE, "WorldState");
+        sWorldState.Update(diff);
+    }
 
     ///- Update groups with offline leaders
     if (m_timers[WUPDATE_GROUPS].Passed())
     {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_GROUPS, "Groups");
         m_timers[WUPDATE_GROUPS].Reset();
         if (const uint32 delay = getConfig(CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY))
         {
             for (ObjectMgr::GroupMap::const_iterator i = sObjectMgr.GetGroupMapBegin(); i != sObjectMgr.GetGroupMapEnd(); ++i)
                 i->second->UpdateOfflineLeader(m_gameTime, delay);
         }
+        Group::UpdateMemberStatsCounters(m_timers[WUPDATE_GROUPS].GetInterval());
     }
 
     ///- Delete all characters which have been deleted X days before
@@ -1496,7 +1577,10 @@ void World::Update(uint32 diff)
     }
 
     // execute callbacks from sql queries that were queued recently
-    UpdateResultQueue();
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_RESULT_QUEUE, "ResultQueue");
+        UpdateResultQueue();
+    }
 
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
@@ -1509,6 +1593,7 @@ void World::Update(uint32 diff)
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_GAME_EVENTS, "GameEvents");
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
         uint32 nextGameEvent = sGameEventMgr.Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
@@ -1517,16 +1602,30 @@ void World::Update(uint32 diff)
 
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
-    sMapMgr.RemoveAllObjectsInRemoveList();
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_REMOVE_LIST, "RemoveList");
+        sMapMgr.RemoveAllObjectsInRemoveList();
+    }
 
     // update the instance reset times
-    sMapPersistentStateMgr.Update();
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_INSTANCE_RESETS, "InstanceResets");
+        sMapPersistentStateMgr.Update(diff);
+    }
 
     // And last, but not least handle the issued cli commands
-    ProcessCliCommands();
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_CLI_COMMANDS, "CliCommands");
+        ProcessCliCommands();
+    }
 
     // cleanup unused GridMap objects as well as VMaps
-    sTerrainMgr.Update(diff);
+    {
+        PROFILE_ZONE(PROFILE_SUBSYSTEM, PROFILE_SUBSYSTEM_TERRAIN, "Terrain");
+        sTerrainMgr.Update(diff);
+    }
+
+    sTickProfiler.EndTick(diff);
 }
 
 namespace MaNGOS
@@ -1887,7 +1986,7 @@ void World::ShutdownCancel()
     DEBUG_LOG("Server %s cancelled.", (m_ShutdownMask & SHUTDOWN_MASK_RESTART ? "restart" : "shutdown"));
 }
 
-void World::UpdateSessions(uint32 /*diff*/)
+void World::UpdateSessions(uint32 diff)
 {
     ///- Add new sessions
     {
@@ -1899,15 +1998,40 @@ void World::UpdateSessions(uint32 /*diff*/)
         m_sessionAddQueue.clear();
     }
 
+    ///- Sessions without player in world are updated by workers first
+    if (m_sessionUpdatePool.IsEnabled())
+    {
+        m_workerSessions.clear();
+        for (auto const& itr : m_sessions)
+            if (IsWorkerSessionUpdateCategory(itr.second->GetUpdateCategory()))
+                m_workerSessions.push_back(itr.second);
+
+        m_sessionUpdatePool.Update(m_workerSessions);
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end();)
     {
         ///- and remove not active sessions from the list
         WorldSession* pSession = itr->second;
+
+        // worker left no deferred packets or logout for world thread
+        if (!pSession->IsWorldUpdateNeeded())
+        {
+            pSession->SetWorldUpdateNeeded();
+            ++itr;
+            continue;
+        }
+
+        SessionUpdateCategory category = pSession->GetUpdateCategory();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
         WorldSessionFilter updater(pSession);
+        bool updated = pSession->Update(updater);
+        m_sessionUpdatePool.AddWorldTime(category, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
 
         // if WorldSession::Update fails, it means that the session should be destroyed
-        if (!pSession->Update(updater))
+        if (!updated)
         {
             RemoveQueuedSession(pSession);
             itr = m_sessions.erase(itr);
@@ -1916,6 +2040,9 @@ void World::UpdateSessions(uint32 /*diff*/)
         else
             ++itr;
     }
+
+    sOpcodeCostMgr.Update(diff);
+    m_sessionUpdatePool.UpdateStats(diff);
 }
 
 // This handles the issued and queued CLI/RA commands
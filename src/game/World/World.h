@@ -27,6 +27,7 @@
 #include "Timer.h"
 #include "Globals/SharedDefines.h"
 #include "Entities/Object.h"
+#include "Server/SessionUpdater.h"
 
 #include <set>
 #include <list>
@@ -128,6 +129,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GROUP_VISIBILITY,
     CONFIG_UINT32_MAIL_DELIVERY_DELAY,
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
+    CONFIG_UINT32_MAIL_EXPIRY_BATCH_SIZE,
+    CONFIG_UINT32_MAIL_EXPIRY_APPLY_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
@@ -141,6 +144,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_SKILL_GAIN_GATHERING,
     CONFIG_UINT32_SKILL_GAIN_WEAPON,
     CONFIG_UINT32_MAX_OVERSPEED_PINGS,
+    CONFIG_UINT32_RESPAWN_SAVE_INTERVAL,
     CONFIG_UINT32_EXPANSION,
     CONFIG_UINT32_CHATFLOOD_MESSAGE_COUNT,
     CONFIG_UINT32_CHATFLOOD_MESSAGE_DELAY,
@@ -169,6 +173,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_ARENA_SEASON_ID,
     CONFIG_UINT32_ARENA_FIRST_RESET_DAY,
     CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY,
+    CONFIG_UINT32_GROUP_OUT_OF_RANGE_UPDATE_INTERVAL,
     CONFIG_UINT32_GUILD_EVENT_LOG_COUNT,
     CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT,
     CONFIG_UINT32_TIMERBAR_FATIGUE_GMLEVEL,
@@ -185,6 +190,21 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY,
     CONFIG_UINT32_MAX_WHOLIST_RETURNS,
+    CONFIG_UINT32_MOVEMENT_FAR_HEARTBEAT_INTERVAL,
+    CONFIG_UINT32_CREATURE_LOD_FAR_INTERVAL,
+    CONFIG_UINT32_CREATURE_LOD_UNOBSERVED_INTERVAL,
+    CONFIG_UINT32_PROFILER_WINDOW,
+    CONFIG_UINT32_PROFILER_DUMP_INTERVAL,
+    CONFIG_UINT32_PROFILER_TRACE_EVENTS,
+    CONFIG_UINT32_SESSION_PACKET_BUDGET,
+    CONFIG_UINT32_SESSION_MAX_DEFERRED_PACKETS,
+    CONFIG_UINT32_SESSION_UPDATE_THREADS,
+    CONFIG_UINT32_THROTTLE_WHO_RATE,
+    CONFIG_UINT32_THROTTLE_WHO_BURST,
+    CONFIG_UINT32_THROTTLE_AUCTION_RATE,
+    CONFIG_UINT32_THROTTLE_AUCTION_BURST,
+    CONFIG_UINT32_THROTTLE_QUERY_RATE,
+    CONFIG_UINT32_THROTTLE_QUERY_BURST,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -272,6 +292,9 @@ enum eConfigFloatValues
     CONFIG_FLOAT_THREAT_RADIUS,
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
+    CONFIG_FLOAT_MOVEMENT_FAR_OBSERVER_DISTANCE,
+    CONFIG_FLOAT_CREATURE_LOD_NEAR_DISTANCE,
+    CONFIG_FLOAT_COLLISION_CACHE_PRECISION,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -340,6 +363,10 @@ enum eConfigBoolValues
     CONFIG_BOOL_PLAYER_COMMANDS,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_MOVEMENT_AGGREGATION,
+    CONFIG_BOOL_MOVEMENT_COALESCE,
+    CONFIG_BOOL_CREATURE_LOD,
+    CONFIG_BOOL_PROFILER_ENABLE,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -645,6 +672,8 @@ class World
 
         typedef std::unordered_map<uint32, WorldSession*> SessionMap;
         SessionMap m_sessions;
+        SessionUpdatePool m_sessionUpdatePool;
+        std::vector<WorldSession*> m_workerSessions;        // sessions of current UpdateSessions() pass updated by m_sessionUpdatePool
         uint32 m_maxActiveSessionCount;
         uint32 m_maxQueuedSessionCount;
 
@@ -17,6 +17,7 @@
  */
 
 #include "BIH.h"
+#include "VMapDefinitions.h"
 #include <stdexcept>
 #include <cmath>
 
@@ -283,6 +284,22 @@ bool BIH::readFromFile(FILE* rf)
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
+bool BIH::readFromMemory(VMAP::MemoryReader& reader)
+{
+    uint32 treeSize, count;
+    Vector3 lo, hi;
+    if (!reader.read(&lo, sizeof(Vector3)) || !reader.read(&hi, sizeof(Vector3)))
+        return false;
+    bounds = AABox(lo, hi);
+    if (!reader.read(&treeSize, sizeof(uint32)))
+        return false;
+    tree.resize(treeSize);
+    if ((treeSize && !reader.read(&tree[0], sizeof(uint32) * treeSize)) || !reader.read(&count, sizeof(uint32)))
+        return false;
+    objects.resize(count);
+    return !count || reader.read(&objects[0], sizeof(uint32) * count);
+}
+
 void BIH::BuildStats::updateLeaf(int depth, int n)
 {
     ++numLeaves;
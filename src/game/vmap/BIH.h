@@ -28,12 +28,23 @@
 #include <vector>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define BIH_PACKET_SSE
+#endif
+
 #define MAX_STACK_SIZE 64
+#define BIH_PACKET_SIZE 4                                   // rays traversed together, one per SSE lane
 
 using G3D::Vector3;
 using G3D::AABox;
 using G3D::Ray;
 
+namespace VMAP
+{
+    class MemoryReader;
+}
+
 static inline uint32 floatToRawIntBits(float f)
 {
     union
@@ -344,8 +355,169 @@ class BIH
             }
         }
 
+        /**
+            Traverses tree with up to BIH_PACKET_SIZE rays at once, nodes are visited while any ray of packet
+            passes them and children are clipped for all rays together. Callback is called per ray like for
+            intersectRay and has to return if that single call hit, maxDist is per ray too.
+            Returns mask of rays for which callback reported hit.
+        */
+        template<typename RayCallback>
+        uint32 intersectRayPacket(const Ray* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool stopAtFirst = false, bool checkLOS = false) const
+        {
+            RayPacket packet;
+            uint32 mask = 0;
+            for (uint32 i = 0; i < BIH_PACKET_SIZE; ++i)
+            {
+                packet.tnear[i] = 0.f;
+                packet.tfar[i] = -1.f;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    packet.org[axis][i] = 0.f;
+                    packet.invDir[axis][i] = 1.f;
+                }
+                if (i >= count)
+                    continue;
+
+                const Vector3& org = rays[i].origin();
+                const Vector3& dir = rays[i].direction();
+                float intervalMin = -1.f;
+                float intervalMax = -1.f;
+                bool outside = false;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    packet.org[axis][i] = org[axis];
+                    packet.invDir[axis][i] = 1.f / dir[axis];
+                    if (G3D::fuzzyNe(dir[axis], 0.0f))
+                    {
+                        float t1 = (bounds.low()[axis]  - org[axis]) * packet.invDir[axis][i];
+                        float t2 = (bounds.high()[axis] - org[axis]) * packet.invDir[axis][i];
+                        if (t1 > t2)
+                            std::swap(t1, t2);
+                        if (t1 > intervalMin)
+                            intervalMin = t1;
+                        if (t2 < intervalMax || intervalMax < 0.f)
+                            intervalMax = t2;
+                        if (intervalMax <= 0 || intervalMin >= maxDist[i])
+                        {
+                            outside = true;
+                            break;
+                        }
+                    }
+                }
+                if (outside || intervalMin > intervalMax)
+                    continue;
+
+                packet.tnear[i] = std::max(intervalMin, 0.f);
+                packet.tfar[i] = std::min(intervalMax, maxDist[i]);
+                mask |= 1 << i;
+            }
+
+            uint32 hitMask = 0;
+            uint32 doneMask = 0;                            // rays stopped at first hit
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (mask)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = !!(tn & (1 << 29));
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, left child ends at first clip plane and right one starts at second
+                            PacketStackNode left, right;
+                            packet.clipChildren(axis, intBitsToFloat(tree[node + 1]), intBitsToFloat(tree[node + 2]), mask, left, right);
+                            left.node = offset;
+                            right.node = offset + 3;
+
+                            // visit near child first, as seen by first active ray
+                            uint32 first = 0;
+                            while (!(mask & (1 << first)))
+                                ++first;
+                            bool leftNear = packet.invDir[axis][first] >= 0.f;
+                            PacketStackNode& nearChild = leftNear ? left : right;
+                            PacketStackNode& farChild = leftNear ? right : left;
+
+                            if (farChild.mask)
+                            {
+                                if (!nearChild.mask)
+                                {
+                                    packet.load(farChild);
+                                    node = farChild.node;
+                                    mask = farChild.mask;
+                                    continue;
+                                }
+                                stack[stackPos++] = farChild;
+                            }
+                            packet.load(nearChild);
+                            node = nearChild.node;
+                            mask = nearChild.mask;
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0 && mask)
+                            {
+                                for (uint32 i = 0; i < BIH_PACKET_SIZE; ++i)
+                                {
+                                    if (!(mask & (1 << i)))
+                                        continue;
+                                    if (intersectCallback(rays[i], objects[offset], maxDist[i], stopAtFirst, checkLOS))
+                                    {
+                                        hitMask |= 1 << i;
+                                        if (stopAtFirst)
+                                        {
+                                            doneMask |= 1 << i;
+                                            mask &= ~(1 << i);
+                                        }
+                                    }
+                                }
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                            return hitMask; // should not happen
+                        mask = packet.clipNode(axis, intBitsToFloat(tree[node + 1]), intBitsToFloat(tree[node + 2]), mask);
+                        node = offset;
+                        continue;
+                    }
+                } // traversal loop
+
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return hitMask;
+                    // move back up the stack, dropping finished rays and rays already hit closer than node
+                    --stackPos;
+                    mask = stack[stackPos].mask & ~doneMask;
+                    for (uint32 i = 0; i < BIH_PACKET_SIZE; ++i)
+                        if ((mask & (1 << i)) && maxDist[i] < stack[stackPos].tnear[i])
+                            mask &= ~(1 << i);
+                }
+                while (!mask);
+
+                packet.load(stack[stackPos]);
+                node = stack[stackPos].node;
+            }
+        }
+
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
+        bool readFromMemory(VMAP::MemoryReader& reader);
 
     protected:
         std::vector<uint32> tree;
@@ -366,6 +538,110 @@ class BIH
             float tfar;
         };
 
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 mask;
+            float tnear[BIH_PACKET_SIZE];
+            float tfar[BIH_PACKET_SIZE];
+        };
+
+        // rays of packet in lane layout, NaN from 0 * inf keeps old interval bound like in single ray traversal
+        struct RayPacket
+        {
+            float org[3][BIH_PACKET_SIZE];
+            float invDir[3][BIH_PACKET_SIZE];
+            float tnear[BIH_PACKET_SIZE];
+            float tfar[BIH_PACKET_SIZE];
+
+            void load(const PacketStackNode& entry)
+            {
+                std::copy(entry.tnear, entry.tnear + BIH_PACKET_SIZE, tnear);
+                std::copy(entry.tfar, entry.tfar + BIH_PACKET_SIZE, tfar);
+            }
+
+            // interior node, left child is below leftClip and right child above rightClip on axis
+            void clipChildren(uint32 axis, float leftClip, float rightClip, uint32 mask, PacketStackNode& left, PacketStackNode& right) const
+            {
+#ifdef BIH_PACKET_SSE
+                __m128 o = _mm_loadu_ps(org[axis]);
+                __m128 inv = _mm_loadu_ps(invDir[axis]);
+                __m128 tMin = _mm_loadu_ps(tnear);
+                __m128 tMax = _mm_loadu_ps(tfar);
+                __m128 tl = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(leftClip), o), inv);
+                __m128 tr = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(rightClip), o), inv);
+                __m128 neg = _mm_cmplt_ps(inv, _mm_setzero_ps());
+
+                __m128 leftMin = Select(neg, _mm_max_ps(tl, tMin), tMin);
+                __m128 leftMax = Select(neg, tMax, _mm_min_ps(tl, tMax));
+                __m128 rightMin = Select(neg, tMin, _mm_max_ps(tr, tMin));
+                __m128 rightMax = Select(neg, _mm_min_ps(tr, tMax), tMax);
+
+                _mm_storeu_ps(left.tnear, leftMin);
+                _mm_storeu_ps(left.tfar, leftMax);
+                _mm_storeu_ps(right.tnear, rightMin);
+                _mm_storeu_ps(right.tfar, rightMax);
+                left.mask = mask & _mm_movemask_ps(_mm_cmple_ps(leftMin, leftMax));
+                right.mask = mask & _mm_movemask_ps(_mm_cmple_ps(rightMin, rightMax));
+#else
+                left.mask = right.mask = 0;
+                for (uint32 i = 0; i < BIH_PACKET_SIZE; ++i)
+                {
+                    float tl = (leftClip - org[axis][i]) * invDir[axis][i];
+                    float tr = (rightClip - org[axis][i]) * invDir[axis][i];
+                    bool neg = invDir[axis][i] < 0.f;
+                    left.tnear[i] = neg ? Max(tl, tnear[i]) : tnear[i];
+                    left.tfar[i] = neg ? tfar[i] : Min(tl, tfar[i]);
+                    right.tnear[i] = neg ? tnear[i] : Max(tr, tnear[i]);
+                    right.tfar[i] = neg ? Min(tr, tfar[i]) : tfar[i];
+                    if (left.tnear[i] <= left.tfar[i])
+                        left.mask |= 1 << i;
+                    if (right.tnear[i] <= right.tfar[i])
+                        right.mask |= 1 << i;
+                }
+                left.mask &= mask;
+                right.mask &= mask;
+#endif
+            }
+
+            // BVH2 node, child lies between lowClip and highClip on axis
+            uint32 clipNode(uint32 axis, float lowClip, float highClip, uint32 mask)
+            {
+#ifdef BIH_PACKET_SSE
+                __m128 o = _mm_loadu_ps(org[axis]);
+                __m128 inv = _mm_loadu_ps(invDir[axis]);
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(lowClip), o), inv);
+                __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(highClip), o), inv);
+                __m128 neg = _mm_cmplt_ps(inv, _mm_setzero_ps());
+                __m128 tMin = _mm_max_ps(Select(neg, t2, t1), _mm_loadu_ps(tnear));
+                __m128 tMax = _mm_min_ps(Select(neg, t1, t2), _mm_loadu_ps(tfar));
+                _mm_storeu_ps(tnear, tMin);
+                _mm_storeu_ps(tfar, tMax);
+                return mask & _mm_movemask_ps(_mm_cmple_ps(tMin, tMax));
+#else
+                for (uint32 i = 0; i < BIH_PACKET_SIZE; ++i)
+                {
+                    float t1 = (lowClip - org[axis][i]) * invDir[axis][i];
+                    float t2 = (highClip - org[axis][i]) * invDir[axis][i];
+                    bool neg = invDir[axis][i] < 0.f;
+                    tnear[i] = Max(neg ? t2 : t1, tnear[i]);
+                    tfar[i] = Min(neg ? t1 : t2, tfar[i]);
+                    if (tnear[i] > tfar[i])
+                        mask &= ~(1 << i);
+                }
+                return mask;
+#endif
+            }
+
+#ifdef BIH_PACKET_SSE
+            static __m128 Select(__m128 condition, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(condition, a), _mm_andnot_ps(condition, b)); }
+#else
+            // same NaN handling as _mm_max_ps and _mm_min_ps, second argument wins
+            static float Max(float a, float b) { return a > b ? a : b; }
+            static float Min(float a, float b) { return a < b ? a : b; }
+#endif
+        };
+
         class BuildStats
         {
             private:
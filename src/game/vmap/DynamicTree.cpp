@@ -264,6 +264,19 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
     return !callback.did_hit;
 }
 
+// gameobject models are few and spread over grid cells, rays are traced one by one, only rays in checkMask
+uint32 DynamicMapTree::getLineOfSightMask(float x1, float y1, float z1, const float* targets, uint32 count, uint32 checkMask) const
+{
+    if (!impl.size())
+        return checkMask;
+
+    uint32 result = 0;
+    for (uint32 i = 0; i < count; ++i)
+        if ((checkMask & (1u << i)) && isInLineOfSight(x1, y1, z1, targets[3 * i], targets[3 * i + 1], targets[3 * i + 2]))
+            result |= 1u << i;
+    return result;
+}
+
 float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist) const
 {
     Vector3 v(x, y, z);
@@ -60,6 +60,7 @@ class GameObjectModel
         /** Enables\disables collision. */
         void disable() { collision_enabled = false;}
         void enable(bool enabled) { collision_enabled = enabled;}
+        bool isEnabled() const { return collision_enabled; }
 
         bool intersectRay(const G3D::Ray& Ray, float& MaxDist, bool StopAtFirstHit) const;
 
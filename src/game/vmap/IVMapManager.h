@@ -39,6 +39,7 @@ namespace VMAP
 
 #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
 #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
+#define VMAP_MAX_LOS_BATCH        32                    // targets of one line of sight mask query
 
     //===========================================================
     class IVMapManager
@@ -60,6 +61,11 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            line of sight from one point to up to VMAP_MAX_LOS_BATCH targets given as x, y, z triplets
+            bit i of result is set when target i is in line of sight
+            */
+            virtual uint32 getLineOfSightMask(unsigned int pMapId, float x1, float y1, float z1, const float* targets, uint32 count) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
@@ -168,6 +168,49 @@ namespace VMAP
     }
     //=========================================================
     /**
+    Line of sight from pos1 to up to VMAP_MAX_LOS_BATCH targets, bit i of result is set when targets[i] is visible.
+    Rays are traversed in packets of BIH_PACKET_SIZE, nearby targets of one origin share most of visited nodes.
+    */
+
+    uint32 StaticMapTree::getLineOfSightMask(const Vector3& pos1, const Vector3* targets, uint32 count) const
+    {
+        uint32 result = 0;
+        G3D::Ray rays[BIH_PACKET_SIZE];
+        float maxDist[BIH_PACKET_SIZE];
+        uint32 targetIndex[BIH_PACKET_SIZE];
+        uint32 packetSize = 0;
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float dist = (targets[i] - pos1).magnitude();
+            // valid map coords should *never ever* produce float overflow, but this would produce NaNs too:
+            MANGOS_ASSERT(dist < std::numeric_limits<float>::max());
+            // prevent NaN values which can cause BIH intersection to enter infinite loop
+            if (dist < 1e-10f)
+                result |= 1u << i;
+            else
+            {
+                rays[packetSize] = G3D::Ray::fromOriginAndDirection(pos1, (targets[i] - pos1) / dist);
+                maxDist[packetSize] = dist;
+                targetIndex[packetSize] = i;
+                ++packetSize;
+            }
+
+            if (packetSize == BIH_PACKET_SIZE || (packetSize && i + 1 == count))
+            {
+                MapRayCallback intersectionCallBack(iTreeValues);
+                uint32 hitMask = iTree.intersectRayPacket(rays, packetSize, intersectionCallBack, maxDist, true, true);
+                for (uint32 j = 0; j < packetSize; ++j)
+                    if (!(hitMask & (1 << j)))
+                        result |= 1 << targetIndex[j];
+                packetSize = 0;
+            }
+        }
+
+        return result;
+    }
+    //=========================================================
+    /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
     */
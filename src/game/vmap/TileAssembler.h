@@ -23,6 +23,9 @@
 #include <G3D/Matrix3.h>
 #include <map>
 #include <set>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 #include "ModelInstance.h"
 #include "WorldModel.h"
@@ -98,9 +101,15 @@ namespace VMAP
             unsigned int iCurrentUniqueNameId;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            std::mutex iModelFilesLock;
+            uint32 iThreads;
+
+            bool convertMap(uint32 mapID, MapSpawns* spawns);
+            // runs job for indexes [0, count) on iThreads threads, stops at first failed job
+            bool runJobs(uint32 count, std::function<bool(uint32)> const& job);
 
         public:
-            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
+            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 pThreads = 1);
             virtual ~TileAssembler();
 
             bool convertWorld2();
@@ -19,16 +19,47 @@
 #ifndef _VMAPDEFINITIONS_H
 #define _VMAPDEFINITIONS_H
 
+#include <string.h>
+
 #define LIQUID_TILE_SIZE (533.333f / 128.f)
 
 namespace VMAP
 {
     const char VMAP_MAGIC[] = "VMAP_6.0";                   // used in final vmap files
+    const char VMAP_MODEL_MAGIC[] = "VMAP_7.0";             // used in model files with group directory, VMAP_MAGIC ones are still read
     const char RAW_VMAP_MAGIC[] = "VMAPs05";                // used in extracted vmap files with raw data
     const char GAMEOBJECT_MODELS[] = "temp_gameobject_models";
 
     // defined in TileAssembler.cpp currently...
     bool readChunk(FILE* rf, char* dest, const char* compare, uint32 len);
+
+    // sequential reads from memory mapped file, same checks as fread on FILE
+    class MemoryReader
+    {
+        public:
+            MemoryReader(const char* data, size_t size) : iPos(data), iEnd(data + size) {}
+
+            bool read(void* dest, size_t size)
+            {
+                if (size > size_t(iEnd - iPos))
+                    return false;
+                memcpy(dest, iPos, size);
+                iPos += size;
+                return true;
+            }
+
+            bool readChunk(const char* compare, uint32 len)
+            {
+                if (len > size_t(iEnd - iPos) || memcmp(iPos, compare, len) != 0)
+                    return false;
+                iPos += len;
+                return true;
+            }
+
+        private:
+            const char* iPos;
+            const char* iEnd;
+    };
 }
 
 #ifndef NO_CORE_FUNCS
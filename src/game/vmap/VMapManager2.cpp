@@ -157,6 +157,26 @@ namespace VMAP
         return result;
     }
     //=========================================================
+
+    uint32 VMapManager2::getLineOfSightMask(unsigned int pMapId, float x1, float y1, float z1, const float* targets, uint32 count)
+    {
+        MANGOS_ASSERT(count <= VMAP_MAX_LOS_BATCH);
+        uint32 allVisible = count < 32 ? (1 << count) - 1 : 0xFFFFFFFF;
+        if (!isLineOfSightCalcEnabled())
+            return allVisible;
+
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return allVisible;
+
+        Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
+        Vector3 positions[VMAP_MAX_LOS_BATCH];
+        for (uint32 i = 0; i < count; ++i)
+            positions[i] = convertPositionToInternalRep(targets[3 * i], targets[3 * i + 1], targets[3 * i + 2]);
+
+        return instanceTree->second->getLineOfSightMask(pos1, positions, count);
+    }
+    //=========================================================
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
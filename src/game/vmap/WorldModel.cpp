@@ -21,6 +21,11 @@
 #include "MapTree.h"
 #include "ModelInstance.h"
 #include <string.h>
+#include <atomic>
+#include <mutex>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 using G3D::Vector3;
 using G3D::Ray;
@@ -243,6 +248,35 @@ namespace VMAP
         return result;
     }
 
+    bool WmoLiquid::readFromMemory(MemoryReader& reader, WmoLiquid*& out)
+    {
+        bool result = true;
+        WmoLiquid* liquid = new WmoLiquid();
+        if (result && !reader.read(&liquid->iTilesX, sizeof(uint32))) result = false;
+        if (result && !reader.read(&liquid->iTilesY, sizeof(uint32))) result = false;
+        if (result && !reader.read(&liquid->iCorner, sizeof(Vector3))) result = false;
+        if (result && !reader.read(&liquid->iType, sizeof(uint32))) result = false;
+        if (result)
+        {
+            uint32 size = (liquid->iTilesX + 1) * (liquid->iTilesY + 1);
+            liquid->iHeight = new float[size];
+            if (!reader.read(liquid->iHeight, sizeof(float) * size)) result = false;
+        }
+        if (result)
+        {
+            uint32 size = liquid->iTilesX * liquid->iTilesY;
+            liquid->iFlags = new uint8[size];
+            if (!reader.read(liquid->iFlags, sizeof(uint8) * size)) result = false;
+        }
+        if (!result)
+        {
+            delete liquid;
+            liquid = nullptr;
+        }
+        out = liquid;
+        return result;
+    }
+
     // ===================== GroupModel ==================================
 
     GroupModel::GroupModel(const GroupModel& other):
@@ -253,6 +287,19 @@ namespace VMAP
             iLiquid = new WmoLiquid(*other.iLiquid);
     }
 
+    GroupModel& GroupModel::operator=(GroupModel other)
+    {
+        // other is a copy, it takes and deletes old data
+        std::swap(iBound, other.iBound);
+        std::swap(iMogpFlags, other.iMogpFlags);
+        std::swap(iGroupWMOID, other.iGroupWMOID);
+        vertices.swap(other.vertices);
+        triangles.swap(other.triangles);
+        std::swap(meshTree, other.meshTree);
+        std::swap(iLiquid, other.iLiquid);
+        return *this;
+    }
+
     void GroupModel::setMeshData(std::vector<Vector3>& vert, std::vector<MeshTriangle>& tri)
     {
         vertices.swap(vert);
@@ -348,6 +395,50 @@ namespace VMAP
         return result;
     }
 
+    bool GroupModel::readFromMemory(MemoryReader& reader)
+    {
+        bool result = true;
+        uint32 chunkSize, count;
+        triangles.clear();
+        vertices.clear();
+        delete iLiquid;
+        iLiquid = nullptr;
+
+        if (result && !reader.read(&iBound, sizeof(G3D::AABox))) result = false;
+        if (result && !reader.read(&iMogpFlags, sizeof(uint32))) result = false;
+        if (result && !reader.read(&iGroupWMOID, sizeof(uint32))) result = false;
+
+        // read vertices
+        if (result && !reader.readChunk("VERT", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && !reader.read(&count, sizeof(uint32))) result = false;
+        if (!result || !count) // models without (collision) geometry end here, unsure if they are useful
+            return result;
+        vertices.resize(count);
+        if (!reader.read(&vertices[0], sizeof(Vector3) * count)) result = false;
+
+        // read triangle mesh
+        if (result && !reader.readChunk("TRIM", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && !reader.read(&count, sizeof(uint32))) result = false;
+        if (result && count)
+        {
+            triangles.resize(count);
+            if (!reader.read(&triangles[0], sizeof(MeshTriangle) * count)) result = false;
+        }
+
+        // read mesh BIH
+        if (result && !reader.readChunk("MBIH", 4)) result = false;
+        if (result) result = meshTree.readFromMemory(reader);
+
+        // read liquid data
+        if (result && !reader.readChunk("LIQU", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && chunkSize > 0)
+            result = WmoLiquid::readFromMemory(reader, iLiquid);
+        return result;
+    }
+
     struct GModelRayCallback
     {
         GModelRayCallback(const std::vector<MeshTriangle>& tris, const std::vector<Vector3>& vert):
@@ -402,6 +493,65 @@ namespace VMAP
 
     // ===================== WorldModel ==================================
 
+    struct MappedGroups
+    {
+        MappedGroups() : loadedCount(0) {}
+
+        boost::interprocess::mapped_region region;          // released when all groups are loaded
+        std::vector<uint32> offsets;
+        std::vector<uint32> sizes;
+        std::unique_ptr<std::atomic<bool>[]> loaded;
+        uint32 loadedCount;
+        std::mutex lock;
+    };
+
+    WorldModel::WorldModel() : RootWMOID(0), modelFlags(0)
+    {
+    }
+
+    WorldModel::~WorldModel()
+    {
+    }
+
+    const GroupModel& WorldModel::getGroupModel(uint32 index) const
+    {
+        if (iMappedGroups && !iMappedGroups->loaded[index].load(std::memory_order_acquire))
+            loadGroupModel(index);
+        return groupModels[index];
+    }
+
+    void WorldModel::loadGroupModel(uint32 index) const
+    {
+        MappedGroups& mapped = *iMappedGroups;
+        std::lock_guard<std::mutex> guard(mapped.lock);
+        if (mapped.loaded[index].load(std::memory_order_relaxed))
+            return;
+
+        GroupModel& group = groupModels[index];
+        GroupModel directoryEntry(group.GetMogpFlags(), group.GetWmoID(), group.GetBound());
+
+        MemoryReader reader(static_cast<const char*>(mapped.region.get_address()) + mapped.offsets[index], mapped.sizes[index]);
+        if (!group.readFromMemory(reader))
+        {
+            // keep bounds from directory, group just has no geometry
+            ERROR_LOG("WorldModel: could not read group %u of model with root id %u", index, RootWMOID);
+            group = std::move(directoryEntry);
+        }
+
+        mapped.loaded[index].store(true, std::memory_order_release);
+        if (++mapped.loadedCount == groupModels.size())
+            boost::interprocess::mapped_region().swap(mapped.region);
+    }
+
+    uint32 WorldModel::getLoadedGroupCount() const
+    {
+        if (!iMappedGroups)
+            return groupModels.size();
+
+        std::lock_guard<std::mutex> guard(iMappedGroups->lock);
+        return iMappedGroups->loadedCount;
+    }
+
     void WorldModel::setGroupModels(std::vector<GroupModel>& models)
     {
         groupModels.swap(models);
@@ -410,14 +560,14 @@ namespace VMAP
 
     struct WModelRayCallBack
     {
-        WModelRayCallBack(const std::vector<GroupModel>& mod): models(mod.begin()), hit(false) {}
+        WModelRayCallBack(const WorldModel& mod): model(mod), hit(false) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit, bool pCheckLOS)
         {
-            bool result = models[entry].IntersectRay(ray, distance, pStopAtFirstHit, pCheckLOS);
+            bool result = model.getGroupModel(entry).IntersectRay(ray, distance, pStopAtFirstHit, pCheckLOS);
             if (result)  hit = true;
             return hit;
         }
-        std::vector<GroupModel>::const_iterator models;
+        const WorldModel& model;
         bool hit;
     };
 
@@ -429,9 +579,9 @@ namespace VMAP
         // small M2 workaround, maybe better make separate class with virtual intersection funcs
         // in any case, there's no need to use a bound tree if we only have one submodel
         if (groupModels.size() == 1)
-            return groupModels[0].IntersectRay(ray, distance, stopAtFirstHit, checkLOS);
+            return getGroupModel(0).IntersectRay(ray, distance, stopAtFirstHit, checkLOS);
 
-        WModelRayCallBack isc(groupModels);
+        WModelRayCallBack isc(*this);
         groupTree.intersectRay(ray, isc, distance, stopAtFirstHit, checkLOS);
         return isc.hit;
     }
@@ -439,8 +589,9 @@ namespace VMAP
     class WModelAreaCallback
     {
         public:
-            WModelAreaCallback(const std::vector<GroupModel>& vals, const Vector3& down):
-                prims(vals.begin()), hit(vals.end()), minVol(G3D::inf()), zDist(G3D::inf()), zVec(down) {}
+            WModelAreaCallback(const WorldModel& worldModel, const std::vector<GroupModel>& vals, const Vector3& down):
+                model(worldModel), prims(vals.begin()), hit(vals.end()), minVol(G3D::inf()), zDist(G3D::inf()), zVec(down) {}
+            const WorldModel& model;
             std::vector<GroupModel>::const_iterator prims;
             std::vector<GroupModel>::const_iterator hit;
             float minVol;
@@ -453,7 +604,7 @@ namespace VMAP
                 // if(pVol < minVol)
                 //{
                 /* if (prims[entry].iBound.contains(point)) */
-                if (prims[entry].IsInsideObject(point, zVec, group_Z))
+                if (model.getGroupModel(entry).IsInsideObject(point, zVec, group_Z))
                 {
                     // minVol = pVol;
                     // hit = prims + entry;
@@ -478,7 +629,7 @@ namespace VMAP
     {
         if (groupModels.empty())
             return false;
-        WModelAreaCallback callback(groupModels, down);
+        WModelAreaCallback callback(*this, groupModels, down);
         groupTree.intersectPoint(p, callback);
         if (callback.hit != groupModels.end())
         {
@@ -496,7 +647,7 @@ namespace VMAP
     {
         if (groupModels.empty())
             return false;
-        WModelAreaCallback callback(groupModels, down);
+        WModelAreaCallback callback(*this, groupModels, down);
         groupTree.intersectPoint(p, callback);
         if (callback.hit != groupModels.end())
         {
@@ -514,33 +665,129 @@ namespace VMAP
             return false;
 
         uint32 chunkSize, count;
-        bool result = fwrite(VMAP_MAGIC, 1, 8, wf) == 8;
+        bool result = fwrite(VMAP_MODEL_MAGIC, 1, 8, wf) == 8;
         if (result && fwrite("WMOD", 1, 4, wf) != 4) result = false;
         chunkSize = sizeof(uint32) + sizeof(uint32);
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&RootWMOID, sizeof(uint32), 1, wf) != 1) result = false;
 
-        // write group models
+        // write group directory, group data follows group BIH and is read only when needed
         count = groupModels.size();
         if (count)
         {
-            if (result && fwrite("GMOD", 1, 4, wf) != 4) result = false;
-            // chunkSize = sizeof(uint32)+ sizeof(GroupModel)*count;
-            // if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
+            if (result && fwrite("GDIR", 1, 4, wf) != 4) result = false;
             if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
-            for (uint32 i = 0; i < groupModels.size() && result; ++i)
-                result = groupModels[i].writeToFile(wf);
+            long directoryPos = ftell(wf);
+            std::vector<uint32> offsets(count, 0);
+            std::vector<uint32> sizes(count, 0);
+            for (uint32 i = 0; i < count && result; ++i)
+                result = writeGroupEntry(wf, getGroupModel(i), 0, 0);
 
             // write group BIH
             if (result && fwrite("GBIH", 1, 4, wf) != 4) result = false;
             if (result) result = groupTree.writeToFile(wf);
+
+            // write group data, every group starts 4 byte aligned
+            static const char padding[4] = { 0, 0, 0, 0 };
+            for (uint32 i = 0; i < count && result; ++i)
+            {
+                long pos = ftell(wf);
+                uint32 paddingSize = (4 - pos % 4) % 4;
+                if (paddingSize && fwrite(padding, 1, paddingSize, wf) != paddingSize) result = false;
+                offsets[i] = uint32(pos + paddingSize);
+                if (result) result = groupModels[i].writeToFile(wf);
+                sizes[i] = uint32(ftell(wf)) - offsets[i];
+            }
+
+            // fill group directory offsets
+            if (result && fseek(wf, directoryPos, SEEK_SET) != 0) result = false;
+            for (uint32 i = 0; i < count && result; ++i)
+                result = writeGroupEntry(wf, groupModels[i], offsets[i], sizes[i]);
         }
 
         fclose(wf);
         return result;
     }
 
+    bool WorldModel::writeGroupEntry(FILE* wf, const GroupModel& group, uint32 offset, uint32 size)
+    {
+        uint32 mogpFlags = group.GetMogpFlags();
+        uint32 wmoID = group.GetWmoID();
+        bool result = true;
+        if (result && fwrite(&group.GetBound(), sizeof(G3D::AABox), 1, wf) != 1) result = false;
+        if (result && fwrite(&mogpFlags, sizeof(uint32), 1, wf) != 1) result = false;
+        if (result && fwrite(&wmoID, sizeof(uint32), 1, wf) != 1) result = false;
+        if (result && fwrite(&offset, sizeof(uint32), 1, wf) != 1) result = false;
+        if (result && fwrite(&size, sizeof(uint32), 1, wf) != 1) result = false;
+        return result;
+    }
+
     bool WorldModel::readFile(const std::string& filename)
+    {
+        using namespace boost::interprocess;
+
+        std::unique_ptr<MappedGroups> mapped(new MappedGroups());
+        try
+        {
+            file_mapping file(filename.c_str(), read_only);
+            mapped_region(file, read_only).swap(mapped->region);
+        }
+        catch (interprocess_exception const&)
+        {
+            // missing or empty file, legacy reader reports it as failure too
+            return readLegacyFile(filename);
+        }
+
+        MemoryReader reader(static_cast<const char*>(mapped->region.get_address()), mapped->region.get_size());
+        if (!reader.readChunk(VMAP_MODEL_MAGIC, 8))
+            return readLegacyFile(filename);
+
+        bool result = true;
+        uint32 chunkSize = 0;
+        uint32 count = 0;
+        if (result && !reader.readChunk("WMOD", 4)) result = false;
+        if (result && !reader.read(&chunkSize, sizeof(uint32))) result = false;
+        if (result && !reader.read(&RootWMOID, sizeof(uint32))) result = false;
+
+        // read group directory
+        if (result && reader.readChunk("GDIR", 4))
+        {
+            if (result && !reader.read(&count, sizeof(uint32))) result = false;
+            if (result)
+            {
+                groupModels.reserve(count);
+                mapped->offsets.resize(count);
+                mapped->sizes.resize(count);
+            }
+            for (uint32 i = 0; i < count && result; ++i)
+            {
+                G3D::AABox bound;
+                uint32 mogpFlags, wmoID;
+                if (result && !reader.read(&bound, sizeof(G3D::AABox))) result = false;
+                if (result && !reader.read(&mogpFlags, sizeof(uint32))) result = false;
+                if (result && !reader.read(&wmoID, sizeof(uint32))) result = false;
+                if (result && !reader.read(&mapped->offsets[i], sizeof(uint32))) result = false;
+                if (result && !reader.read(&mapped->sizes[i], sizeof(uint32))) result = false;
+                if (result && uint64(mapped->offsets[i]) + mapped->sizes[i] > mapped->region.get_size()) result = false;
+                groupModels.push_back(GroupModel(mogpFlags, wmoID, bound));
+            }
+
+            // read group BIH
+            if (result && !reader.readChunk("GBIH", 4)) result = false;
+            if (result) result = groupTree.readFromMemory(reader);
+        }
+
+        if (!result || !count)
+            return result;
+
+        mapped->loaded.reset(new std::atomic<bool>[count]);
+        for (uint32 i = 0; i < count; ++i)
+            mapped->loaded[i] = false;
+        iMappedGroups = std::move(mapped);
+        return true;
+    }
+
+    bool WorldModel::readLegacyFile(const std::string& filename)
     {
         FILE* rf = fopen(filename.c_str(), "rb");
         if (!rf)
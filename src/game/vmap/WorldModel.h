@@ -26,11 +26,14 @@
 
 #include "Platform/Define.h"
 
+#include <memory>
+
 namespace VMAP
 {
     class TreeNode;
     struct AreaInfo;
     struct LocationInfo;
+    class MemoryReader;
 
     class MeshTriangle
     {
@@ -58,6 +61,7 @@ namespace VMAP
             uint32 GetFileSize();
             bool writeToFile(FILE* wf);
             static bool readFromFile(FILE* rf, WmoLiquid*& liquid);
+            static bool readFromMemory(MemoryReader& reader, WmoLiquid*& liquid);
         private:
             WmoLiquid() : iTilesX(0), iTilesY(0), iType(0), iHeight(nullptr), iFlags(nullptr) {};
             uint32 iTilesX;  //!< number of tiles in x direction, each
@@ -81,6 +85,7 @@ namespace VMAP
             GroupModel(uint32 mogpFlags, uint32 groupWMOID, const AABox& bound):
                 iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iLiquid(nullptr) {}
             ~GroupModel() { delete iLiquid; }
+            GroupModel& operator=(GroupModel other);
 
             //! pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry!
             void setMeshData(std::vector<Vector3>& vert, std::vector<MeshTriangle>& tri);
@@ -91,6 +96,7 @@ namespace VMAP
             uint32 GetLiquidType() const;
             bool writeToFile(FILE* wf);
             bool readFromFile(FILE* rf);
+            bool readFromMemory(MemoryReader& reader);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
@@ -108,11 +114,16 @@ namespace VMAP
             void getMeshData(std::vector<Vector3>& vertices, std::vector<MeshTriangle>& triangles, WmoLiquid*& liquid);
 #endif
     };
-    /*! Holds a model (converted M2 or WMO) in its original coordinate space */
+    struct MappedGroups;
+
+    /*! Holds a model (converted M2 or WMO) in its original coordinate space.
+        Group geometry of VMAP_MODEL_MAGIC files stays in mapped file until a ray or point query
+        reaches bounds of the group, only group directory and group tree are read at load. */
     class WorldModel
     {
         public:
-            WorldModel(): RootWMOID(0) {}
+            WorldModel();
+            ~WorldModel();
 
             //! pass group models to WorldModel and create BIH. Passed vector is swapped with old geometry!
             void setGroupModels(std::vector<GroupModel>& models);
@@ -122,13 +133,21 @@ namespace VMAP
             bool GetLocationInfo(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, LocationInfo& info) const;
             bool writeFile(const std::string& filename);
             bool readFile(const std::string& filename);
+            uint32 getLoadedGroupCount() const;
             void setModelFlags(uint32 newFlags) { modelFlags = newFlags; }
             uint32 getModelFlags() const { return modelFlags; }
+            //! returns group, reading its geometry from mapped file at first use
+            const GroupModel& getGroupModel(uint32 index) const;
         protected:
+            bool readLegacyFile(const std::string& filename);
+            static bool writeGroupEntry(FILE* wf, const GroupModel& group, uint32 offset, uint32 size);
+            void loadGroupModel(uint32 index) const;
+
             uint32 RootWMOID;
-            std::vector<GroupModel> groupModels;
+            mutable std::vector<GroupModel> groupModels;
             BIH groupTree;
             uint32 modelFlags;
+            std::unique_ptr<MappedGroups> iMappedGroups;    //!< null for built models and legacy files
 
 #ifdef MMAP_GENERATOR
         public:
@@ -346,6 +346,7 @@ bool Master::_StartDB()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    int nHelperConnections = sConfig.GetIntDefault("CharacterDatabaseLoginConnections", 2);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -354,10 +355,10 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i", nConnections + 1 + std::max(nHelperConnections, 0));
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nHelperConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
 
@@ -97,7 +97,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nHelperConns /*= 0*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -139,6 +139,19 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     if (!m_pAsyncConn->Initialize(infoString))
         return false;
 
+    // create connections for helpers of async requests
+    for (int i = 0; i < std::min(nHelperConns, MAX_CONNECTION_POOL_SIZE); ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pHelperConnections.push_back(pConn);
+    }
+
     m_pResultQueue = new SqlResultQueue;
 
     InitDelayThread();
@@ -159,6 +172,11 @@ void Database::StopServer()
         delete m_pQueryConnections[i];
 
     m_pQueryConnections.clear();
+
+    for (size_t i = 0; i < m_pHelperConnections.size(); ++i)
+        delete m_pHelperConnections[i];
+
+    m_pHelperConnections.clear();
 }
 
 SqlDelayThread* Database::CreateDelayThread()
@@ -174,6 +192,9 @@ void Database::InitDelayThread()
     // New delay thread for delay execute
     m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
     m_delayThread = new MaNGOS::Thread(m_threadBody);
+
+    if (!m_pHelperConnections.empty())
+        m_helperPool = new SqlHelperPool(this, m_pHelperConnections);
 }
 
 void Database::HaltDelayThread()
@@ -185,6 +206,10 @@ void Database::HaltDelayThread()
     delete m_delayThread;                                   // This also deletes m_threadBody
     m_delayThread = nullptr;
     m_threadBody = nullptr;
+
+    // after delay thread, it can use helpers for requests queued while stopping
+    delete m_helperPool;
+    m_helperPool = nullptr;
 }
 
 void Database::ThreadStart()
@@ -239,6 +264,12 @@ void Database::Ping()
         SqlConnection::Lock guard(m_pQueryConnections[i]);
         delete guard->Query(sql);
     }
+
+    for (size_t i = 0; i < m_pHelperConnections.size(); ++i)
+    {
+        SqlConnection::Lock guard(m_pHelperConnections[i]);
+        delete guard->Query(sql);
+    }
 }
 
 bool Database::PExecuteLog(const char* format, ...)
@@ -104,10 +104,11 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        // nHelperConns are own connections of delay thread helpers, which run query holders with it
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nHelperConns = 0);
+        // start worker thread (and its helpers) for async DB request execution
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker thread (and its helpers)
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
@@ -223,7 +224,7 @@ class Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_bAllowAsyncTransactions(false),
+            m_threadBody(nullptr), m_delayThread(nullptr), m_helperPool(nullptr), m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -247,6 +248,7 @@ class Database
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
 
         friend class SqlStatement;
+        friend class SqlQueryHolderEx;                      // spreads holder queries over helper connections
         // PREPARED STATEMENT API
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
@@ -267,6 +269,10 @@ class Database
         SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
         MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
 
+        // helpers of delay thread for query holders, never used by sync queries
+        SqlConnectionContainer m_pHelperConnections;
+        SqlHelperPool*      m_helperPool;                   ///< Pointer to helper threads, nullptr without helper connections
+
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
         // PREPARED STATEMENT REGISTRY
@@ -84,3 +84,70 @@ void SqlDelayThread::ProcessRequests()
         s->Execute(m_dbConnection);
     }
 }
+
+SqlHelperPool::SqlHelperPool(Database* db, std::vector<SqlConnection*> const& connections) : m_dbEngine(db),
+    m_task(nullptr), m_taskId(0), m_busyHelpers(0), m_running(true)
+{
+    for (SqlConnection* conn : connections)
+        m_threads.push_back(new MaNGOS::Thread(new Helper(*this, conn)));
+}
+
+SqlHelperPool::~SqlHelperPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_running = false;
+    }
+    m_taskCondition.notify_all();
+
+    for (MaNGOS::Thread* thread : m_threads)
+    {
+        thread->wait();
+        delete thread;                                      // This also deletes helper
+    }
+}
+
+void SqlHelperPool::Execute(Task const& task, SqlConnection* conn)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_task = &task;
+        m_busyHelpers = m_threads.size();
+        ++m_taskId;
+    }
+    m_taskCondition.notify_all();
+
+    task(conn);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_busyHelpers == 0; });
+    m_task = nullptr;
+}
+
+void SqlHelperPool::Helper::run()
+{
+    m_pool.m_dbEngine->ThreadStart();
+
+    uint32 lastTaskId = 0;
+    while (true)
+    {
+        Task const* task;
+        {
+            std::unique_lock<std::mutex> lock(m_pool.m_mutex);
+            m_pool.m_taskCondition.wait(lock, [this, lastTaskId] { return !m_pool.m_running || m_pool.m_taskId != lastTaskId; });
+            if (!m_pool.m_running)
+                break;
+
+            lastTaskId = m_pool.m_taskId;
+            task = m_pool.m_task;
+        }
+
+        (*task)(m_dbConnection);
+
+        std::lock_guard<std::mutex> guard(m_pool.m_mutex);
+        if (--m_pool.m_busyHelpers == 0)
+            m_pool.m_doneCondition.notify_one();
+    }
+
+    m_pool.m_dbEngine->ThreadEnd();
+}
@@ -22,9 +22,12 @@
 #include "Threading.h"
 #include "SqlOperations.h"
 
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <queue>
 #include <memory>
+#include <vector>
 
 class Database;
 class SqlOperation;
@@ -57,4 +60,41 @@ class SqlDelayThread : public MaNGOS::Runnable
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
+
+/// Helper threads of delay thread, each one with own connection. Delay thread runs a task on its
+/// connection and on all helper ones and waits for them, so requests after it keep their order
+class SqlHelperPool
+{
+    public:
+        typedef std::function<void(SqlConnection*)> Task;
+
+        SqlHelperPool(Database* db, std::vector<SqlConnection*> const& connections);
+        ~SqlHelperPool();
+
+        ///< Run task on conn and on all helper connections, returns after all of them are done
+        void Execute(Task const& task, SqlConnection* conn);
+
+    private:
+        class Helper : public MaNGOS::Runnable
+        {
+            public:
+                Helper(SqlHelperPool& pool, SqlConnection* conn) : m_pool(pool), m_dbConnection(conn) {}
+                void run() override;
+
+            private:
+                SqlHelperPool& m_pool;
+                SqlConnection* m_dbConnection;
+        };
+
+        Database* m_dbEngine;
+        std::vector<MaNGOS::Thread*> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_taskCondition;                ///< Helpers wait for next task
+        std::condition_variable m_doneCondition;                ///< Delay thread waits for helpers
+        Task const* m_task;
+        uint32 m_taskId;
+        uint32 m_busyHelpers;
+        bool m_running;
+};
 #endif                                                      //__SQLDELAYTHREAD_H
@@ -21,6 +21,7 @@
 #include "DatabaseEnv.h"
 #include "DatabaseImpl.h"
 
+#include <atomic>
 #include <cstdarg>
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
@@ -221,15 +222,31 @@ bool SqlQueryHolderEx::Execute(SqlConnection* conn)
     if (!m_holder || !m_callback || !m_queue)
         return false;
 
-    LOCK_DB_CONN(conn);
     /// we can do this, we are friends
     std::vector<SqlQueryHolder::SqlResultPair>& queries = m_holder->m_queries;
-    for (size_t i = 0; i < queries.size(); ++i)
+    SqlHelperPool* helperPool = conn->DB().m_helperPool;
+
+    /// execute all queries in the holder and pass the results, every connection takes next not executed query
+    std::atomic<size_t> nextQuery(0);
+    auto executeQueries = [&queries, &nextQuery, this](SqlConnection* queryConn)
     {
-        /// execute all queries in the holder and pass the results
-        char const* sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, conn->Query(sql));
-    }
+        for (size_t i = nextQuery++; i < queries.size(); i = nextQuery++)
+        {
+            char const* sql = queries[i].first;
+            if (!sql)
+                continue;
+
+            LOCK_DB_CONN(queryConn);
+            m_holder->SetResult(i, queryConn->Query(sql));
+        }
+    };
+
+    /// helper connections of delay thread share the queries with it, so holder costs about one round trip per
+    /// connection instead of one per query. All of them are done before next async request, order with transactions is kept
+    if (helperPool && queries.size() > 1)
+        helperPool->Execute(executeQueries, conn);
+    else
+        executeQueries(conn);
 
     /// sync with the caller thread
     m_queue->Add(m_callback);
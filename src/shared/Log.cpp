@@ -36,7 +36,7 @@ LogFilterData logFilterData[LOG_FILTER_COUNT] =
     { "transport_moves",     "LogFilter_TransportMoves",     true  },
     { "creature_moves",      "LogFilter_CreatureMoves",      true  },
     { "visibility_changes",  "LogFilter_VisibilityChanges",  true  },
-    { "",                    "",                             true  },
+    { "line_of_sight",       "LogFilter_LineOfSight",        true  },
     { "weather",             "LogFilter_Weather",            true  },
     { "player_stats",        "LogFilter_PlayerStats",        false },
     { "sql_text",            "LogFilter_SQLText",            true  },
@@ -41,7 +41,7 @@ enum LogFilters
     LOG_FILTER_TRANSPORT_MOVES    = 0x000001,               //  0 any related to transport moves
     LOG_FILTER_CREATURE_MOVES     = 0x000002,               //  1 creature move by cells
     LOG_FILTER_VISIBILITY_CHANGES = 0x000004,               //  2 update visibility for diff objects and players
-    // reserved for future version
+    LOG_FILTER_LINE_OF_SIGHT      = 0x000008,               //  3 line of sight queries not found in collision cache
     LOG_FILTER_WEATHER            = 0x000010,               //  4 weather changes
     LOG_FILTER_PLAYER_STATS       = 0x000020,               //  5 player save data
     LOG_FILTER_SQL_TEXT           = 0x000040,               //  6 raw SQL text send to DB engine